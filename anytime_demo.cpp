@@ -0,0 +1,71 @@
+// Ví dụ dùng libcvrp.a qua cvrp_solver.h: trả lời sau --deadline-ms với best feasible hiện có,
+// sau đó tiếp tục polling các bản cải thiện tới khi hết --budget-ms rồi cancel.
+//
+// Build & run:  make anytime-demo
+//               ./anytime_demo [file.vrp] [--deadline-ms D] [--budget-ms B] [--threads N]
+
+#include "cvrp_solver.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string filename = "CMT5.vrp";
+    double deadlineMs = 200;
+    double budgetMs = 2000;
+    SolverParams params;
+    params.maxGenerations = 1000000; // dừng nhờ cancel, không phải số generation
+    params.populationSize = 200;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--deadline-ms" && i + 1 < argc) {
+            deadlineMs = atof(argv[++i]);
+        } else if (arg == "--budget-ms" && i + 1 < argc) {
+            budgetMs = atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            params.numThreads = atoi(argv[++i]);
+        } else {
+            filename = arg;
+        }
+    }
+
+    setLogLevel(LOG_WARN);
+    CVRPInstance instance;
+    if (!loadCVRPInstance(filename, instance)) return 1;
+    auto start = chrono::steady_clock::now();
+    auto elapsedMs = [&] { return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); };
+
+    AnytimeSolver solver(instance, params);
+    solver.start();
+
+    solver.waitFor(deadlineMs / 1000.0);
+    FeasibleSolution plan = solver.best();
+    cout << fixed << setprecision(2);
+    if (plan.isFeasible) {
+        cout << "[" << elapsedMs() << " ms] first answer: cost " << plan.cost
+             << " (generation " << plan.generation << ")" << endl;
+    } else {
+        cout << "[" << elapsedMs() << " ms] no feasible solution yet" << endl;
+    }
+
+    long long seen = solver.improvements();
+    while (elapsedMs() < budgetMs && !solver.waitFor(0.05)) {
+        if (solver.poll(plan, seen)) {
+            cout << "[" << elapsedMs() << " ms] improved: cost " << plan.cost
+                 << " (generation " << plan.generation << ")" << endl;
+        }
+    }
+    solver.cancel();
+    solver.wait();
+
+    const GAResult& result = solver.result();
+    cout << "[" << elapsedMs() << " ms] stopped by " << stopReasonName(result.stopReason) << ": cost "
+         << result.bestCost << (result.isFeasible ? " FEASIBLE" : " INFEASIBLE") << ", "
+         << result.generations << " generations, " << result.evaluations << " evaluations" << endl;
+    return 0;
+}
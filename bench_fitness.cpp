@@ -0,0 +1,434 @@
+// Micro-benchmark: so sánh calculateFitness (streaming trên ma trận dist)
+// với calculateFitnessReference (decodeSeq + euclidDist) trên các file CMT.
+// Chương trình trả về mã lỗi 1 nếu có bất kỳ điểm fitness nào không khớp từng bit
+// (với build CVRP_DIST_FLOAT: sai lệch tương đối lớn hơn 1e-5).
+// Đồng thời kiểm tra delta evaluation của các mutation operator so với việc
+// tính lại RouteCache từ đầu, kiểm tra splitTour, kiểm tra evaluateBatch ở mọi mức SIMD
+// CPU hỗ trợ (fitness trùng từng bit với calculateFitness, feasible trùng validateCapacity)
+// và đo repair pipeline (ns + số lần cấp phát heap mỗi lần gọi). Khoảng cách on-demand
+// (--dense-limit) phải trùng từng bit với ma trận dense, cùng danh sách láng giềng, và
+// SpatialGrid::nearest trùng với quét tuyến tính.
+//
+// Build & run:  make bench-fitness
+//               ./bench_fitness [file1.vrp file2.vrp ...]
+
+#define CVRP_NO_MAIN
+#include "ga8.cpp"
+
+#include <cstring>
+#include <new>
+
+// Đếm mọi lần cấp phát heap của chương trình (thay thế operator new toàn cục). Mọi dạng
+// new / new[] / align_val_t đều qua cùng một cặp countedAlloc / countedFree nên cặp
+// new-delete nào cũng khớp (kể cả với -Wmismatched-new-delete) và bộ đếm vẫn chính xác.
+static atomic<long long> heapAllocations(0);
+
+__attribute__((noinline)) static void* countedAlloc(size_t size, size_t alignment) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (size == 0) size = 1;
+    void* p = alignment <= alignof(max_align_t)
+                  ? malloc(size)
+                  : aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!p) throw bad_alloc();
+    return p;
+}
+__attribute__((noinline)) static void countedFree(void* p) noexcept { free(p); }
+
+void* operator new(size_t size) { return countedAlloc(size, 0); }
+void* operator new[](size_t size) { return countedAlloc(size, 0); }
+void* operator new(size_t size, align_val_t align) { return countedAlloc(size, static_cast<size_t>(align)); }
+void* operator new[](size_t size, align_val_t align) { return countedAlloc(size, static_cast<size_t>(align)); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { countedFree(p); }
+
+// Sinh tập cá thể kiểm tra: population khởi tạo chuẩn + bản đột biến chưa repair
+// (để kích hoạt cả capacity penalty và time penalty).
+vector<vector<int>> buildSamples(int vehicle, int n, int capacity, const vector<int>& demand,
+                                 const vector<pair<double,double>>& coords,
+                                 const DistMatrix& dist, int depot, mt19937& gen) {
+    vector<vector<int>> samples = initStructuredPopulation(200, vehicle, n, capacity, demand, coords, dist, depot);
+    size_t base = samples.size();
+    for (size_t i = 0; i < base; ++i) {
+        vector<int> seq = samples[i];
+        mutateScramble(seq, gen);
+        mutateInsertion(seq, gen);
+        mutateRouteExchange(seq, gen);
+        samples.push_back(seq);
+    }
+    // Giant tour ngẫu nhiên hoàn toàn, ít separator hơn số xe
+    for (int i = 0; i < 50; ++i) {
+        vector<int> seq;
+        for (int c = 2; c <= n; ++c) seq.push_back(c);
+        shuffle(seq.begin(), seq.end(), gen);
+        for (int z = 0; z < max(0, vehicle - 2); ++z) {
+            seq.insert(seq.begin() + uniform_int_distribution<>(0, seq.size())(gen), 0);
+        }
+        samples.push_back(seq);
+    }
+    return samples;
+}
+
+// Áp dụng từng operator ở chế độ delta và so sánh với cache tính lại sau move.
+// Trả về số move có delta sai (cost tổng hoặc từng tuyến local).
+int checkMoveDeltas(const vector<vector<int>>& samples, const vector<int>& demand,
+                    const DistMatrix& dist, int depot, mt19937& gen, int& localMoves) {
+    typedef MoveDelta (*Operator)(vector<int>&, mt19937&, const DeltaContext*);
+    const Operator ops[] = {mutateSwap, mutateInversion, mutateInsertion,
+                            mutateOrOpt, mutateScramble, mutateRouteExchange};
+    auto close = [](double a, double b) { return fabs(a - b) <= 1e-6 * max(1.0, fabs(a)); };
+    
+    RouteCache before, after;
+    int errors = 0;
+    for (const auto& sample : samples) {
+        for (Operator op : ops) {
+            vector<int> seq = sample;
+            buildRouteCache(seq, demand, dist, depot, before);
+            DeltaContext ctx{before, dist, demand, depot};
+            MoveDelta delta = op(seq, gen, &ctx);
+            if (!delta.applied) continue;
+            buildRouteCache(seq, demand, dist, depot, after);
+            
+            double oldTotal = accumulate(before.cost.begin(), before.cost.end(), 0.0);
+            double newTotal = accumulate(after.cost.begin(), after.cost.end(), 0.0);
+            bool ok = close(newTotal - oldTotal, delta.cost);
+            if (ok && delta.local) {
+                localMoves++;
+                ok = after.cost.size() == before.cost.size();
+                for (const auto& change : delta.routes) {
+                    if (!ok) break;
+                    int r = change.route;
+                    ok = close(after.cost[r] - before.cost[r], change.cost)
+                      && after.load[r] - before.load[r] == change.load
+                      && after.customers[r] - before.customers[r] == change.customers;
+                }
+            }
+            if (!ok) errors++;
+        }
+    }
+    return errors;
+}
+
+// Split decoder: kết quả phải khả thi, giữ nguyên thứ tự customers và không tệ hơn cách
+// cắt sẵn có của một sample khả thi dùng không quá vehicle tuyến. Trả về số lần vi phạm.
+int checkSplit(const vector<vector<int>>& samples, int vehicle, const vector<pair<double,double>>& coords,
+               const vector<int>& demand, int capacity, int depot, const DistMatrix& dist,
+               double maxDistance, double serviceTime, int& splitCount) {
+    int errors = 0;
+    vector<int> before, after;
+    for (const auto& sample : samples) {
+        vector<int> seq = sample;
+        if (!splitTour(seq, vehicle, demand, capacity, depot, dist, maxDistance, serviceTime)) continue;
+        splitCount++;
+        before.clear();
+        after.clear();
+        for (int v : sample) if (v != 0) before.push_back(v);
+        for (int v : seq) if (v != 0) after.push_back(v);
+        int routes = count(seq.begin(), seq.end(), 0) + 1;
+        double cost = calculateFitness(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+        bool ok = after == before && routes <= vehicle
+               && validateCapacity(seq, demand, capacity, depot, dist, maxDistance, serviceTime);
+        int sampleRoutes = decodeSeq(sample, depot).size();
+        if (ok && sampleRoutes <= vehicle
+            && validateCapacity(sample, demand, capacity, depot, dist, maxDistance, serviceTime)) {
+            double original = calculateFitness(sample, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+            ok = cost <= original + 1e-6 * max(1.0, original);
+        }
+        if (!ok) errors++;
+    }
+    return errors;
+}
+
+// evaluateBatch trên arena chứa toàn bộ samples, so với calculateFitness + validateCapacity
+// từng cá thể. Trả về số kết quả sai ở mọi mức SIMD <= detectSimdLevel().
+int checkBatch(const ChromosomeArena& arena, const vector<vector<int>>& samples, const FitnessParams& params,
+               const vector<pair<double,double>>& coords, const vector<int>& demand) {
+    vector<int> indices(arena.size());
+    iota(indices.begin(), indices.end(), 0);
+    vector<double> fitness(arena.size());
+    vector<char> feasible(arena.size());
+    int errors = 0;
+    for (int level = 0; level <= (int)detectSimdLevel(); ++level) {
+        evaluateBatch(arena, indices.data(), indices.size(), params, fitness.data(), feasible.data(), (SimdLevel)level);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            double expected = calculateFitness(samples[i], coords, demand, params.capacity, params.depot, *params.dist,
+                                               params.maxDistance, params.serviceTime);
+            bool expectedFeasible = validateCapacity(samples[i], demand, params.capacity, params.depot, *params.dist,
+                                                     params.maxDistance, params.serviceTime);
+            if (memcmp(&expected, &fitness[i], sizeof(double)) != 0 || expectedFeasible != (bool)feasible[i]) {
+                if (errors < 5) {
+                    cerr << "evaluateBatch (" << simdLevelName((SimdLevel)level) << "): " << setprecision(17)
+                         << expected << "/" << expectedFeasible << " vs " << fitness[i] << "/" << (int)feasible[i] << endl;
+                }
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+// Ma trận on-demand so với dense: mọi phần tử, danh sách láng giềng và khoảng cách tới
+// láng giềng; SpatialGrid::nearest so với quét toàn bộ. Trả về số chỗ khác nhau.
+int checkDistanceModes(const vector<pair<double,double>>& coords, mt19937& gen) {
+    DistMatrix dense = buildDist(coords, DEFAULT_NEIGHBOR_K, 0);
+    DistMatrix onDemand = buildDist(coords, DEFAULT_NEIGHBOR_K, 1);
+    int errors = !onDemand.onDemand() || dense.neighborCount() != onDemand.neighborCount();
+    size_t rows = dense.size();
+    for (size_t i = 0; i < rows && !errors; ++i) {
+        for (size_t j = 0; j < rows; ++j) {
+            dist_t a = dense[i][j], b = onDemand[i][j];
+            if (memcmp(&a, &b, sizeof(dist_t)) != 0) errors++;
+        }
+        for (int k = 0; k < dense.neighborCount(); ++k) {
+            if (dense.neighbors(i)[k] != onDemand.neighbors(i)[k]
+                || dense.neighborDistances(i)[k] != onDemand.neighborDistances(i)[k]) errors++;
+        }
+    }
+    
+    vector<double> xs, ys;
+    vector<int> ids;
+    for (size_t i = 1; i < coords.size(); i += 3) {
+        xs.push_back(coords[i].first);
+        ys.push_back(coords[i].second);
+        ids.push_back(ids.size());
+    }
+    SpatialGrid grid;
+    grid.build(xs.data(), ys.data(), ids.data(), ids.size());
+    uniform_real_distribution<> pos(-20.0, 120.0);
+    for (int q = 0; q < 1000; ++q) {
+        double x = pos(gen), y = pos(gen);
+        int expected = 0;
+        double best = numeric_limits<double>::max();
+        for (size_t k = 0; k < xs.size(); ++k) {
+            double d = (x - xs[k]) * (x - xs[k]) + (y - ys[k]) * (y - ys[k]);
+            if (d < best) { best = d; expected = k; }
+        }
+        if (grid.nearest(x, y) != expected) errors++;
+    }
+    return errors;
+}
+
+// ns mỗi cá thể của evaluateBatch trên toàn arena
+double timeBatch(const ChromosomeArena& arena, const FitnessParams& params, SimdLevel level, int reps, double& checksum) {
+    vector<int> indices(arena.size());
+    iota(indices.begin(), indices.end(), 0);
+    vector<double> fitness(arena.size());
+    vector<char> feasible(arena.size());
+    auto start = chrono::high_resolution_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        evaluateBatch(arena, indices.data(), indices.size(), params, fitness.data(), feasible.data(), level);
+        checksum += fitness[r % fitness.size()];
+    }
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / ((double)reps * arena.size());
+}
+
+// Đo repair pipeline như trong reproducePair (repairCustomerWithLocalSearch + repairZero)
+// trên con one-point chưa repair (có duplicate / missing). Sau một lượt warm-up để
+// bộ đệm đạt kích thước ổn định, đếm số lần cấp phát heap trong lượt đo.
+struct RepairStats { double ns; double allocsPerCall; };
+
+RepairStats benchRepair(const vector<vector<int>>& samples, int n, int vehicle, const vector<int>& demand,
+                        int capacity, int depot, const DistMatrix& dist,
+                        double maxDistance, double serviceTime, mt19937& gen) {
+    // Con one-point chưa repair: đầu của cha này + đuôi của cha kia
+    vector<vector<int>> children;
+    for (size_t i = 0; i + 1 < samples.size(); i += 2) {
+        const vector<int>& a = samples[i];
+        const vector<int>& b = samples[i + 1];
+        size_t cut = uniform_int_distribution<size_t>(0, min(a.size(), b.size()))(gen);
+        vector<int> child(a.begin(), a.begin() + cut);
+        child.insert(child.end(), b.begin() + cut, b.end());
+        children.push_back(child);
+    }
+    
+    // Bản sao có capacity đủ lớn để phép gán không cấp phát
+    vector<vector<int>> work(children.size());
+    for (auto& seq : work) seq.reserve(n + 2 * vehicle + 16);
+    repairScratch().prepare(n, vehicle);
+    
+    auto pass = [&]() {
+        for (size_t i = 0; i < children.size(); ++i) {
+            work[i] = children[i];
+            repairCustomerWithLocalSearch(work[i], n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+            repairZero(work[i], vehicle, gen);
+        }
+    };
+    pass(); // warm-up
+    
+    const int reps = 5;
+    long long before = heapAllocations.load();
+    auto start = chrono::high_resolution_clock::now();
+    for (int r = 0; r < reps; ++r) pass();
+    auto end = chrono::high_resolution_clock::now();
+    long long allocations = heapAllocations.load() - before;
+    
+    double calls = (double)reps * children.size();
+    return {chrono::duration<double, nano>(end - start).count() / calls, allocations / calls};
+}
+
+template <typename F>
+double timePerEval(const vector<vector<int>>& samples, int reps, F&& fitness, double& checksum) {
+    auto start = chrono::high_resolution_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (const auto& seq : samples) checksum += fitness(seq);
+    }
+    auto end = chrono::high_resolution_clock::now();
+    double ns = chrono::duration<double, nano>(end - start).count();
+    return ns / ((double)reps * samples.size());
+}
+
+int main(int argc, char* argv[]) {
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) files.push_back(argv[i]);
+    if (files.empty()) {
+        for (int i = 1; i <= 14; ++i) files.push_back("CMT" + to_string(i) + ".vrp");
+    }
+
+    mt19937 gen(12345);
+    int totalMismatches = 0;
+    vector<string> report;
+    vector<string> repairReport;
+    vector<string> batchReport;
+
+    for (const string& filename : files) {
+        int n, capacity, depot, vehicles;
+        double maxDistance, serviceTime;
+        vector<pair<double,double>> coords;
+        vector<int> demand;
+        if (!readCVRP(filename, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime)) return 1;
+        DistMatrix dist = buildDist(coords);
+
+        vector<vector<int>> samples = buildSamples(vehicles, n, capacity, demand, coords, dist, depot, gen);
+
+        int mismatches = 0;
+        for (const auto& seq : samples) {
+            double expected = calculateFitnessReference(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+            double actual = calculateFitness(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+            bool match = (sizeof(dist_t) == sizeof(double))
+                ? memcmp(&expected, &actual, sizeof(double)) == 0
+                : fabs(expected - actual) <= 1e-5 * max(1.0, fabs(expected));
+            if (!match) {
+                if (mismatches < 5) {
+                    cerr << filename << ": mismatch " << setprecision(17) << expected << " vs " << actual << endl;
+                }
+                mismatches++;
+            }
+        }
+        totalMismatches += mismatches;
+
+        int localMoves = 0;
+        int deltaErrors = checkMoveDeltas(samples, demand, dist, depot, gen, localMoves);
+        if (deltaErrors > 0) {
+            cerr << filename << ": " << deltaErrors << " mutation deltas disagree with recomputation" << endl;
+        }
+        totalMismatches += deltaErrors;
+        
+        int splitCount = 0;
+        int splitErrors = checkSplit(samples, vehicles, coords, demand, capacity, depot, dist, maxDistance,
+                                     serviceTime, splitCount);
+        if (splitErrors > 0) {
+            cerr << filename << ": " << splitErrors << " split decodings infeasible or worse than the input" << endl;
+        }
+        totalMismatches += splitErrors;
+        
+        int distanceErrors = checkDistanceModes(coords, gen);
+        if (distanceErrors > 0) {
+            cerr << filename << ": " << distanceErrors << " on-demand distances or grid queries disagree with dense" << endl;
+        }
+        totalMismatches += distanceErrors;
+
+        const int reps = 50;
+        double checksum = 0.0;
+        double refNs = timePerEval(samples, reps, [&](const vector<int>& seq) {
+            return calculateFitnessReference(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+        }, checksum);
+        double newNs = timePerEval(samples, reps, [&](const vector<int>& seq) {
+            return calculateFitness(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+        }, checksum);
+
+        ChromosomeArena arena(n);
+        for (const auto& seq : samples) arena.push(seq);
+        FitnessParams params(dist, demand, capacity, depot, maxDistance, serviceTime);
+        int batchErrors = checkBatch(arena, samples, params, coords, demand);
+        if (batchErrors > 0) {
+            cerr << filename << ": " << batchErrors << " batch evaluations disagree with calculateFitness" << endl;
+        }
+        totalMismatches += batchErrors;
+        // Streaming fitness + feasible trong cùng một lượt (fitnessOfGenes, như đường scalar
+        // của evaluatePopulation): so sánh ngang hàng với các mức batch, vốn cũng trả về cả hai
+        double fusedNs = timePerEval(samples, reps, [&](const vector<int>& seq) {
+            bool ok;
+            double fitness = fitnessOfGenes(seq.data(), seq.size(), params, ok);
+            return fitness + ok;
+        }, checksum);
+        ostringstream batchLine;
+        batchLine << left << setw(12) << filename << right << setw(14) << fixed << setprecision(1) << newNs
+                  << setw(14) << fusedNs;
+        for (int level = 0; level <= (int)SimdLevel::AVX512; ++level) {
+            if (level > (int)detectSimdLevel()) {
+                batchLine << setw(12) << "-";
+                continue;
+            }
+            batchLine << setw(12) << timeBatch(arena, params, (SimdLevel)level, reps, checksum);
+        }
+        batchLine << setw(10) << batchErrors;
+        batchReport.push_back(batchLine.str());
+
+        ostringstream line;
+        line << left << setw(12) << filename
+             << right << setw(8) << samples.size()
+             << setw(12) << mismatches
+             << setw(14) << fixed << setprecision(1) << refNs
+             << setw(14) << newNs
+             << setw(10) << setprecision(2) << refNs / newNs << "x"
+             << setw(10) << localMoves << "/" << deltaErrors
+             << setw(10) << splitCount << "/" << splitErrors
+             << "   (checksum " << setprecision(0) << checksum << ")";
+        report.push_back(line.str());
+        
+        RepairStats repair = benchRepair(samples, n, vehicles, demand, capacity, depot, dist, maxDistance, serviceTime, gen);
+        ostringstream repairLine;
+        repairLine << left << setw(12) << filename
+                   << right << setw(14) << fixed << setprecision(1) << repair.ns
+                   << setw(16) << setprecision(3) << repair.allocsPerCall;
+        repairReport.push_back(repairLine.str());
+    }
+
+    cout << "\n=== FITNESS BENCHMARK (ns per evaluation) ===" << endl;
+    cout << left << setw(12) << "Instance" << right << setw(8) << "Seqs" << setw(12) << "Mismatch"
+         << setw(14) << "Reference" << setw(14) << "Streaming" << setw(11) << "Speedup"
+         << setw(14) << "Delta ok/err" << setw(12) << "Split ok/err" << endl;
+    for (const string& line : report) cout << line << endl;
+    
+    cout << "\n=== BATCH FITNESS (ns per evaluation, CPU: " << simdLevelName(detectSimdLevel()) << ") ===" << endl;
+    cout << left << setw(12) << "Instance" << right << setw(14) << "Streaming" << setw(14) << "Stream+feas"
+         << setw(12) << "scalar"
+         << setw(12) << "avx2" << setw(12) << "avx512" << setw(10) << "Errors" << endl;
+    for (const string& line : batchReport) cout << line << endl;
+    
+    cout << "\n=== REPAIR PIPELINE (per child, steady state) ===" << endl;
+    cout << left << setw(12) << "Instance" << right << setw(14) << "ns/call" << setw(16) << "allocs/call" << endl;
+    for (const string& line : repairReport) cout << line << endl;
+    
+    // Instance ngẫu nhiên 3000 node (lưới nhiều ô hơn các file CMT), dense vs on-demand
+    vector<pair<double,double>> random(3001);
+    uniform_real_distribution<> coord(0.0, 1000.0);
+    for (size_t i = 1; i < random.size(); ++i) random[i] = {round(coord(gen)), round(coord(gen))};
+    int randomErrors = checkDistanceModes(random, gen);
+    cout << "\n=== ON-DEMAND DISTANCES (3000 random nodes) ===" << endl;
+    cout << "Errors: " << randomErrors << endl;
+    totalMismatches += randomErrors;
+
+    if (totalMismatches > 0) {
+        cout << "\n❌ " << totalMismatches << " fitness mismatches" << endl;
+        return 1;
+    }
+    cout << "\n✅ All fitness scores, batch evaluations, mutation deltas, split decodings and distance modes match" << endl;
+    return 0;
+}
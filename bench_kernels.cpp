@@ -0,0 +1,288 @@
+// Benchmark các kernel nóng của GA trên từng file CMT: calculateFitness, decodeSeq,
+// splitTour, bốn crossover, sáu mutation operator, các repair, twoOptImproveCustomers và
+// localSearchImprove (tới local optimum từ population ban đầu).
+// Mỗi kernel chạy theo batch (tự hiệu chỉnh để một batch >= --min-batch-us), lặp
+// --samples lần; thời gian mỗi lần gọi = thời gian batch / số lần gọi trong batch.
+// Kết quả: bảng trên stdout + JSON (min/mean/p50/p90/p99/max ns mỗi lần gọi) để so sánh
+// giữa các phiên bản.
+//
+// Build & run:  make bench                      (ghi bench_results.json)
+//               ./bench_kernels [--json FILE] [--samples N] [--min-batch-us U] [file1.vrp ...]
+
+#define CVRP_NO_MAIN
+#include "ga8.cpp"
+
+struct KernelStats {
+    string name;
+    int batch;
+    int samples;
+    double minNs, meanNs, p50Ns, p90Ns, p99Ns, maxNs;
+};
+
+struct InstanceReport {
+    string name;
+    int customers;
+    vector<KernelStats> kernels;
+};
+
+struct BenchConfig {
+    int samples = 200;
+    double minBatchUs = 50.0;
+    string jsonPath;
+};
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double rank = p * (sorted.size() - 1);
+    size_t lo = (size_t)rank;
+    size_t hi = min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+// call(i) thực hiện lần gọi thứ i (chỉ số input xoay vòng do kernel tự chọn)
+template <typename F>
+KernelStats measure(const string& name, const BenchConfig& config, F&& call) {
+    typedef chrono::steady_clock Clock;
+    long long counter = 0;
+
+    // Hiệu chỉnh kích thước batch, đồng thời warm-up cache và bộ đệm của repair
+    int batch = 1;
+    for (;;) {
+        auto start = Clock::now();
+        for (int b = 0; b < batch; ++b) call(counter++);
+        double us = chrono::duration<double, micro>(Clock::now() - start).count();
+        if (us >= config.minBatchUs || batch >= (1 << 20)) break;
+        batch *= 2;
+    }
+
+    vector<double> perCall(config.samples);
+    for (int s = 0; s < config.samples; ++s) {
+        auto start = Clock::now();
+        for (int b = 0; b < batch; ++b) call(counter++);
+        perCall[s] = chrono::duration<double, nano>(Clock::now() - start).count() / batch;
+    }
+    sort(perCall.begin(), perCall.end());
+
+    KernelStats stats;
+    stats.name = name;
+    stats.batch = batch;
+    stats.samples = config.samples;
+    stats.minNs = perCall.front();
+    stats.maxNs = perCall.back();
+    stats.meanNs = accumulate(perCall.begin(), perCall.end(), 0.0) / perCall.size();
+    stats.p50Ns = percentile(perCall, 0.50);
+    stats.p90Ns = percentile(perCall, 0.90);
+    stats.p99Ns = percentile(perCall, 0.99);
+    return stats;
+}
+
+// Con one-point chưa repair (có duplicate / missing), input của các repair kernel
+vector<vector<int>> rawChildren(const vector<vector<int>>& parents, mt19937& gen) {
+    vector<vector<int>> children;
+    for (size_t i = 0; i + 1 < parents.size(); ++i) {
+        const vector<int>& a = parents[i];
+        const vector<int>& b = parents[i + 1];
+        size_t cut = uniform_int_distribution<size_t>(0, min(a.size(), b.size()))(gen);
+        vector<int> child(a.begin(), a.begin() + cut);
+        child.insert(child.end(), b.begin() + cut, b.end());
+        children.push_back(child);
+    }
+    return children;
+}
+
+// false nếu không đọc được instance (lỗi đã in ra cerr)
+bool benchInstance(const string& filename, const BenchConfig& config, InstanceReport& report) {
+    int n, capacity, depot, vehicles;
+    double maxDistance, serviceTime;
+    vector<pair<double,double>> coords;
+    vector<int> demand;
+    vector<vector<int>> pool;
+    DistMatrix dist;
+    {
+        // readCVRP và khởi tạo in nhiều log, không cần cho benchmark
+        ostringstream sink;
+        streambuf* original = cout.rdbuf(sink.rdbuf());
+        bool loaded = readCVRP(filename, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime);
+        if (!loaded) {
+            cout.rdbuf(original);
+            return false;
+        }
+        dist = buildDist(coords);
+        pool = initStructuredPopulation(200, vehicles, n, capacity, demand, coords, dist, depot, 1, 12345);
+        cout.rdbuf(original);
+    }
+
+    mt19937 gen(12345);
+    mt19937 opGen(777);
+    for (auto& seq : pool) {
+        repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicles);
+        repairZero(seq, vehicles, gen);
+    }
+    vector<vector<int>> children = rawChildren(pool, gen);
+    vector<vector<int>> routeCustomers; // các tuyến đã tách, input của 2-opt
+    for (const auto& seq : pool) {
+        for (const auto& route : decodeSeq(seq, depot)) {
+            if (route.size() > 4) routeCustomers.emplace_back(route.begin() + 1, route.end() - 1);
+        }
+    }
+    for (auto& customers : routeCustomers) shuffle(customers.begin(), customers.end(), gen);
+
+    repairScratch().prepare(n, vehicles);
+    vector<int> work;
+    work.reserve(n + 2 * vehicles + 16);
+    size_t P = pool.size(), C = children.size(), R = routeCustomers.size();
+    double sink = 0.0;
+
+    report.name = filename;
+    report.customers = n - 1;
+    auto& k = report.kernels;
+
+    // Sao chép vào buffer có sẵn capacity: baseline để trừ khỏi các kernel sửa seq tại chỗ
+    k.push_back(measure("copySeq", config, [&](long long i) {
+        work = pool[i % P];
+        sink += work[0];
+    }));
+    k.push_back(measure("calculateFitness", config, [&](long long i) {
+        sink += calculateFitness(pool[i % P], coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+    }));
+    k.push_back(measure("decodeSeq", config, [&](long long i) {
+        sink += decodeSeq(pool[i % P], depot).size();
+    }));
+    k.push_back(measure("splitTour", config, [&](long long i) {
+        work = pool[i % P];
+        sink += splitTour(work, vehicles, demand, capacity, depot, dist, maxDistance, serviceTime);
+    }));
+
+    typedef void (*Crossover)(const vector<int>&, const vector<int>&, vector<int>&, vector<int>&, int, int,
+                              const vector<int>&, int, int, mt19937&, const DistMatrix&, double, double);
+    const pair<const char*, Crossover> crossovers[] = {
+        {"crossoverOnePoint", crossoverOnePoint}, {"crossoverOX", crossoverOX}, {"crossoverPMX", crossoverPMX},
+        {"crossoverSREX", crossoverSREX}};
+    vector<int> kid1, kid2;
+    for (const auto& op : crossovers) {
+        k.push_back(measure(op.first, config, [&](long long i) {
+            op.second(pool[i % P], pool[(i * 7 + 3) % P], kid1, kid2, n, vehicles, demand, capacity, depot,
+                      opGen, dist, maxDistance, serviceTime);
+            sink += kid1.size();
+        }));
+    }
+
+    typedef MoveDelta (*Mutation)(vector<int>&, mt19937&, const DeltaContext*);
+    const pair<const char*, Mutation> mutations[] = {
+        {"mutateSwap", mutateSwap}, {"mutateInversion", mutateInversion}, {"mutateInsertion", mutateInsertion},
+        {"mutateOrOpt", mutateOrOpt}, {"mutateScramble", mutateScramble}, {"mutateRouteExchange", mutateRouteExchange}};
+    for (const auto& op : mutations) {
+        k.push_back(measure(op.first, config, [&](long long i) {
+            work = pool[i % P];
+            sink += op.second(work, opGen, nullptr).applied;
+        }));
+    }
+    k.push_back(measure("mutate", config, [&](long long i) {
+        work = pool[i % P];
+        mutate(work, n, vehicles, demand, capacity, opGen, dist, depot, maxDistance, serviceTime);
+        sink += work.size();
+    }));
+
+    k.push_back(measure("repairCustomer", config, [&](long long i) {
+        work = children[i % C];
+        repairCustomer(work, n, opGen);
+        sink += work.size();
+    }));
+    k.push_back(measure("repairZero", config, [&](long long i) {
+        work = children[i % C];
+        repairZero(work, vehicles, opGen);
+        sink += work.size();
+    }));
+    k.push_back(measure("repairCustomerWithLocalSearch", config, [&](long long i) {
+        work = children[i % C];
+        repairCustomerWithLocalSearch(work, n, opGen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicles);
+        sink += work.size();
+    }));
+    if (R > 0) {
+        k.push_back(measure("twoOptImproveCustomers", config, [&](long long i) {
+            sink += twoOptImproveCustomers(routeCustomers[i % R], dist, depot, 50).size();
+        }));
+    }
+    k.push_back(measure("localSearchImprove", config, [&](long long i) {
+        work = pool[i % P];
+        sink += localSearchImprove(work, dist, demand, capacity, depot, maxDistance, serviceTime, 1000, 0.0, opGen);
+    }));
+
+    if (sink == -1.0) cerr << sink << endl; // giữ kết quả sống qua optimizer
+    return true;
+}
+
+void writeJson(ostream& out, const vector<InstanceReport>& reports, const BenchConfig& config) {
+    out << "{\n";
+    out << "  \"benchmark\": \"cvrp_kernels\",\n";
+    out << "  \"dist_t\": \"" << (sizeof(dist_t) == sizeof(float) ? "float" : "double") << "\",\n";
+    out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    out << "  \"samples\": " << config.samples << ",\n";
+    out << "  \"min_batch_us\": " << config.minBatchUs << ",\n";
+    out << "  \"instances\": [\n";
+    out << fixed << setprecision(1);
+    for (size_t r = 0; r < reports.size(); ++r) {
+        const InstanceReport& report = reports[r];
+        out << "    {\"instance\": \"" << report.name << "\", \"customers\": " << report.customers << ", \"kernels\": [\n";
+        for (size_t i = 0; i < report.kernels.size(); ++i) {
+            const KernelStats& s = report.kernels[i];
+            out << "      {\"name\": \"" << s.name << "\", \"batch\": " << s.batch
+                << ", \"samples\": " << s.samples
+                << ", \"min_ns\": " << s.minNs << ", \"mean_ns\": " << s.meanNs
+                << ", \"p50_ns\": " << s.p50Ns << ", \"p90_ns\": " << s.p90Ns
+                << ", \"p99_ns\": " << s.p99Ns << ", \"max_ns\": " << s.maxNs << "}"
+                << (i + 1 < report.kernels.size() ? "," : "") << "\n";
+        }
+        out << "    ]}" << (r + 1 < reports.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            config.jsonPath = argv[++i];
+        } else if (arg == "--samples" && i + 1 < argc) {
+            config.samples = max(1, atoi(argv[++i]));
+        } else if (arg == "--min-batch-us" && i + 1 < argc) {
+            config.minBatchUs = max(1.0, atof(argv[++i]));
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        for (int i = 1; i <= 14; ++i) files.push_back("CMT" + to_string(i) + ".vrp");
+    }
+
+    vector<InstanceReport> reports;
+    for (const string& filename : files) {
+        reports.emplace_back();
+        if (!benchInstance(filename, config, reports.back())) return 1;
+
+        const InstanceReport& report = reports.back();
+        cout << "\n=== " << report.name << " (" << report.customers << " customers), ns per call ===" << endl;
+        cout << left << setw(32) << "Kernel" << right << setw(8) << "Batch"
+             << setw(12) << "p50" << setw(12) << "p90" << setw(12) << "p99" << setw(12) << "mean" << endl;
+        for (const KernelStats& s : report.kernels) {
+            cout << left << setw(32) << s.name << right << setw(8) << s.batch << fixed << setprecision(1)
+                 << setw(12) << s.p50Ns << setw(12) << s.p90Ns << setw(12) << s.p99Ns << setw(12) << s.meanNs << endl;
+        }
+    }
+
+    if (config.jsonPath.empty()) {
+        writeJson(cout, reports, config);
+    } else {
+        ofstream json(config.jsonPath);
+        if (!json) {
+            cerr << "Cannot write " << config.jsonPath << endl;
+            return 1;
+        }
+        writeJson(json, reports, config);
+        cout << "\n📊 Results written to " << config.jsonPath << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,1571 @@
+// Lõi dùng chung của các GA trong repo (ga8.cpp, bản fork gatest/ga8.cpp, gatsp.cpp):
+// đọc instance + instance cache, ma trận khoảng cách, decoder, kernel đánh giá theo biến
+// thể bài toán (TSP / CVRP / CVRP có maxDistance + serviceTime) và các repair operator.
+// Tối ưu ở đây có hiệu lực cho mọi chương trình thay vì phải chép lại từng bản.
+//
+// Header-only: mỗi chương trình là một translation unit duy nhất (g++ ga8.cpp, các script
+// và CI đều build như vậy), nên hàm thường là inline và template được instantiate tại chỗ.
+//
+// Build:  make gatsp gatest   (ga8.cpp / make lib đã include sẵn header này)
+
+#ifndef CVRP_CORE_H
+#define CVRP_CORE_H
+
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <iomanip>
+#include <numeric>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Batch fitness kernel AVX2 / AVX-512 (chọn lúc chạy, xem BATCH FITNESS)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CVRP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#include "cvrp_solver.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace std;
+
+// ======= OUTPUT =======
+
+// Luồng output của GA cho thread hiện tại. Mặc định là cout; khi nhiều run chạy
+// song song, mỗi worker trỏ vào buffer riêng và in ra trọn vẹn khi run kết thúc.
+inline thread_local ostream* gaOutStream = &cout;
+
+inline ostream& gaOut() { return *gaOutStream; }
+
+// Mức log (LogLevel trong cvrp_solver.h): ERROR < WARN < INFO < DEBUG. logLevel chọn lúc
+// chạy (--quiet = warn, --log-level); LOG_COMPILED_LEVEL là trần lúc biên dịch: bản release
+// loại bỏ hẳn các lệnh GA_LOG(LOG_DEBUG) (điều kiện hằng số, compiler xóa cả biểu thức <<).
+
+#if defined(DEBUG) || defined(CVRP_LOG_DEBUG)
+const int LOG_COMPILED_LEVEL = LOG_DEBUG;
+#else
+const int LOG_COMPILED_LEVEL = LOG_INFO;
+#endif
+
+inline atomic<int> logLevel(LOG_INFO);
+
+inline bool logEnabled(int level) {
+    return level <= LOG_COMPILED_LEVEL && level <= logLevel.load(memory_order_relaxed);
+}
+
+// GA_LOG(LOG_INFO) << ...;  Biểu thức sau << chỉ được tính khi mức log được bật.
+#define GA_LOG(level) if (!logEnabled(level)) {} else gaOut()
+
+// Trả về -1 nếu không nhận ra tên mức log
+inline int parseLogLevel(const string& name) {
+    if (name == "error" || name == "0") return LOG_ERROR;
+    if (name == "warn" || name == "warning" || name == "1") return LOG_WARN;
+    if (name == "info" || name == "2") return LOG_INFO;
+    if (name == "debug" || name == "3") return LOG_DEBUG;
+    return -1;
+}
+
+// ======= INSTRUMENTATION =======
+
+// Các phase của một generation được đo khi bật --trace. Thời gian là exclusive:
+// phase lồng nhau (repair trong crossover, 2-opt trong repair) bị trừ khỏi phase cha.
+// PHASE_SYNC_WAIT: thread gọi chờ các worker khác ở cuối bước sinh con.
+enum Phase {
+    PHASE_EVALUATION, PHASE_SORT, PHASE_SELECTION, PHASE_CROSSOVER,
+    PHASE_MUTATION, PHASE_REPAIR, PHASE_TWO_OPT, PHASE_LOCAL_SEARCH, PHASE_SYNC_WAIT, PHASE_COUNT
+};
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "evaluation", "sort", "selection", "crossover", "mutation", "repair", "two_opt", "local_search", "sync_wait"
+};
+
+struct PhaseTimes {
+    double ns[PHASE_COUNT] = {};
+    
+    PhaseTimes& operator+=(const PhaseTimes& other) {
+        for (int p = 0; p < PHASE_COUNT; ++p) ns[p] += other.ns[p];
+        return *this;
+    }
+};
+
+// Bật một lần trước khi chạy các run; tắt thì ScopedPhase chỉ tốn một load
+inline atomic<bool> phaseTimingEnabled(false);
+
+struct PhaseState {
+    PhaseTimes times;
+    int current = -1;
+    chrono::steady_clock::time_point mark;
+};
+
+inline PhaseState& phaseState() {
+    static thread_local PhaseState state;
+    return state;
+}
+
+class ScopedPhase {
+public:
+    explicit ScopedPhase(Phase phase) : active_(phaseTimingEnabled.load(memory_order_relaxed)) {
+        if (!active_) return;
+        PhaseState& state = phaseState();
+        auto now = chrono::steady_clock::now();
+        if (state.current >= 0) state.times.ns[state.current] += chrono::duration<double, nano>(now - state.mark).count();
+        parent_ = state.current;
+        state.current = phase;
+        state.mark = now;
+    }
+    
+    ~ScopedPhase() {
+        if (!active_) return;
+        PhaseState& state = phaseState();
+        auto now = chrono::steady_clock::now();
+        state.times.ns[state.current] += chrono::duration<double, nano>(now - state.mark).count();
+        state.current = parent_;
+        state.mark = now;
+    }
+    
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+    
+private:
+    bool active_;
+    int parent_ = -1;
+};
+
+// Lấy và reset thời gian tích lũy của thread hiện tại
+inline PhaseTimes takePhaseTimes() {
+    PhaseTimes times = phaseState().times;
+    phaseState().times = PhaseTimes();
+    return times;
+}
+
+// ======= UTILITY FUNCTIONS =======
+
+inline double euclidDist(double x1, double y1, double x2, double y2) {
+    double d = sqrt((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2));
+    return std::round(d * 100.0) / 100.0;
+}
+
+// FNV-1a 64-bit, nối tiếp được: hash = fnv1a(data, size, hash)
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 1469598103934665603ULL) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void writePod(ostream& out, const T& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+template <typename T>
+bool readPod(istream& in, T& value) { return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T)); }
+
+// Đọc cả file vào bộ nhớ bằng một lần read (dùng cho parser và hash của instance cache)
+inline bool readFileContents(const string& filename, string& text) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    if (size < 0) return false;
+    file.seekg(0, ios::beg);
+    text.resize((size_t)size);
+    return size == 0 || (bool)file.read(&text[0], size);
+}
+
+// Parser CVRPLIB/TSPLIB trực tiếp trên nội dung file (text phải kết thúc bằng '\0',
+// như std::string): header là các dòng "KEY : value" (dấu ':' có thể bỏ), các section
+// đọc bằng strtol/strtod trên buffer thay vì getline + istream >>.
+// Lỗi định dạng: in thông báo ra cerr và trả về false. vehicles = 0 nếu file không có.
+inline bool parseCVRPText(const string& text, int& n, int& capacity, vector<pair<double,double>>& coords, vector<int>& demand, int& depot, int& vehicles, double& maxDistance, double& serviceTime) {
+    const char* p = text.c_str();
+    const char* end = p + text.size();
+    n = 0; capacity = 0; depot = 0; vehicles = 0; maxDistance = 0.0; serviceTime = 0.0;
+    
+    // Giá trị sau key trên dòng [key, lineEnd): bỏ khoảng trắng và ':'
+    auto valueStart = [](const char* key, size_t keyLength, const char* lineEnd) {
+        const char* v = key + keyLength;
+        while (v < lineEnd && (*v == ' ' || *v == '\t' || *v == ':')) ++v;
+        return v;
+    };
+    auto findIn = [](const char* begin, const char* lineEnd, const char* key) -> const char* {
+        size_t length = strlen(key);
+        for (const char* q = begin; q + length <= lineEnd; ++q) {
+            if (*q == key[0] && memcmp(q, key, length) == 0) return q;
+        }
+        return nullptr;
+    };
+    // Tới đầu dòng kế tiếp sau dòng chứa key, false nếu không tìm thấy
+    auto skipPastLine = [&](const char* key) {
+        const char* found = strstr(p, key);
+        if (!found) return false;
+        const char* eol = static_cast<const char*>(memchr(found, '\n', end - found));
+        p = eol ? eol + 1 : end;
+        return true;
+    };
+    
+    bool coordSection = false;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* lineEnd = eol ? eol : end;
+        const char* key;
+        if ((key = findIn(p, lineEnd, "DIMENSION"))) {
+            n = (int)strtol(valueStart(key, 9, lineEnd), nullptr, 10);
+        } else if ((key = findIn(p, lineEnd, "CAPACITY"))) {
+            capacity = (int)strtol(valueStart(key, 8, lineEnd), nullptr, 10);
+        } else if ((key = findIn(p, lineEnd, "VEHICLE"))) {
+            const char* v = key + 7;
+            if (v < lineEnd && *v == 'S') ++v; // VEHICLES
+            vehicles = (int)strtol(valueStart(v, 0, lineEnd), nullptr, 10);
+        } else if ((key = findIn(p, lineEnd, "DISTANCE"))) {
+            maxDistance = strtod(valueStart(key, 8, lineEnd), nullptr);
+        } else if ((key = findIn(p, lineEnd, "SERVICE_TIME"))) {
+            serviceTime = strtod(valueStart(key, 12, lineEnd), nullptr);
+        } else if (findIn(p, lineEnd, "NODE_COORD_SECTION")) {
+            p = eol ? eol + 1 : end;
+            coordSection = true;
+            break;
+        }
+        p = eol ? eol + 1 : end;
+    }
+    if (n <= 0) {
+        cerr << "DIMENSION khong hop le trong file." << endl;
+        return false;
+    }
+    
+    auto readLong = [&](long& value) {
+        char* next;
+        value = strtol(p, &next, 10);
+        if (next == p) return false;
+        p = next;
+        return true;
+    };
+    auto readDouble = [&](double& value) {
+        char* next;
+        value = strtod(p, &next);
+        if (next == p) return false;
+        p = next;
+        return true;
+    };
+    
+    coords.assign(n+1, {0.0, 0.0});
+    for (int i = 0; i < n; ++i) {
+        long idx;
+        double x, y;
+        if (!coordSection || !readLong(idx) || !readDouble(x) || !readDouble(y)) {
+            cerr << "Loi khi doc NODE_COORD_SECTION." << endl;
+            return false;
+        }
+        if (idx >= 0 && idx <= n) coords[idx] = {x, y};
+    }
+    
+    demand.assign(n+1, 0);
+    bool demandSection = skipPastLine("DEMAND_SECTION");
+    for (int i = 0; i < n; ++i) {
+        long idx, d;
+        if (!demandSection || !readLong(idx) || !readLong(d)) {
+            cerr << "Loi khi doc DEMAND_SECTION." << endl;
+            return false;
+        }
+        if (idx >= 0 && idx <= n) demand[idx] = (int)d;
+    }
+    
+    long val;
+    depot = -1;
+    if (skipPastLine("DEPOT_SECTION")) {
+        while (readLong(val)) {
+            if (val == -1) break;
+            if (depot == -1) depot = (int)val;
+        }
+    }
+    if (depot == -1) {
+        cerr << "Khong tim thay DEPOT trong file." << endl;
+        return false;
+    }
+    return true;
+}
+
+// In cấu hình bài toán; nếu file không có VEHICLE thì suy ra số xe tối thiểu
+// (dùng chung cho file text và instance cache)
+inline void reportProblemConfiguration(const string& filename, int n, int capacity, const vector<int>& demand,
+                                int& vehicles, double maxDistance, double serviceTime) {
+    // Display problem configuration
+    GA_LOG(LOG_INFO) << "\n=== PROBLEM CONFIGURATION ===" << endl;
+    GA_LOG(LOG_INFO) << "Instance: " << filename << endl;
+    GA_LOG(LOG_INFO) << "Customers: " << (n-1) << endl;
+    GA_LOG(LOG_INFO) << "Vehicle capacity: " << capacity << endl;
+    GA_LOG(LOG_INFO) << "Number of vehicles: " << vehicles << endl;
+    if (maxDistance > 0.0) {
+        GA_LOG(LOG_INFO) << "Maximum distance/time per route: " << maxDistance << endl;
+    }
+    if (serviceTime > 0.0) {
+        GA_LOG(LOG_INFO) << "Service time per customer: " << serviceTime << endl;
+    }
+    
+    // If no vehicles information found in file, calculate minimum needed
+    if (vehicles == 0) {
+        int totalDemand = 0;
+        for (int i = 2; i <= n; ++i) {
+            totalDemand += demand[i];
+        }
+        vehicles = (int)ceil((double)totalDemand / capacity);
+        GA_LOG(LOG_INFO) << "No VEHICLE info in file. Calculated minimum vehicles: " << vehicles << endl;
+    }
+}
+
+// false nếu không mở được file hoặc file sai định dạng (lỗi đã in ra cerr); việc dừng
+// chương trình để cho CLI, thư viện nhúng chỉ báo lỗi cho caller
+inline bool readCVRP(const string& filename, int& n, int& capacity, vector<pair<double,double>>& coords, vector<int>& demand, int& depot, int& vehicles, double& maxDistance, double& serviceTime) {
+    string text;
+    if (!readFileContents(filename, text)) {
+        cerr << "Khong the mo file " << filename << endl;
+        return false;
+    }
+    if (!parseCVRPText(text, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime)) return false;
+    reportProblemConfiguration(filename, n, capacity, demand, vehicles, maxDistance, serviceTime);
+    return true;
+}
+
+// ======= SIMD DISPATCH =======
+
+// Mức SIMD chọn lúc chạy cho các kernel có bản AVX2 / AVX-512 (khoảng cách, batch fitness)
+enum class SimdLevel { Scalar = 0, AVX2, AVX512 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+inline SimdLevel detectSimdLevel() {
+#ifdef CVRP_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// ======= DISTANCE MATRIX =======
+
+// Độ chính xác của ma trận khoảng cách: build với -DCVRP_DIST_FLOAT (make float)
+// để dùng float32, giảm một nửa bộ nhớ cho các instance lớn.
+#ifdef CVRP_DIST_FLOAT
+typedef float dist_t;
+#else
+typedef double dist_t;
+#endif
+
+const size_t DIST_ALIGNMENT = 64; // cache line / độ rộng AVX-512
+
+template <typename T, size_t Align>
+struct AlignedAllocator {
+    typedef T value_type;
+    template <typename U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), align_val_t(Align)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, align_val_t(Align));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+// out[j] = euclidDist((x, y), (xs[j], ys[j])) cho j < count, tọa độ dạng SoA. Bản AVX2
+// tính 4 khoảng cách mỗi bước với cùng phép toán (không FMA, làm tròn nửa xa 0 bằng
+// trunc + so sánh phần lẻ) nên trùng từng bit với euclidDist.
+template <typename T>
+void euclidRowScalar(double x, double y, const double* xs, const double* ys, size_t count, T* out) {
+    for (size_t j = 0; j < count; ++j) out[j] = (T)euclidDist(x, y, xs[j], ys[j]);
+}
+
+#ifdef CVRP_X86_SIMD
+template <typename T>
+__attribute__((target("avx2")))
+void euclidRowAVX2(double x, double y, const double* xs, const double* ys, size_t count, T* out) {
+    const __m256d vx = _mm256_set1_pd(x), vy = _mm256_set1_pd(y);
+    const __m256d hundred = _mm256_set1_pd(100.0), half = _mm256_set1_pd(0.5), one = _mm256_set1_pd(1.0);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d dx = _mm256_sub_pd(vx, _mm256_loadu_pd(xs + j));
+        __m256d dy = _mm256_sub_pd(vy, _mm256_loadu_pd(ys + j));
+        __m256d d = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        __m256d scaled = _mm256_mul_pd(d, hundred);
+        __m256d whole = _mm256_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256d up = _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(scaled, whole), half, _CMP_GE_OQ), one);
+        __m256d rounded = _mm256_div_pd(_mm256_add_pd(whole, up), hundred);
+        if constexpr (sizeof(T) == sizeof(float)) {
+            _mm_storeu_ps(reinterpret_cast<float*>(out + j), _mm256_cvtpd_ps(rounded));
+        } else {
+            _mm256_storeu_pd(reinterpret_cast<double*>(out + j), rounded);
+        }
+    }
+    euclidRowScalar(x, y, xs + j, ys + j, count - j, out + j);
+}
+#endif
+
+template <typename T>
+void euclidRow(double x, double y, const double* xs, const double* ys, size_t count, T* out) {
+#ifdef CVRP_X86_SIMD
+    static const bool avx2 = detectSimdLevel() >= SimdLevel::AVX2;
+    if (avx2) {
+        euclidRowAVX2(x, y, xs, ys, count, out);
+        return;
+    }
+#endif
+    euclidRowScalar(x, y, xs, ys, count, out);
+}
+
+// Lưới đều 2D trên một tập điểm, dùng để tìm láng giềng gần mà không quét toàn bộ.
+// Điểm được xếp theo ô, tọa độ SoA liên tục (mỗi ô là một đoạn [cellStart[c], cellStart[c+1])
+// của xs / ys / ids), nên khoảng cách tới cả ô tính được một lượt bằng euclidRow.
+// Duyệt theo vòng Chebyshev quanh ô chứa điểm truy vấn (kẹp vào lưới nếu nằm ngoài):
+// sau vòng r, mọi điểm chưa duyệt cách điểm truy vấn ít nhất r * cellSize.
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+
+    // pointsPerCell: mật độ trung bình mong muốn mỗi ô
+    void build(const double* xs, const double* ys, const int* ids, size_t count, double pointsPerCell = 2.0) {
+        double minX = numeric_limits<double>::max(), minY = minX;
+        double maxX = numeric_limits<double>::lowest(), maxY = maxX;
+        for (size_t i = 0; i < count; ++i) {
+            minX = min(minX, xs[i]); maxX = max(maxX, xs[i]);
+            minY = min(minY, ys[i]); maxY = max(maxY, ys[i]);
+        }
+        if (count == 0) minX = maxX = minY = maxY = 0.0;
+        double extent = max(max(maxX - minX, maxY - minY), 1e-9);
+        int side = max(1, (int)ceil(sqrt(count / max(1.0, pointsPerCell))));
+        cellSize_ = extent / side * (1.0 + 1e-12);
+        originX_ = minX;
+        originY_ = minY;
+        nx_ = max(1, min(side, (int)((maxX - minX) / cellSize_) + 1));
+        ny_ = max(1, min(side, (int)((maxY - minY) / cellSize_) + 1));
+
+        cellStart_.assign((size_t)nx_ * ny_ + 1, 0);
+        vector<int> cellOf(count);
+        for (size_t i = 0; i < count; ++i) {
+            cellOf[i] = cellIndex(xs[i], ys[i]);
+            cellStart_[cellOf[i] + 1]++;
+        }
+        for (size_t c = 1; c < cellStart_.size(); ++c) cellStart_[c] += cellStart_[c - 1];
+        xs_.resize(count);
+        ys_.resize(count);
+        ids_.resize(count);
+        vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t i = 0; i < count; ++i) { // giữ thứ tự gốc trong mỗi ô
+            int slot = fill[cellOf[i]]++;
+            xs_[slot] = xs[i];
+            ys_[slot] = ys[i];
+            ids_[slot] = ids[i];
+        }
+    }
+
+    size_t size() const { return ids_.size(); }
+    double cellSize() const { return cellSize_; }
+    int rings() const { return max(nx_, ny_); }
+
+    // f(begin, end) cho mọi ô ở vòng r quanh (x, y); chỉ số trỏ vào xs() / ys() / ids()
+    template <typename F>
+    void forEachCellInRing(double x, double y, int r, F&& f) const {
+        int cx = clampCell((x - originX_) / cellSize_, nx_), cy = clampCell((y - originY_) / cellSize_, ny_);
+        auto visit = [&](int gx, int gy) {
+            if (gx < 0 || gx >= nx_ || gy < 0 || gy >= ny_) return;
+            int c = gy * nx_ + gx;
+            if (cellStart_[c] < cellStart_[c + 1]) f(cellStart_[c], cellStart_[c + 1]);
+        };
+        if (r == 0) {
+            visit(cx, cy);
+            return;
+        }
+        for (int gx = cx - r; gx <= cx + r; ++gx) {
+            visit(gx, cy - r);
+            visit(gx, cy + r);
+        }
+        for (int gy = cy - r + 1; gy <= cy + r - 1; ++gy) {
+            visit(cx - r, gy);
+            visit(cx + r, gy);
+        }
+    }
+
+    // Id gần (x, y) nhất theo bình phương khoảng cách, hòa thì id nhỏ nhất: trùng với
+    // quét tuyến tính giữ phần tử đầu tiên nhỏ nhất khi id theo thứ tự quét
+    int nearest(double x, double y) const {
+        int best = -1;
+        double bestDist = numeric_limits<double>::max();
+        for (int r = 0; r <= rings(); ++r) {
+            forEachCellInRing(x, y, r, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) {
+                    double dx = xs_[i] - x, dy = ys_[i] - y;
+                    double d = dx * dx + dy * dy;
+                    if (d < bestDist || (d == bestDist && ids_[i] < best)) {
+                        bestDist = d;
+                        best = ids_[i];
+                    }
+                }
+            });
+            double bound = r * cellSize_;
+            if (best >= 0 && bestDist < bound * bound) break;
+        }
+        return best;
+    }
+
+    const double* xs() const { return xs_.data(); }
+    const double* ys() const { return ys_.data(); }
+    const int* ids() const { return ids_.data(); }
+
+private:
+    static int clampCell(double v, int cells) { return max(0, min(cells - 1, (int)floor(v))); }
+    int cellIndex(double x, double y) const {
+        return clampCell((y - originY_) / cellSize_, ny_) * nx_ + clampCell((x - originX_) / cellSize_, nx_);
+    }
+
+    double originX_ = 0.0, originY_ = 0.0, cellSize_ = 1.0;
+    int nx_ = 1, ny_ = 1;
+    vector<int> cellStart_;
+    vector<double> xs_, ys_;
+    vector<int> ids_;
+};
+
+// Ma trận khoảng cách liên tục theo hàng (row-major) trong một khối nhớ duy nhất.
+// Mỗi hàng được pad tới bội số của cache line nên hàng nào cũng bắt đầu ở địa chỉ
+// căn lề 64 byte. dist[a][b] trả về phần tử như vector<vector<double>> cũ.
+// Khối nhớ do ma trận sở hữu, hoặc là vùng chỉ đọc bên ngoài (view(), ví dụ file
+// instance cache đã mmap) được giữ sống bởi storage_.
+//
+// Instance lớn (onDemand(), chọn theo kích thước trong buildDist): không có khối n × n,
+// dist[a][b] tính euclidDist từ tọa độ SoA khi cần (cùng giá trị từng bit với bản dense).
+// Danh sách láng giềng được build qua SpatialGrid thay vì sắp cả hàng. Ở cả hai chế độ,
+// khoảng cách tới K láng giềng được giữ thành bảng thưa neighborDistances(node).
+template <typename T>
+class DistanceMatrix {
+public:
+    typedef T value_type;
+
+    // Một hàng: con trỏ vào khối dense, hoặc tính theo tọa độ ở chế độ on-demand
+    class Row {
+    public:
+        Row(const T* values, const DistanceMatrix* owner, size_t row) : values_(values), owner_(owner), row_(row) {}
+        T operator[](size_t col) const {
+            return __builtin_expect(values_ != nullptr, 1) ? values_[col] : owner_->compute(row_, col);
+        }
+    private:
+        const T* values_;
+        const DistanceMatrix* owner_;
+        size_t row_;
+    };
+
+    DistanceMatrix() : rows_(0), stride_(0) {}
+
+    explicit DistanceMatrix(size_t rows) : rows_(rows), stride_(paddedStride(rows)) {
+        data_.assign(rows_ * stride_, T(0));
+        base_ = data_.data();
+    }
+
+    // Move giữ nguyên buffer của vector nên base_ vẫn hợp lệ; copy phải trỏ lại vào bản sao
+    DistanceMatrix(const DistanceMatrix& other) { *this = other; }
+    DistanceMatrix(DistanceMatrix&&) = default;
+    DistanceMatrix& operator=(DistanceMatrix&&) = default;
+    DistanceMatrix& operator=(const DistanceMatrix& other) {
+        if (this == &other) return *this;
+        rows_ = other.rows_;
+        stride_ = other.stride_;
+        data_ = other.data_;
+        xs_ = other.xs_;
+        ys_ = other.ys_;
+        neighborK_ = other.neighborK_;
+        neighbors_ = other.neighbors_;
+        neighborDist_ = other.neighborDist_;
+        storage_ = other.storage_;
+        base_ = storage_ || !other.base_ ? other.base_ : data_.data();
+        neighborBase_ = storage_ ? other.neighborBase_ : neighbors_.data();
+        return *this;
+    }
+
+    // Ma trận trên vùng nhớ có sẵn (không copy): data phải căn lề 64 byte, rows × stride
+    // phần tử; neighbors gồm rows × neighborK id. storage giữ vùng nhớ sống.
+    static DistanceMatrix view(size_t rows, size_t stride, const T* data, int neighborK,
+                               const int* neighbors, shared_ptr<const void> storage) {
+        DistanceMatrix matrix;
+        matrix.rows_ = rows;
+        matrix.stride_ = stride;
+        matrix.base_ = const_cast<T*>(data);
+        matrix.neighborK_ = neighborK;
+        matrix.neighborBase_ = neighbors;
+        matrix.storage_ = move(storage);
+        matrix.fillNeighborDistances();
+        return matrix;
+    }
+
+    // Không cấp phát n × n: giữ tọa độ node 1..n (coords có kích thước n + 1), tính khi cần
+    static DistanceMatrix onDemand(const vector<pair<double,double>>& coords) {
+        DistanceMatrix matrix;
+        matrix.rows_ = coords.size();
+        matrix.xs_.resize(coords.size());
+        matrix.ys_.resize(coords.size());
+        for (size_t i = 0; i < coords.size(); ++i) {
+            matrix.xs_[i] = coords[i].first;
+            matrix.ys_[i] = coords[i].second;
+        }
+        return matrix;
+    }
+
+    static size_t paddedStride(size_t cols) {
+        const size_t perLine = DIST_ALIGNMENT / sizeof(T);
+        return (cols + perLine - 1) / perLine * perLine;
+    }
+
+    Row operator[](size_t row) const { return Row(base_ ? base_ + row * stride_ : nullptr, this, row); }
+    T* mutableRow(size_t row) { return base_ + row * stride_; } // chỉ dùng khi ma trận sở hữu dữ liệu dense
+
+    T at(size_t row, size_t col) const { return base_ ? base_[row * stride_ + col] : compute(row, col); }
+
+    // Gọi f(d) với d(a, b) == at(a, b), chọn chế độ một lần ngoài vòng lặp: kernel nóng
+    // ở chế độ dense đọc thẳng con trỏ thô, không rẽ nhánh qua Row cho từng cạnh.
+    template <typename F>
+    auto withAccessor(F&& f) const {
+        if (base_) {
+            const T* base = base_;
+            const size_t stride = stride_;
+            return f([base, stride](size_t row, size_t col) { return base[row * stride + col]; });
+        }
+        return f([this](size_t row, size_t col) { return compute(row, col); });
+    }
+
+    size_t size() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+    size_t stride() const { return stride_; }
+    size_t bytes() const { return rows_ * stride_ * sizeof(T); }
+    const T* data() const { return base_; }
+    bool mapped() const { return storage_ != nullptr; }
+    bool onDemand() const { return rows_ > 0 && base_ == nullptr; }
+
+    // Bộ nhớ thực dùng: khối dense hoặc tọa độ, cộng danh sách láng giềng
+    size_t memoryBytes() const {
+        return bytes() + (xs_.size() + ys_.size()) * sizeof(double)
+             + rows_ * neighborK_ * (sizeof(int) + sizeof(T));
+    }
+
+    // Danh sách K láng giềng gần nhất của mỗi node (không gồm chính nó), sắp tăng dần
+    // theo khoảng cách; dùng cho granular local search. neighborCount() == 0 nghĩa là chưa build.
+    void buildNeighbors(int k) {
+        int n = (int)rows_ - 1;
+        neighborK_ = max(0, min(k, n - 1));
+        neighbors_.assign(rows_ * neighborK_, 0);
+        neighborBase_ = neighbors_.data();
+        if (neighborK_ == 0) {
+            neighborDist_.clear();
+            return;
+        }
+        if (onDemand()) {
+            buildNeighborsGrid();
+        } else {
+            vector<int> order;
+            for (int i = 1; i <= n; ++i) {
+                order.clear();
+                for (int j = 1; j <= n; ++j) {
+                    if (j != i) order.push_back(j);
+                }
+                const T* row = base_ + i * stride_;
+                partial_sort(order.begin(), order.begin() + neighborK_, order.end(),
+                             [row](int a, int b) { return row[a] < row[b] || (row[a] == row[b] && a < b); });
+                copy(order.begin(), order.begin() + neighborK_, neighbors_.begin() + i * neighborK_);
+            }
+        }
+        fillNeighborDistances();
+    }
+
+    const int* neighbors(size_t node) const { return neighborBase_ + node * neighborK_; }
+    // neighborDistances(node)[k] == dist[node][neighbors(node)[k]], liên tục trong bộ nhớ
+    const T* neighborDistances(size_t node) const { return neighborDist_.data() + node * neighborK_; }
+    int neighborCount() const { return neighborK_; }
+
+private:
+    // Hàng / cột 0 (không phải node) bằng 0 như trong khối dense; để ngoài dòng cho Row
+    __attribute__((noinline)) T compute(size_t row, size_t col) const {
+        if (row == 0 || col == 0) return T(0);
+        return (T)euclidDist(xs_[row], ys_[row], xs_[col], ys_[col]);
+    }
+
+    void fillNeighborDistances() {
+        neighborDist_.assign(rows_ * neighborK_, T(0));
+        for (size_t node = 1; node < rows_; ++node) {
+            const int* nb = neighbors(node);
+            for (int k = 0; k < neighborK_; ++k) neighborDist_[node * neighborK_ + k] = at(node, nb[k]);
+        }
+    }
+
+    // K láng giềng qua SpatialGrid, cùng thứ tự (khoảng cách, id) như bản sắp cả hàng.
+    // Sau vòng r, điểm chưa duyệt có khoảng cách thật >= r * cellSize; euclidDist làm tròn
+    // tới 0.01 nên chỉ dừng khi cận đó vượt láng giềng thứ K quá 0.01, không còn điểm nào
+    // có thể bằng hoặc nhỏ hơn nó sau khi làm tròn.
+    void buildNeighborsGrid() {
+        int n = (int)rows_ - 1;
+        vector<int> ids(n);
+        iota(ids.begin(), ids.end(), 1);
+        SpatialGrid grid;
+        grid.build(xs_.data() + 1, ys_.data() + 1, ids.data(), n);
+        vector<pair<T, int>> candidates;
+        vector<T> row;
+        for (int i = 1; i <= n; ++i) {
+            candidates.clear();
+            auto byDistance = [](const pair<T, int>& a, const pair<T, int>& b) {
+                return a.first < b.first || (a.first == b.first && a.second < b.second);
+            };
+            for (int r = 0; r <= grid.rings(); ++r) {
+                grid.forEachCellInRing(xs_[i], ys_[i], r, [&](int begin, int end) {
+                    row.resize(end - begin);
+                    euclidRow(xs_[i], ys_[i], grid.xs() + begin, grid.ys() + begin, end - begin, row.data());
+                    for (int c = begin; c < end; ++c) {
+                        if (grid.ids()[c] != i) candidates.push_back({row[c - begin], grid.ids()[c]});
+                    }
+                });
+                if ((int)candidates.size() < neighborK_) continue;
+                nth_element(candidates.begin(), candidates.begin() + (neighborK_ - 1), candidates.end(), byDistance);
+                double kth = candidates[neighborK_ - 1].first;
+                candidates.resize(neighborK_);
+                if (r * grid.cellSize() > kth + 0.01 + 1e-6 * kth) break;
+            }
+            sort(candidates.begin(), candidates.end(), byDistance);
+            for (int k = 0; k < neighborK_; ++k) neighbors_[i * neighborK_ + k] = candidates[k].second;
+        }
+    }
+
+    size_t rows_;
+    size_t stride_;
+    vector<T, AlignedAllocator<T, DIST_ALIGNMENT>> data_;
+    T* base_ = nullptr;
+    vector<double> xs_, ys_; // chế độ on-demand
+    int neighborK_ = 0;
+    vector<int> neighbors_;
+    const int* neighborBase_ = nullptr;
+    vector<T> neighborDist_;
+    shared_ptr<const void> storage_;
+};
+
+typedef DistanceMatrix<dist_t> DistMatrix;
+
+const int DEFAULT_NEIGHBOR_K = 20; // --neighbors K, 0 = tắt granular search
+// --dense-limit: instance nhiều node hơn thì tính khoảng cách khi cần thay vì ma trận n × n
+// (5000 node ~ 200 MB với double), 0 = luôn dense
+const size_t DEFAULT_DENSE_LIMIT = 5000;
+
+// Instance n customer + depot có dùng ma trận dense với --dense-limit này không
+inline bool usesDenseDist(int n, size_t denseLimit) {
+    return denseLimit == 0 || (size_t)n <= denseLimit;
+}
+
+inline DistMatrix buildDist(const vector<pair<double,double>>& coords, int neighborK = DEFAULT_NEIGHBOR_K,
+                     size_t denseLimit = DEFAULT_DENSE_LIMIT) {
+    int n = coords.size() - 1;
+    if (!usesDenseDist(n, denseLimit)) {
+        DistMatrix dist = DistMatrix::onDemand(coords);
+        dist.buildNeighbors(neighborK);
+        return dist;
+    }
+    DistMatrix dist(n+1);
+    vector<double> xs(n), ys(n);
+    for (int j = 1; j <= n; ++j) {
+        xs[j - 1] = coords[j].first;
+        ys[j - 1] = coords[j].second;
+    }
+    for (int i = 1; i <= n; ++i) {
+        euclidRow(coords[i].first, coords[i].second, xs.data(), ys.data(), n, dist.mutableRow(i) + 1);
+    }
+    dist.buildNeighbors(neighborK);
+    return dist;
+}
+
+// ======= INSTANCE CACHE =======
+
+// Cache nhị phân của instance đã parse cùng ma trận khoảng cách và danh sách láng giềng
+// (--instance-cache DIR), để các lần chạy lặp lại trên cùng file .vrp bỏ qua parse,
+// O(n²) sqrt và sắp xếp láng giềng. Khóa là FNV-1a của nội dung file; tên file cache
+// gồm khóa, K và kiểu dist_t. Khi trúng cache, file được mmap và DistMatrix trỏ thẳng
+// vào vùng map (không copy).
+//
+// Layout: InstanceCacheHeader, rồi coords (double x, y), demand (int32),
+// dist (rows × stride dist_t) và neighbors (int32), mỗi khối bắt đầu ở offset bội 64.
+const char INSTANCE_CACHE_MAGIC[8] = {'C', 'V', 'R', 'P', 'I', 'N', 'S', '1'};
+const uint32_t INSTANCE_CACHE_VERSION = 1;
+
+struct InstanceCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t distBytes;      // sizeof(dist_t)
+    uint64_t sourceHash;     // fnv1a của file .vrp
+    uint64_t sourceSize;
+    int32_t n, capacity, depot, vehicles; // vehicles = 0 nếu file không có VEHICLE
+    double maxDistance, serviceTime;
+    int32_t neighborK;       // K được yêu cầu (--neighbors)
+    int32_t neighborCount;   // K thực tế sau khi giới hạn bởi n
+    uint64_t stride;
+    uint64_t coordsOffset, demandOffset, distOffset, neighborsOffset, totalSize;
+};
+
+// File chỉ đọc trong bộ nhớ: mmap trên POSIX, nơi khác đọc vào buffer căn lề 64 byte
+class MappedFile {
+public:
+    static shared_ptr<MappedFile> open(const string& path) {
+        shared_ptr<MappedFile> file(new MappedFile());
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return nullptr;
+        file->data_ = static_cast<const char*>(mapping);
+        file->size_ = (size_t)info.st_size;
+#else
+        ifstream in(path, ios::binary);
+        if (!in) return nullptr;
+        in.seekg(0, ios::end);
+        streamoff size = in.tellg();
+        if (size <= 0) return nullptr;
+        in.seekg(0, ios::beg);
+        file->buffer_.resize((size_t)size);
+        if (!in.read(file->buffer_.data(), size)) return nullptr;
+        file->data_ = file->buffer_.data();
+        file->size_ = (size_t)size;
+#endif
+        return file;
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data_) munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    vector<char, AlignedAllocator<char, DIST_ALIGNMENT>> buffer_;
+#endif
+};
+
+inline string instanceCachePath(const string& cacheDir, const string& filename, uint64_t sourceHash, int neighborK) {
+    string stem = filename.substr(filename.find_last_of("/\\") + 1);
+    size_t dot = stem.rfind('.');
+    if (dot != string::npos && dot > 0) stem.resize(dot);
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)sourceHash);
+    string separator = cacheDir.empty() || cacheDir.back() == '/' || cacheDir.back() == '\\' ? "" : "/";
+    return cacheDir + separator + stem + "-" + key + "-k" + to_string(neighborK)
+         + (sizeof(dist_t) == sizeof(float) ? "-f32" : "-f64") + ".cvrpcache";
+}
+
+inline bool saveInstanceCache(const string& path, uint64_t sourceHash, uint64_t sourceSize, int neighborK,
+                       int n, int capacity, int depot, int vehicles, double maxDistance, double serviceTime,
+                       const vector<pair<double,double>>& coords, const vector<int>& demand, const DistMatrix& dist) {
+    auto align = [](uint64_t offset) { return (offset + DIST_ALIGNMENT - 1) / DIST_ALIGNMENT * DIST_ALIGNMENT; };
+    InstanceCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INSTANCE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = INSTANCE_CACHE_VERSION;
+    header.distBytes = sizeof(dist_t);
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.n = n;
+    header.capacity = capacity;
+    header.depot = depot;
+    header.vehicles = vehicles;
+    header.maxDistance = maxDistance;
+    header.serviceTime = serviceTime;
+    header.neighborK = neighborK;
+    header.neighborCount = dist.neighborCount();
+    header.stride = dist.stride();
+    header.coordsOffset = align(sizeof(header));
+    header.demandOffset = align(header.coordsOffset + (n + 1) * 2 * sizeof(double));
+    header.distOffset = align(header.demandOffset + (n + 1) * sizeof(int32_t));
+    header.neighborsOffset = align(header.distOffset + dist.bytes());
+    header.totalSize = header.neighborsOffset + dist.size() * dist.neighborCount() * sizeof(int32_t);
+    
+    // Ghi ra file tạm rồi đổi tên: process khác không bao giờ map phải file ghi dở
+    string tmpPath = path + ".tmp" + to_string(random_device{}());
+    {
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if (!out) return false;
+        auto pad = [&](uint64_t offset) {
+            static const char zeros[DIST_ALIGNMENT] = {};
+            out.write(zeros, offset - (uint64_t)out.tellp());
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad(header.coordsOffset);
+        for (int i = 0; i <= n; ++i) {
+            writePod(out, coords[i].first);
+            writePod(out, coords[i].second);
+        }
+        pad(header.demandOffset);
+        for (int i = 0; i <= n; ++i) writePod(out, (int32_t)demand[i]);
+        pad(header.distOffset);
+        out.write(reinterpret_cast<const char*>(dist.data()), dist.bytes());
+        pad(header.neighborsOffset);
+        for (size_t node = 0; node < dist.size(); ++node) {
+            const int* nb = dist.neighbors(node);
+            for (int k = 0; k < dist.neighborCount(); ++k) writePod(out, (int32_t)nb[k]);
+        }
+        if (!out) {
+            out.close();
+            remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Cache chỉ chứa ma trận dense: instance vượt denseLimit của run hiện tại không được map
+// (dù run trước với --dense-limit cao hơn đã ghi) để --dense-limit vẫn giới hạn bộ nhớ.
+inline bool loadInstanceCache(const string& path, uint64_t sourceHash, uint64_t sourceSize, int neighborK,
+                       size_t denseLimit, int& n, int& capacity, int& depot, int& vehicles, double& maxDistance,
+                       double& serviceTime, vector<pair<double,double>>& coords, vector<int>& demand, DistMatrix& dist) {
+    shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file || file->size() < sizeof(InstanceCacheHeader)) return false;
+    InstanceCacheHeader header;
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, INSTANCE_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != INSTANCE_CACHE_VERSION || header.distBytes != sizeof(dist_t)
+        || header.sourceHash != sourceHash || header.sourceSize != sourceSize
+        || header.neighborK != neighborK || header.n <= 0 || header.totalSize != file->size()
+        || !usesDenseDist(header.n, denseLimit)) {
+        return false;
+    }
+    size_t rows = header.n + 1;
+    bool consistent = header.stride == DistMatrix::paddedStride(rows)
+        && header.neighborCount >= 0 && header.neighborCount < (int32_t)rows
+        && header.distOffset % DIST_ALIGNMENT == 0
+        && header.demandOffset >= header.coordsOffset + rows * 2 * sizeof(double)
+        && header.distOffset >= header.demandOffset + rows * sizeof(int32_t)
+        && header.neighborsOffset >= header.distOffset + rows * header.stride * sizeof(dist_t)
+        && header.totalSize == header.neighborsOffset + rows * header.neighborCount * sizeof(int32_t);
+    if (!consistent) return false;
+    
+    n = header.n;
+    capacity = header.capacity;
+    depot = header.depot;
+    vehicles = header.vehicles;
+    maxDistance = header.maxDistance;
+    serviceTime = header.serviceTime;
+    coords.resize(rows);
+    demand.resize(rows);
+    const char* base = file->data();
+    for (size_t i = 0; i < rows; ++i) {
+        memcpy(&coords[i].first, base + header.coordsOffset + i * 2 * sizeof(double), sizeof(double));
+        memcpy(&coords[i].second, base + header.coordsOffset + (i * 2 + 1) * sizeof(double), sizeof(double));
+        int32_t d;
+        memcpy(&d, base + header.demandOffset + i * sizeof(int32_t), sizeof(d));
+        demand[i] = d;
+    }
+    dist = DistMatrix::view(rows, header.stride, reinterpret_cast<const dist_t*>(base + header.distOffset),
+                            header.neighborCount, reinterpret_cast<const int*>(base + header.neighborsOffset),
+                            file);
+    return true;
+}
+
+// readCVRP + buildDist; cacheDir không rỗng: thử instance cache trước, trượt thì
+// parse file text như bình thường rồi ghi cache cho lần sau. Instance vượt denseLimit
+// dùng khoảng cách on-demand: không đọc cũng không ghi cache. false như readCVRP.
+inline bool loadCVRPWithDist(const string& filename, const string& cacheDir, int neighborK, size_t denseLimit,
+                      int& n, int& capacity, vector<pair<double,double>>& coords, vector<int>& demand,
+                      int& depot, int& vehicles, double& maxDistance, double& serviceTime, DistMatrix& dist) {
+    if (cacheDir.empty()) {
+        if (!readCVRP(filename, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime)) return false;
+        dist = buildDist(coords, neighborK, denseLimit);
+        return true;
+    }
+    string text;
+    if (!readFileContents(filename, text)) {
+        cerr << "Khong the mo file " << filename << endl;
+        return false;
+    }
+    uint64_t sourceHash = fnv1a(text.data(), text.size());
+    string path = instanceCachePath(cacheDir, filename, sourceHash, neighborK);
+    if (loadInstanceCache(path, sourceHash, text.size(), neighborK, denseLimit, n, capacity, depot, vehicles,
+                          maxDistance, serviceTime, coords, demand, dist)) {
+        GA_LOG(LOG_INFO) << "Instance cache: loaded " << path << endl;
+    } else {
+        if (!parseCVRPText(text, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime)) return false;
+        dist = buildDist(coords, neighborK, denseLimit);
+        error_code ec;
+        filesystem::create_directories(cacheDir, ec);
+        if (dist.onDemand()) {
+            GA_LOG(LOG_INFO) << "Instance cache: skipped, distances are computed on demand" << endl;
+        } else if (saveInstanceCache(path, sourceHash, text.size(), neighborK, n, capacity, depot, vehicles,
+                              maxDistance, serviceTime, coords, demand, dist)) {
+            GA_LOG(LOG_INFO) << "Instance cache: wrote " << path << endl;
+        } else {
+            GA_LOG(LOG_WARN) << "Warning: cannot write instance cache " << path << endl;
+        }
+    }
+    reportProblemConfiguration(filename, n, capacity, demand, vehicles, maxDistance, serviceTime);
+    return true;
+}
+
+inline int routeDemand(const vector<int>& route, const vector<int>& demand) {
+    int sum = 0;
+    for (size_t i = 1; i < route.size() - 1; ++i) {
+        int customer = route[i];
+        if (customer > 0 && customer < (int)demand.size()) {
+            sum += demand[customer];
+        }
+    }
+    return sum;
+}
+
+inline double routeCost(const vector<int>& route, const DistMatrix& dist) {
+    double cost = 0;
+    for (size_t i = 0; i < route.size() - 1; ++i)
+        cost += dist[route[i]][route[i+1]];
+    return cost;
+}
+
+inline double totalCost(const vector<vector<int>>& routes, const DistMatrix& dist) {
+    double sum = 0;
+    for (const auto& r : routes) 
+        sum += routeCost(r, dist);
+    return sum;
+}
+
+inline bool checkSolution(const vector<vector<int>>& routes, const vector<int>& demand, int capacity, int n) {
+    vector<bool> visited(n+1, false);
+    for (const auto& route : routes) {
+        if (routeDemand(route, demand) > capacity) return false;
+        for (size_t i = 1; i < route.size() - 1; ++i) {
+            if (visited[route[i]]) return false;
+            visited[route[i]] = true;
+        }
+    }
+    for (int i = 2; i <= n; ++i)
+        if (!visited[i]) return false;
+    return true;
+}
+
+inline double polarAngle(const pair<double, double>& depot, const pair<double, double>& customer, bool normalize = false) {
+    double dx = customer.first - depot.first;
+    double dy = customer.second - depot.second;
+    double angle = atan2(dy, dx);
+    
+    if (normalize && angle < 0) {
+        angle += 2 * M_PI; // Chuyển từ [-π, π] sang [0, 2π]
+    }
+    
+    return angle;
+}
+
+// ======= DECODING =======
+
+// Hàm tính thời gian cho một tuyến
+inline double calculateRouteTime(const vector<int>& route, const DistMatrix& dist, double serviceTime) {
+    if (route.size() < 2) return 0.0;
+    
+    double totalTime = 0.0;
+    
+    // Tính travel time (khoảng cách di chuyển)
+    for (size_t i = 0; i < route.size() - 1; i++) {
+        totalTime += dist[route[i]][route[i+1]];
+    }
+    
+    // Thêm service time cho từng khách hàng (không tính depot)
+    int customerCount = route.size() - 2; // Trừ depot đầu và cuối
+    if (customerCount > 0) {
+        totalTime += customerCount * serviceTime;
+    }
+    
+    return totalTime;
+}
+
+// Hàm tìm vị trí tốt nhất để chèn customer vào route (minimal distance increase)
+inline pair<int, double> findBestInsertPosition(const vector<int>& route, int customer, 
+                                       const DistMatrix& dist, int depot) {
+    if (route.size() < 2) return {1, 0.0}; // Insert after depot
+    
+    int bestPos = 1;
+    double minIncrease = numeric_limits<double>::max();
+    
+    // Thử chèn vào mỗi vị trí trong route (trừ depot đầu và cuối)
+    for (size_t i = 1; i < route.size(); i++) {
+        int prev = route[i-1];
+        int next = route[i];
+        
+        // Tính cost tăng thêm khi chèn customer vào vị trí này
+        double currentCost = dist[prev][next];
+        double newCost = dist[prev][customer] + dist[customer][next];
+        double increase = newCost - currentCost;
+        
+        if (increase < minIncrease) {
+            minIncrease = increase;
+            bestPos = i;
+        }
+    }
+    
+    return {bestPos, minIncrease};
+}
+
+inline vector<vector<int>> decodeSeq(const vector<int>& seq, int depot) {
+    vector<vector<int>> routes;
+    vector<int> currentRoute = {depot};
+    for (int v : seq) {
+        if (v == 0) {
+            currentRoute.push_back(depot);
+            routes.push_back(currentRoute);
+            currentRoute = {depot};
+        } else {
+            currentRoute.push_back(v);
+        }
+    }
+    if (currentRoute.size() > 1) {
+        currentRoute.push_back(depot);
+        routes.push_back(currentRoute);
+    }
+    return routes;
+}
+
+// ======= EVALUATION =======
+
+// Biến thể bài toán của kernel đánh giá. Ràng buộc không áp dụng bị loại bỏ lúc biên dịch
+// (if constexpr) nên vòng lặp trên gene không còn nhánh theo maxDistance / capacity:
+//   TSP           - chỉ quãng đường (separator vẫn đóng tuyến về depot), không penalty
+//   CVRP          - + 1000 × phần vượt capacity của mỗi tuyến
+//   DistanceCVRP  - + 500 × phần vượt maxDistance của (quãng đường + serviceTime × số customer)
+enum class ProblemVariant { TSP, CVRP, DistanceCVRP };
+
+// Biến thể ứng với tham số của instance CVRP (maxDistance = 0: không giới hạn)
+inline ProblemVariant problemVariantOf(double maxDistance) {
+    return maxDistance > 0.0 ? ProblemVariant::DistanceCVRP : ProblemVariant::CVRP;
+}
+
+// Ràng buộc tuyến dùng chung của các kernel đánh giá
+struct RouteConstraints {
+    const int* demand = nullptr;
+    int demandSize = 0;
+    int capacity = 0;
+    int depot = 1;
+    double maxDistance = 0.0;
+    double serviceTime = 0.0;
+    ProblemVariant variant = ProblemVariant::CVRP;
+
+    RouteConstraints() = default;
+    RouteConstraints(const vector<int>& dem, int cap, int dep, double maxDist, double service)
+        : demand(dem.data()), demandSize(dem.size()), capacity(cap), depot(dep),
+          maxDistance(maxDist), serviceTime(service), variant(problemVariantOf(maxDist)) {}
+};
+
+// Một lượt trên giant tour (0 = separator), d(i, j) là accessor của DistMatrix::withAccessor.
+// Với CVRP / DistanceCVRP kết quả trùng từng bit với calculateFitnessReference (cùng thứ tự
+// cộng); feasible = không tuyến nào bị penalty.
+template <ProblemVariant V, typename Gene, typename Distance>
+double evaluateGenesAs(const Gene* genes, size_t length, const RouteConstraints& c, Distance d, bool& feasible) {
+    double totalCost = 0, totalPenalty = 0, routeCost = 0;
+    int routeLoad = 0, routeCustomers = 0;
+    int prev = c.depot;
+
+    auto closeRoute = [&]() {
+        routeCost += d(prev, c.depot);
+        if constexpr (V != ProblemVariant::TSP) {
+            if (routeLoad > c.capacity) {
+                double violation = routeLoad - c.capacity;
+                totalPenalty += 1000.0 * violation;
+                feasible = false;
+            }
+        }
+        if constexpr (V == ProblemVariant::DistanceCVRP) {
+            double routeTime = routeCost;
+            if (routeCustomers > 0) routeTime += routeCustomers * c.serviceTime;
+            if (routeTime > c.maxDistance) {
+                double timeViolation = routeTime - c.maxDistance;
+                totalPenalty += 500.0 * timeViolation;
+                feasible = false;
+            }
+        }
+        totalCost += routeCost;
+        routeLoad = 0;
+        routeCustomers = 0;
+        routeCost = 0;
+        prev = c.depot;
+    };
+
+    for (size_t k = 0; k < length; ++k) {
+        int v = genes[k];
+        if (v == 0) {
+            closeRoute();
+            continue;
+        }
+        if constexpr (V != ProblemVariant::TSP) {
+            if (v > 0 && v < c.demandSize) routeLoad += c.demand[v];
+        }
+        routeCost += d(prev, v);
+        prev = v;
+        routeCustomers++;
+    }
+    if (routeCustomers > 0) closeRoute();
+    return totalCost + totalPenalty;
+}
+
+// Chọn kernel theo c.variant và chế độ của dist (dense / on-demand) một lần cho cả lượt.
+// dist không được rỗng; seq rỗng bị phạt 1e6.
+template <typename Gene>
+double evaluateGenes(const Gene* genes, size_t length, const RouteConstraints& c, const DistMatrix& dist,
+                     bool& feasible) {
+    feasible = true;
+    if (length == 0) return 1e6; // Heavy penalty for empty sequence
+
+    return dist.withAccessor([&](auto d) {
+        switch (c.variant) {
+            case ProblemVariant::TSP:
+                return evaluateGenesAs<ProblemVariant::TSP>(genes, length, c, d, feasible);
+            case ProblemVariant::DistanceCVRP:
+                return evaluateGenesAs<ProblemVariant::DistanceCVRP>(genes, length, c, d, feasible);
+            default:
+                return evaluateGenesAs<ProblemVariant::CVRP>(genes, length, c, d, feasible);
+        }
+    });
+}
+
+// ======= REPAIR OPERATORS =======
+
+// Bộ đệm dùng lại của các repair operator, mỗi thread một bộ (repairScratch()).
+// prepare() cấp phát trước theo n và số xe nên trong vòng lặp thế hệ các repair
+// chỉ dùng lại capacity sẵn có, không gọi tới heap.
+struct RepairScratch {
+    vector<int> count;        // số lần xuất hiện của mỗi customer
+    vector<int> missing;      // customers bị thiếu
+    vector<int> buffer;       // bản sao seq khi ghi lại tại chỗ
+    vector<int> lengths;      // số customer mỗi tuyến
+    vector<int> appendRoute;  // tuyến nhận từng customer bị thiếu
+    vector<int> appendStart;  // bucket theo tuyến của appendRoute
+    vector<int> appendOrder;
+    
+    vector<vector<int>> routes; // tuyến có depot hai đầu, routes[0..routeCount)
+    size_t routeCount = 0;
+    vector<int> routeOfNode, posOfNode, routeLoads;
+    vector<double> routeTimes;
+    
+    void prepare(int n, int vehicle) {
+        int routesMax = max(vehicle, 1) * 2 + 2;
+        count.reserve(n + 1);
+        missing.reserve(n + 1);
+        buffer.reserve(n + routesMax);
+        lengths.reserve(routesMax);
+        appendRoute.reserve(n + 1);
+        appendStart.reserve(routesMax + 1);
+        appendOrder.reserve(n + 1);
+        if (routes.size() < (size_t)routesMax) routes.resize(routesMax);
+        for (auto& route : routes) route.reserve(n + 2);
+        routeOfNode.reserve(n + 1);
+        posOfNode.reserve(n + 1);
+        routeLoads.reserve(routesMax);
+        routeTimes.reserve(routesMax);
+    }
+};
+
+inline RepairScratch& repairScratch() {
+    static thread_local RepairScratch scratch;
+    return scratch;
+}
+
+// decodeSeq vào scratch.routes, dùng lại các vector tuyến đã cấp phát
+inline void decodeSeqInto(const vector<int>& seq, int depot, RepairScratch& scratch) {
+    auto next = [&]() -> vector<int>& {
+        if (scratch.routeCount == scratch.routes.size()) scratch.routes.emplace_back();
+        vector<int>& route = scratch.routes[scratch.routeCount++];
+        route.clear();
+        route.push_back(depot);
+        return route;
+    };
+    scratch.routeCount = 0;
+    vector<int>* current = &next();
+    for (int v : seq) {
+        if (v == 0) {
+            current->push_back(depot);
+            current = &next();
+        } else {
+            current->push_back(v);
+        }
+    }
+    if (current->size() > 1) {
+        current->push_back(depot);
+    } else {
+        scratch.routeCount--;
+    }
+}
+
+inline void repairZero(vector<int>& seq, int vehicle, mt19937& gen) {
+    ScopedPhase phase(PHASE_REPAIR);
+    
+    // Bước 1-3: Xóa số 0 ở đầu, ở cuối và các số 0 liền nhau trong một lượt O(n)
+    size_t written = 0;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        if (seq[i] == 0 && (written == 0 || seq[written - 1] == 0)) continue;
+        seq[written++] = seq[i];
+    }
+    if (written > 0 && seq[written - 1] == 0) written--;
+    seq.resize(written);
+    
+    int zeroCount = count(seq.begin(), seq.end(), 0);
+    int needZero = max(0, vehicle - 1);
+    
+    if (zeroCount == needZero) {
+        return;  // Không cần sửa
+    }
+    
+    // Hợp nhất / chia tuyến không đổi thứ tự customers, chỉ đổi vị trí separator:
+    // làm việc trên độ dài các tuyến rồi ghi lại seq một lần.
+    RepairScratch& scratch = repairScratch();
+    vector<int>& lengths = scratch.lengths;
+    vector<int>& customers = scratch.buffer;
+    lengths.clear();
+    customers.clear();
+    int length = 0;
+    for (int v : seq) {
+        if (v == 0) {
+            lengths.push_back(length);
+            length = 0;
+        } else {
+            customers.push_back(v);
+            length++;
+        }
+    }
+    if (!seq.empty()) lengths.push_back(length);
+    
+    // Trường hợp 1: Quá nhiều số 0 - xóa từ tuyến ngắn nhất
+    while (zeroCount > needZero && lengths.size() > 1) {
+        // Tìm tuyến ngắn nhất
+        int shortestIdx = min_element(lengths.begin(), lengths.end()) - lengths.begin();
+        
+        // Hợp nhất tuyến ngắn nhất với tuyến tiếp theo, hoặc tuyến trước nếu là tuyến cuối
+        if (shortestIdx + 1 < (int)lengths.size()) {
+            lengths[shortestIdx + 1] += lengths[shortestIdx];
+        } else {
+            lengths[shortestIdx - 1] += lengths[shortestIdx];
+        }
+        lengths.erase(lengths.begin() + shortestIdx);
+        
+        zeroCount--;
+    }
+    
+    // Trường hợp 2: Quá ít số 0 - thêm vào tuyến dài nhất
+    while (zeroCount < needZero) {
+        if (lengths.empty()) {
+            // Trường hợp đặc biệt: không có tuyến nào
+            lengths.push_back(0);
+            lengths.push_back(0);
+            zeroCount++;
+            continue;
+        }
+        
+        // Tìm tuyến dài nhất
+        int longestIdx = max_element(lengths.begin(), lengths.end()) - lengths.begin();
+        int maxLength = lengths[longestIdx];
+        
+        if (maxLength <= 1) {
+            // Tất cả tuyến đều rất ngắn, thêm một tuyến trống
+            lengths.push_back(0);
+        } else {
+            // Chia tuyến dài nhất thành hai nửa
+            int splitPoint = maxLength / 2;
+            lengths[longestIdx] = splitPoint;
+            lengths.insert(lengths.begin() + longestIdx + 1, maxLength - splitPoint);
+        }
+        
+        zeroCount++;
+    }
+    
+    // Chuyển đổi lại sang định dạng chuỗi
+    seq.clear();
+    size_t next = 0;
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        seq.insert(seq.end(), customers.begin() + next, customers.begin() + next + lengths[i]);
+        next += lengths[i];
+        if (i < lengths.size() - 1) {
+            seq.push_back(0);  // Thêm dấu phân cách giữa các tuyến
+        }
+    }
+}
+
+// Optimized repairCustomer function using count tracking
+inline void repairCustomer(vector<int>& seq, int n, mt19937& gen) {
+    ScopedPhase phase(PHASE_REPAIR);
+    RepairScratch& scratch = repairScratch();
+    
+    // Đếm số lần xuất hiện của mỗi customer
+    vector<int>& count = scratch.count;
+    count.assign(n+1, 0);
+    for (int v : seq) {
+        if (v != 0 && v >= 2 && v <= n) {
+            count[v]++;
+        }
+    }
+    
+    // Tìm danh sách customers bị thiếu (count = 0)
+    vector<int>& missing = scratch.missing;
+    missing.clear();
+    for (int i = 2; i <= n; ++i) {
+        if (count[i] == 0) {
+            missing.push_back(i);
+        }
+    }
+    
+    // Shuffle để randomize việc thay thế
+    shuffle(missing.begin(), missing.end(), gen);
+    size_t missingIdx = 0;
+    
+    // Lặp qua sequence và sửa từng vị trí
+    for (int& v : seq) {
+        if (v != 0 && v >= 2 && v <= n) {
+            if (count[v] > 1) {
+                // Customer này bị lặp
+                if (missingIdx < missing.size()) {
+                    // Thay bằng customer bị thiếu
+                    int oldCustomer = v;
+                    int newCustomer = missing[missingIdx];
+                    
+                    v = newCustomer;
+                    count[oldCustomer]--; // Giảm count của customer cũ
+                    count[newCustomer]++; // Tăng count của customer mới
+                    missingIdx++;
+                } else {
+                    // Không còn customer thiếu nào, thay bằng 0
+                    count[v]--; // Giảm count khi thay bằng 0
+                    v = 0;
+                }
+            }
+        }
+    }
+    
+    // Customer vẫn còn thiếu (seq bị ngắn đi): lần lượt thêm vào cuối tuyến ngắn nhất.
+    // Tuyến rỗng bị bỏ khi ghi lại; seq chỉ được ghi lại một lần ở cuối.
+    int firstMissing = 2;
+    while (firstMissing <= n && count[firstMissing] != 0) firstMissing++;
+    if (firstMissing <= n) {
+        if (none_of(seq.begin(), seq.end(), [](int v) { return v != 0; })) {
+            // Không có route nào, thêm vào cuối sequence
+            seq.push_back(firstMissing);
+            count[firstMissing] = 1;
+        }
+        
+        vector<int>& lengths = scratch.lengths;
+        lengths.clear();
+        int length = 0;
+        for (int v : seq) {
+            if (v != 0) {
+                length++;
+            } else if (length > 0) {
+                lengths.push_back(length);
+                length = 0;
+            }
+        }
+        if (length > 0) lengths.push_back(length);
+        
+        vector<int>& appendRoute = scratch.appendRoute;
+        missing.clear();
+        appendRoute.clear();
+        for (int i = firstMissing; i <= n; ++i) {
+            if (count[i] != 0) continue;
+            int shortestIdx = min_element(lengths.begin(), lengths.end()) - lengths.begin();
+            lengths[shortestIdx]++;
+            missing.push_back(i);
+            appendRoute.push_back(shortestIdx);
+            count[i] = 1; // Cập nhật count
+        }
+        
+        if (!missing.empty()) {
+            // Bucket customers thêm vào theo tuyến, giữ thứ tự thêm
+            vector<int>& start = scratch.appendStart;
+            vector<int>& order = scratch.appendOrder;
+            start.assign(lengths.size() + 1, 0);
+            for (int r : appendRoute) start[r + 1]++;
+            for (size_t r = 0; r < lengths.size(); ++r) start[r + 1] += start[r];
+            order.resize(missing.size());
+            for (size_t k = 0; k < missing.size(); ++k) order[start[appendRoute[k]]++] = missing[k];
+            
+            // Rebuild sequence từ các routes
+            vector<int>& original = scratch.buffer;
+            original.assign(seq.begin(), seq.end());
+            seq.clear();
+            size_t route = 0, appended = 0;
+            auto closeRoute = [&]() {
+                size_t end = start[route];
+                seq.insert(seq.end(), order.begin() + appended, order.begin() + end);
+                appended = end;
+                route++;
+            };
+            bool open = false;
+            for (int v : original) {
+                if (v != 0) {
+                    if (!open && route > 0) seq.push_back(0);
+                    seq.push_back(v);
+                    open = true;
+                } else if (open) {
+                    closeRoute();
+                    open = false;
+                }
+            }
+            if (open) closeRoute();
+        }
+    }
+    
+    // Kiểm tra cuối cùng: nếu vẫn còn customer nào có count > 1, thay bằng 0
+    for (int& v : seq) {
+        if (v != 0 && v >= 2 && v <= n && count[v] > 1) {
+            count[v]--; // Giảm count
+            v = 0;      // Thay bằng 0
+        }
+    }
+}
+
+#endif // CVRP_CORE_H
@@ -0,0 +1,177 @@
+// Public API của CVRP solver (GA trong ga8.cpp), dùng khi nhúng solver vào chương trình
+// khác thay vì chạy cvrp_solver và đọc stdout.
+//
+// Build:  make lib            -> libcvrp.a (ga8.cpp biên dịch với -DCVRP_NO_MAIN)
+//         g++ -std=c++17 -pthread app.cpp libcvrp.a
+//
+// Anytime solve: start() chạy GA trên thread nền; mỗi lần tìm được feasible solution
+// tốt hơn, callback được gọi và best() / poll() trả về bản mới nhất. cancel() yêu cầu
+// dừng, GA kiểm tra cờ này cuối mỗi generation.
+//
+//     AnytimeSolver solver(instance, params);
+//     solver.start([](const FeasibleSolution& s) { publish(s); });
+//     solver.waitFor(0.2);               // trả lời sau 200 ms với best hiện có
+//     FeasibleSolution plan = solver.best();
+//     ...                                // solver tiếp tục cải thiện ở nền
+//     solver.cancel();
+
+#ifndef CVRP_SOLVER_H
+#define CVRP_SOLVER_H
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Mức log của toàn bộ solver (mặc định LOG_INFO, output đi ra cout)
+enum LogLevel { LOG_ERROR = 0, LOG_WARN, LOG_INFO, LOG_DEBUG };
+void setLogLevel(int level);
+
+// Một lời giải: giant tour, các tuyến phân cách bởi 0 (depot không xuất hiện)
+struct FeasibleSolution {
+    std::vector<int> sequence;
+    double cost;
+    int generation;
+    bool isFeasible;
+
+    FeasibleSolution() : cost(std::numeric_limits<double>::max()), generation(-1), isFeasible(false) {}
+
+    FeasibleSolution(const std::vector<int>& seq, double c, int gen, bool feasible)
+        : sequence(seq), cost(c), generation(gen), isFeasible(feasible) {}
+};
+
+enum class StopReason { MaxGenerations, TimeLimit, Stagnation, TargetGap, MaxEvaluations, Cancelled };
+
+const char* stopReasonName(StopReason reason);
+
+// Các tiêu chí dừng sớm, kết hợp tùy ý (giá trị <= 0 = tắt); maxGenerations luôn áp dụng.
+// Kiểm tra cuối mỗi generation, nên time limit và số evaluation có thể vượt tối đa
+// một generation.
+struct StoppingCriteria {
+    double timeLimitSeconds = 0.0; // wall clock tính từ lúc bắt đầu run (gồm khởi tạo)
+    int maxStagnation = 0;         // số generation liên tiếp global best không cải thiện
+    double targetGap = 0.0;        // dừng khi best feasible <= optimal * (1 + targetGap%)
+    double optimalCost = 0.0;      // optimal của instance, <= 0 thì bỏ qua targetGap
+    long long maxEvaluations = 0;  // số lần tính fitness
+
+    bool hasTargetGap() const { return targetGap > 0 && optimalCost > 0; }
+    bool any() const { return timeLimitSeconds > 0 || maxStagnation > 0 || hasTargetGap() || maxEvaluations > 0; }
+};
+
+// Thay thế cá thể giữa các generation: Generational tạo lại cả population (15% elite,
+// 15% ngẫu nhiên, ~70% con); steady-state thay từng con vào population, vào chỗ cá thể
+// tệ nhất (Worst) hoặc cá thể thua một tournament (TournamentLoser) nếu con tốt hơn.
+enum class Replacement { Generational, Worst, TournamentLoser };
+
+// Cắt giant tour thành tuyến: Separators = theo số 0 trong chromosome (repair sửa capacity /
+// maxDistance); Split = bỏ số 0, chia lại tối ưu thành tuyến khả thi (Prins Split) sau mỗi
+// lần sinh con, không cần time repair.
+enum class Decoder { Separators, Split };
+
+struct GAResult {
+    int vehiclesUsed;
+    double bestCost;
+    bool isFeasible;
+    std::vector<int> bestSequence;
+    double elapsedSeconds = 0.0;
+    double timeToTarget = -1.0;  // giây tới khi best feasible <= optimal * (1 + targetGap%), -1 = chưa đạt
+    int generationToTarget = -1;
+    StopReason stopReason = StopReason::MaxGenerations;
+    int generations = 0;         // số generation đã chạy
+    long long evaluations = 0;   // số lần tính fitness (gồm population ban đầu và migrant)
+};
+
+// Dữ liệu bài toán, đánh số như file .vrp: node 1..n, coords/demand có kích thước n + 1
+struct CVRPInstance {
+    int n = 0;
+    int capacity = 0;
+    int depot = 1;
+    int vehicles = 0;
+    double maxDistance = 0.0;  // giới hạn độ dài / thời gian mỗi tuyến, 0 = không giới hạn
+    double serviceTime = 0.0;
+    double optimalCost = -1.0; // cho StoppingCriteria::targetGap, <= 0 = không biết
+    std::vector<std::pair<double,double>> coords;
+    std::vector<int> demand;
+};
+
+// Đọc file .vrp (định dạng CMT) vào instance. false nếu không mở được file hoặc sai định
+// dạng (chi tiết in ra stderr); instance giữ nguyên, chương trình nhúng vẫn chạy tiếp.
+bool loadCVRPInstance(const std::string& filename, CVRPInstance& instance);
+
+struct SolverParams {
+    int maxGenerations = 1000;
+    int populationSize = 800;
+    int numThreads = 1;        // thread sinh offspring, 0 = mọi core
+    long long seed = -1;       // -1 = random_device
+    int neighborK = 20;        // kích thước danh sách láng giềng, 0 = quét toàn bộ
+    size_t denseLimit = 5000;  // nhiều node hơn: khoảng cách tính khi cần thay vì ma trận n × n, 0 = luôn dense
+    int islands = 1;           // > 1: island model, migration mặc định
+    StoppingCriteria stopping; // optimalCost lấy từ instance nếu để 0
+
+    // Warm start: lời giải trước đó (giant tour, tuyến phân cách bởi 0, ví dụ
+    // FeasibleSolution::sequence của lần giải trước); customer không còn / mới được repair
+    std::vector<std::vector<int>> initialSolutions;
+    double seedFraction = 0.5;     // tỉ lệ population sinh từ initialSolutions
+    std::string checkpointPath;    // ghi checkpoint nhị phân định kỳ (rỗng = tắt)
+    int checkpointInterval = 100;
+    std::string resumePath;        // tiếp tục từ checkpoint đã ghi
+    int lazyInitBatch = 0;         // > 0: GA bắt đầu khi có lô đầu, mỗi generation thêm một lô
+    Replacement replacement = Replacement::Generational;
+    int tournamentSize = 2;        // tournament chọn cha mẹ / cá thể bị thay (steady-state)
+    Decoder decoder = Decoder::Separators;
+    bool adaptiveOperators = false; // chọn crossover / mutation theo gain mỗi µs (không lặp lại theo seed)
+    double localSearchRate = 0.0;   // tỉ lệ con qua local search giữa các tuyến, 0 = tắt
+    int localSearchMoves = 1000;    // số move cải thiện tối đa mỗi con
+    double localSearchMicros = 0.0; // thời gian tối đa mỗi con (µs), 0 = không giới hạn
+    bool diversity = false;         // loại lời giải trùng, chọn sống sót theo biased fitness
+    int restartAfter = 0;           // khởi tạo lại population sau G generation không cải thiện, 0 = tắt
+};
+
+// Gọi trên thread của GA mỗi khi global best feasible được cải thiện (tăng ngặt về cost,
+// không bao giờ gọi đồng thời). Nên trả về nhanh: generation kế tiếp chờ callback.
+typedef std::function<void(const FeasibleSolution&)> ImprovementCallback;
+
+// Giải đồng bộ; cancel != nullptr: dừng khi *cancel == true (kiểm tra mỗi generation).
+GAResult solveCVRP(const CVRPInstance& instance, const SolverParams& params,
+                   ImprovementCallback onImprovement = nullptr, const std::atomic<bool>* cancel = nullptr);
+
+class AnytimeSolver {
+public:
+    AnytimeSolver(const CVRPInstance& instance, const SolverParams& params);
+    ~AnytimeSolver(); // cancel() rồi chờ thread nền kết thúc
+
+    AnytimeSolver(const AnytimeSolver&) = delete;
+    AnytimeSolver& operator=(const AnytimeSolver&) = delete;
+
+    // Bắt đầu giải trên thread nền (chỉ gọi một lần)
+    void start(ImprovementCallback onImprovement = nullptr);
+
+    // Yêu cầu dừng hợp tác; GA dừng ở cuối generation hiện tại với StopReason::Cancelled
+    void cancel();
+
+    // Best feasible hiện tại (isFeasible == false nếu chưa có)
+    FeasibleSolution best() const;
+
+    // Số lần best đã được cải thiện; dùng làm version khi polling
+    long long improvements() const;
+
+    // Nếu có best mới hơn seenVersion: gán solution, cập nhật seenVersion, trả về true
+    bool poll(FeasibleSolution& solution, long long& seenVersion) const;
+
+    // Chờ tối đa timeoutSeconds; trả về true nếu solve đã kết thúc
+    bool waitFor(double timeoutSeconds) const;
+    void wait() const;
+    bool finished() const;
+
+    // Kết quả cuối; chỉ hợp lệ khi finished()
+    const GAResult& result() const;
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+#endif // CVRP_SOLVER_H
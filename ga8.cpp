@@ -10,250 +10,132 @@
 #include <numeric>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <climits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include "cvrp_solver.h"
+#include "cvrp_core.h"
 
 using namespace std;
 
-// ======= UTILITY FUNCTIONS =======
+// ======= OUTPUT =======
 
-double euclidDist(double x1, double y1, double x2, double y2) {
-    double d = sqrt((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2));
-    return std::round(d * 100.0) / 100.0;
-}
+// Public API (cvrp_solver.h): định nghĩa ở đây để libcvrp.a export hàm này
+void setLogLevel(int level) { logLevel = max((int)LOG_ERROR, min(level, (int)LOG_DEBUG)); }
 
-void readCVRP(const string& filename, int& n, int& capacity, vector<pair<double,double>>& coords, vector<int>& demand, int& depot, int& vehicles, double& maxDistance, double& serviceTime) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Khong the mo file " << filename << endl;
-        exit(1);
-    }
-    string line;
-    n = 0; capacity = 0; depot = 0; vehicles = 0; maxDistance = 0.0; serviceTime = 0.0;
-    
-    while (getline(file, line)) {
-        if (line.find("DIMENSION") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) n = stoi(line.substr(pos+1));
-        } else if (line.find("CAPACITY") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) capacity = stoi(line.substr(pos+1));
-        } else if (line.find("VEHICLE") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) vehicles = stoi(line.substr(pos+1));
-        } else if (line.find("DISTANCE") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) maxDistance = stod(line.substr(pos+1));
-        } else if (line.find("SERVICE_TIME") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) serviceTime = stod(line.substr(pos+1));
-        } else if (line.find("NODE_COORD_SECTION") != string::npos) {
-            break;
-        }
-    }
-    if (n <= 0) {
-        cerr << "DIMENSION khong hop le trong file." << endl;
-        exit(1);
-    }
-    
-    // Display problem configuration
-    cout << "\n=== PROBLEM CONFIGURATION ===" << endl;
-    cout << "Instance: " << filename << endl;
-    cout << "Customers: " << (n-1) << endl;
-    cout << "Vehicle capacity: " << capacity << endl;
-    cout << "Number of vehicles: " << vehicles << endl;
-    if (maxDistance > 0.0) {
-        cout << "Maximum distance/time per route: " << maxDistance << endl;
-    }
-    if (serviceTime > 0.0) {
-        cout << "Service time per customer: " << serviceTime << endl;
-    }
-    
-    coords.assign(n+1, {0.0, 0.0});
-    for (int i = 0; i < n; ++i) {
-        int idx;
-        double x, y;
-        if (!(file >> idx >> x >> y)) {
-            cerr << "Loi khi doc NODE_COORD_SECTION." << endl;
-            exit(1);
-        }
-        if (idx >= 0 && idx <= n) coords[idx] = {x, y};
-    }
-    getline(file, line);
-    while (getline(file, line)) {
-        if (line.find("DEMAND_SECTION") != string::npos) break;
-    }
-    demand.assign(n+1, 0);
-    for (int i = 0; i < n; ++i) {
-        int idx, d;
-        if (!(file >> idx >> d)) {
-            cerr << "Loi khi doc DEMAND_SECTION." << endl;
-            exit(1);
-        }
-        if (idx >= 0 && idx <= n) demand[idx] = d;
-    }
-    getline(file, line);
-    while (getline(file, line)) {
-        if (line.find("DEPOT_SECTION") != string::npos) break;
-    }
-    int val;
-    depot = -1;
-    while (file >> val) {
-        if (val == -1) break;
-        if (depot == -1) depot = val;
-    }
-    if (depot == -1) {
-        cerr << "Khong tim thay DEPOT trong file." << endl;
-        exit(1);
-    }
-    
-    // If no vehicles information found in file, calculate minimum needed
-    if (vehicles == 0) {
-        int totalDemand = 0;
-        for (int i = 2; i <= n; ++i) {
-            totalDemand += demand[i];
-        }
-        vehicles = (int)ceil((double)totalDemand / capacity);
-        cout << "No VEHICLE info in file. Calculated minimum vehicles: " << vehicles << endl;
-    }
-}
+// Streambuf thay cho stdout: thread ghi log chỉ nối text vào bộ đệm trong RAM
+// (endl không còn gây flush/syscall), một writer thread đổ ra stdout thật mỗi
+// FLUSH_INTERVAL hoặc khi bộ đệm vượt FLUSH_BYTES. Thứ tự output được giữ nguyên.
+class AsyncOutputBuffer : public streambuf {
+public:
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
 
-vector<vector<double>> buildDist(const vector<pair<double,double>>& coords) {
-    int n = coords.size() - 1;
-    vector<vector<double>> dist(n+1, vector<double>(n+1, 0));
-    for (int i = 1; i <= n; ++i)
-        for (int j = 1; j <= n; ++j)
-            dist[i][j] = euclidDist(coords[i].first, coords[i].second, coords[j].first, coords[j].second);
-    return dist;
-}
+    AsyncOutputBuffer() : target_(nullptr), stopping_(false) {}
+    ~AsyncOutputBuffer() { uninstall(); }
 
-int routeDemand(const vector<int>& route, const vector<int>& demand) {
-    int sum = 0;
-    for (size_t i = 1; i < route.size() - 1; ++i) {
-        int customer = route[i];
-        if (customer > 0 && customer < (int)demand.size()) {
-            sum += demand[customer];
-        }
+    void install(ostream& stream) {
+        if (target_) return;
+        stream_ = &stream;
+        target_ = stream.rdbuf(this);
+        stopping_ = false;
+        writer_ = thread([this] { writerLoop(); });
     }
-    return sum;
-}
-
-double routeCost(const vector<int>& route, const vector<vector<double>>& dist) {
-    double cost = 0;
-    for (size_t i = 0; i < route.size() - 1; ++i)
-        cost += dist[route[i]][route[i+1]];
-    return cost;
-}
 
-double totalCost(const vector<vector<int>>& routes, const vector<vector<double>>& dist) {
-    double sum = 0;
-    for (const auto& r : routes) 
-        sum += routeCost(r, dist);
-    return sum;
-}
+    // Đổ hết phần còn lại và trả lại streambuf gốc
+    void uninstall() {
+        if (!target_) return;
+        {
+            lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeup_.notify_one();
+        writer_.join();
+        stream_->rdbuf(target_);
+        target_ = nullptr;
+    }
 
-bool checkSolution(const vector<vector<int>>& routes, const vector<int>& demand, int capacity, int n) {
-    vector<bool> visited(n+1, false);
-    for (const auto& route : routes) {
-        if (routeDemand(route, demand) > capacity) return false;
-        for (size_t i = 1; i < route.size() - 1; ++i) {
-            if (visited[route[i]]) return false;
-            visited[route[i]] = true;
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch != traits_type::eof()) {
+            char c = traits_type::to_char_type(ch);
+            append(&c, 1);
         }
+        return traits_type::not_eof(ch);
     }
-    for (int i = 2; i <= n; ++i)
-        if (!visited[i]) return false;
-    return true;
-}
 
-double polarAngle(const pair<double, double>& depot, const pair<double, double>& customer, bool normalize = false) {
-    double dx = customer.first - depot.first;
-    double dy = customer.second - depot.second;
-    double angle = atan2(dy, dx);
-    
-    if (normalize && angle < 0) {
-        angle += 2 * M_PI; // Chuyển từ [-π, π] sang [0, 2π]
+    streamsize xsputn(const char* s, streamsize count) override {
+        append(s, (size_t)count);
+        return count;
     }
-    
-    return angle;
-}
 
-// ======= DECODING & FITNESS CALCULATION =======
+    int sync() override { return 0; } // writer thread lo việc flush
 
-// Hàm tính thời gian cho một tuyến
-double calculateRouteTime(const vector<int>& route, const vector<vector<double>>& dist, double serviceTime) {
-    if (route.size() < 2) return 0.0;
-    
-    double totalTime = 0.0;
-    
-    // Tính travel time (khoảng cách di chuyển)
-    for (size_t i = 0; i < route.size() - 1; i++) {
-        totalTime += dist[route[i]][route[i+1]];
-    }
-    
-    // Thêm service time cho từng khách hàng (không tính depot)
-    int customerCount = route.size() - 2; // Trừ depot đầu và cuối
-    if (customerCount > 0) {
-        totalTime += customerCount * serviceTime;
-    }
-    
-    return totalTime;
-}
+private:
+    static constexpr chrono::milliseconds FLUSH_INTERVAL{50};
 
-// Hàm tìm vị trí tốt nhất để chèn customer vào route (minimal distance increase)
-pair<int, double> findBestInsertPosition(const vector<int>& route, int customer, 
-                                       const vector<vector<double>>& dist, int depot) {
-    if (route.size() < 2) return {1, 0.0}; // Insert after depot
-    
-    int bestPos = 1;
-    double minIncrease = numeric_limits<double>::max();
-    
-    // Thử chèn vào mỗi vị trí trong route (trừ depot đầu và cuối)
-    for (size_t i = 1; i < route.size(); i++) {
-        int prev = route[i-1];
-        int next = route[i];
-        
-        // Tính cost tăng thêm khi chèn customer vào vị trí này
-        double currentCost = dist[prev][next];
-        double newCost = dist[prev][customer] + dist[customer][next];
-        double increase = newCost - currentCost;
-        
-        if (increase < minIncrease) {
-            minIncrease = increase;
-            bestPos = i;
+    void append(const char* s, size_t count) {
+        bool wake;
+        {
+            lock_guard<mutex> lock(mutex_);
+            pending_.append(s, count);
+            wake = pending_.size() >= FLUSH_BYTES;
         }
+        if (wake) wakeup_.notify_one();
     }
-    
-    return {bestPos, minIncrease};
-}
 
-vector<vector<int>> decodeSeq(const vector<int>& seq, int depot) {
-    vector<vector<int>> routes;
-    vector<int> currentRoute = {depot};
-    for (int v : seq) {
-        if (v == 0) {
-            currentRoute.push_back(depot);
-            routes.push_back(currentRoute);
-            currentRoute = {depot};
-        } else {
-            currentRoute.push_back(v);
+    void writerLoop() {
+        string chunk;
+        unique_lock<mutex> lock(mutex_);
+        for (;;) {
+            wakeup_.wait_for(lock, FLUSH_INTERVAL, [this] { return stopping_ || pending_.size() >= FLUSH_BYTES; });
+            bool done = stopping_;
+            chunk.swap(pending_);
+            lock.unlock();
+            if (!chunk.empty()) {
+                target_->sputn(chunk.data(), (streamsize)chunk.size());
+                target_->pubsync();
+                chunk.clear();
+            }
+            if (done) return;
+            lock.lock();
         }
     }
-    if (currentRoute.size() > 1) {
-        currentRoute.push_back(depot);
-        routes.push_back(currentRoute);
-    }
-    return routes;
+
+    ostream* stream_ = nullptr;
+    streambuf* target_;
+    string pending_;
+    mutex mutex_;
+    condition_variable wakeup_;
+    thread writer_;
+    bool stopping_;
+};
+
+// Bộ đệm dùng chung của chương trình; là static nên vẫn được flush khi gọi exit()
+inline AsyncOutputBuffer& asyncStdout() {
+    static AsyncOutputBuffer buffer;
+    return buffer;
 }
 
-double calculateFitness(const vector<int>& seq, const vector<pair<double,double>>& coords,
+// ======= FITNESS CALCULATION =======
+
+// Bản gốc dựa trên decodeSeq + euclidDist, giữ lại làm chuẩn so sánh (bench_fitness)
+// và fallback khi không có ma trận khoảng cách.
+double calculateFitnessReference(const vector<int>& seq, const vector<pair<double,double>>& coords,
                        const vector<int>& demand, int capacity, int depot,
-                       const vector<vector<double>>& dist = {},
-                       double maxDistance = 0.0, double serviceTime = 0.0) {
+                       const DistMatrix& dist,
+                       double maxDistance, double serviceTime) {
     
     if (seq.empty()) {
         return 1e6; // Heavy penalty for empty sequence
@@ -314,8 +196,28 @@ double calculateFitness(const vector<int>& seq, const vector<pair<double,double>
     return totalCost + totalPenalty;
 }
 
+// Tính fitness trực tiếp trên giant tour bằng ma trận dist, một lượt duy nhất qua
+// evaluateGenes (cvrp_core.h): cộng dồn demand, distance và time penalty theo từng tuyến
+// mà không decodeSeq. Kết quả trùng khớp từng bit với calculateFitnessReference.
+double calculateFitness(const vector<int>& seq, const vector<pair<double,double>>& coords,
+                       const vector<int>& demand, int capacity, int depot,
+                       const DistMatrix& dist = {},
+                       double maxDistance = 0.0, double serviceTime = 0.0) {
+    
+    if (seq.empty()) {
+        return 1e6; // Heavy penalty for empty sequence
+    }
+    if (dist.empty()) {
+        return calculateFitnessReference(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+    }
+    
+    bool feasible;
+    return evaluateGenes(seq.data(), seq.size(), RouteConstraints(demand, capacity, depot, maxDistance, serviceTime),
+                         dist, feasible);
+}
+
 bool validateCapacity(const vector<int>& seq, const vector<int>& demand, int capacity, int depot, 
-                     const vector<vector<double>>& dist = {}, double maxDistance = 0.0, double serviceTime = 0.0) {
+                     const DistMatrix& dist = {}, double maxDistance = 0.0, double serviceTime = 0.0) {
     vector<vector<int>> routes = decodeSeq(seq, depot);
     
     for (const auto& route : routes) {
@@ -343,30 +245,130 @@ bool validateCapacity(const vector<int>& seq, const vector<int>& demand, int cap
     
     return true;
 }
-vector<int> twoOptImproveCustomers(const vector<int>& customers, const vector<vector<double>>& dist, int depot, int maxIter = 50) {
-    if (customers.size() < 3) return customers;
+
+// Tham số chung của fitness kernel (như calculateFitness); dist không được rỗng
+struct FitnessParams : RouteConstraints {
+    const DistMatrix* dist;
+
+    FitnessParams(const DistMatrix& d, const vector<int>& dem, int cap, int dep, double maxDist, double service)
+        : RouteConstraints(dem, cap, dep, maxDist, service), dist(&d) {}
+};
+
+// Một lượt trên gene đã mã hóa (evaluateGenes theo p.variant): fitness trùng từng bit với
+// calculateFitness, feasible trùng với validateCapacity, không decodeSeq và không cấp phát.
+template <typename Gene>
+double fitnessOfGenes(const Gene* genes, size_t length, const FitnessParams& p, bool& feasible) {
+    return evaluateGenes(genes, length, p, *p.dist, feasible);
+}
+
+// Granular 2-opt trên path [depot] + customers + [depot]: chỉ thử move tạo cạnh mới (u, c)
+// với c thuộc danh sách láng giềng của u, dừng duyệt khi d(u, c) không còn ngắn hơn cạnh
+// bị xóa tại u. Don't-look bits: chỉ các node đầu mút của move vừa áp dụng được xét lại.
+// maxIter * m giới hạn tổng số move cải thiện. Kết quả ghi đè tại chỗ vào customers[0..m).
+void twoOptGranular(int* customers, int m, const DistMatrix& dist, int depot, int maxIter) {
+    static thread_local vector<int> path, pos, queue;
+    static thread_local vector<char> active;
+    
+    if (pos.size() < dist.size()) {
+        pos.assign(dist.size(), -1);
+        active.assign(dist.size(), 0);
+    }
+    path.assign(1, depot);
+    path.insert(path.end(), customers, customers + m);
+    path.push_back(depot);
+    queue.assign(customers, customers + m);
+    for (int p = 1; p <= m; ++p) {
+        pos[path[p]] = p;
+        active[path[p]] = 1;
+    }
+    
+    auto wake = [&](int v) {
+        if (v != depot && !active[v]) {
+            active[v] = 1;
+            queue.push_back(v);
+        }
+    };
+    // Đảo path[i+1..j]: thay cạnh (i, i+1), (j, j+1) bằng (i, j), (i+1, j+1)
+    auto apply = [&](int i, int j) {
+        reverse(path.begin() + i + 1, path.begin() + j + 1);
+        for (int r = i + 1; r <= j; ++r) pos[path[r]] = r;
+        wake(path[i]); wake(path[i + 1]); wake(path[j]); wake(path[j + 1]);
+    };
+    
+    const int K = dist.neighborCount();
+    long long moves = 0, maxMoves = (long long)maxIter * m;
+    for (size_t head = 0; head < queue.size() && moves < maxMoves; ++head) {
+        int u = queue[head];
+        if (!active[u]) continue;
+        active[u] = 0;
+        
+        const int* nb = dist.neighbors(u);
+        const dist_t* nbDist = dist.neighborDistances(u);
+        for (int t = 0; t < K; ++t) {
+            int c = nb[t];
+            if (c == depot || pos[c] < 0) continue; // c không thuộc route này
+            int p = pos[u], q = pos[c];
+            double duc = nbDist[t];
+            bool tryNext = duc < dist[u][path[p + 1]];
+            bool tryPrev = duc < dist[path[p - 1]][u];
+            if (!tryNext && !tryPrev) break;
+            
+            int lo = min(p, q), hi = max(p, q);
+            if (hi - lo < 2 || path[p] != u || path[q] != c) continue; // kề nhau hoặc customer lặp
+            // Cạnh mới (u, c) nối hai node đứng trước hai cạnh bị xóa
+            if (tryNext) {
+                double gain = dist[path[lo]][path[lo + 1]] + dist[path[hi]][path[hi + 1]]
+                            - duc - dist[path[lo + 1]][path[hi + 1]];
+                if (gain > 1e-9) { apply(lo, hi); moves++; break; }
+            }
+            // Cạnh mới (u, c) nối hai node đứng sau hai cạnh bị xóa
+            if (tryPrev) {
+                double gain = dist[path[lo - 1]][path[lo]] + dist[path[hi - 1]][path[hi]]
+                            - dist[path[lo - 1]][path[hi - 1]] - duc;
+                if (gain > 1e-9) { apply(lo - 1, hi - 1); moves++; break; }
+            }
+        }
+    }
+    
+    for (int p = 1; p <= m; ++p) {
+        pos[path[p]] = -1;
+        active[path[p]] = 0;
+    }
+    copy(path.begin() + 1, path.end() - 1, customers);
+}
+
+// 2-opt tại chỗ trên route[0..m) (chỉ customers, depot ở hai đầu ngầm định), không cấp phát
+void twoOptImproveRange(int* route, int m, const DistMatrix& dist, int depot, int maxIter = 50) {
+    if (m < 3) return;
+    ScopedPhase phase(PHASE_TWO_OPT);
     
     // Kiểm tra bounds của dist matrix
     int maxNode = dist.size() - 1;
-    for (int cust : customers) {
-        if (cust < 0 || cust > maxNode) {
-            return customers; // Return original if invalid customer
+    for (int i = 0; i < m; ++i) {
+        if (route[i] < 0 || route[i] > maxNode) {
+            return; // Keep original if invalid customer
         }
     }
     
-    vector<int> route = customers;
+    // Route ngắn hơn K: láng giềng gần nhất thường nằm ở route khác, quét đầy đủ rẻ hơn
+    if (dist.neighborCount() > 0 && m > dist.neighborCount()) {
+        twoOptGranular(route, m, dist, depot, maxIter);
+        return;
+    }
+    
+    size_t size = m;
     bool improved = true;
     int iter = 0;
     
     while (improved && iter++ < maxIter) {
         improved = false;
-        for (size_t i = 0; i + 1 < route.size(); ++i) {
-            for (size_t k = i + 2; k < route.size(); ++k) {
+        for (size_t i = 0; i + 1 < size; ++i) {
+            for (size_t k = i + 2; k < size; ++k) {
                 // Xác định các node liền kề an toàn
                 int a = (i == 0) ? depot : route[i-1];
                 int b = route[i];
                 int c = route[k];
-                int d = (k+1 == route.size()) ? depot : route[k+1];
+                int d = (k+1 == size) ? depot : route[k+1];
                 
                 // Kiểm tra bounds trước khi truy cập dist
                 if (a < 0 || a > maxNode || b < 0 || b > maxNode || 
@@ -377,143 +379,154 @@ vector<int> twoOptImproveCustomers(const vector<int>& customers, const vector<ve
                 double before = dist[a][b] + dist[c][d];
                 double after = dist[a][c] + dist[b][d];
                 
+                // First-improvement, quét tiếp thay vì bắt đầu lại từ i = 0;
+                // maxIter giới hạn số lượt quét
                 if (after + 1e-9 < before) {
-                    reverse(route.begin() + i, route.begin() + k + 1);
+                    reverse(route + i, route + k + 1);
                     improved = true;
                 }
-                
-                if (improved) break;
             }
-            if (improved) break;
         }
     }
+}
+
+vector<int> twoOptImproveCustomers(const vector<int>& customers, const DistMatrix& dist, int depot, int maxIter = 50) {
+    vector<int> route = customers;
+    twoOptImproveRange(route.data(), route.size(), dist, depot, maxIter);
     return route;
 }
-void repairCustomer(vector<int>& seq, int n, mt19937& gen);
-void repairZero(vector<int>& seq, int vehicle, mt19937& gen);
 void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
-                                 const vector<vector<double>>& dist, 
-                                 const vector<int>& demand, int capacity, int depot) ;
+                                 const DistMatrix& dist, 
+                                 const vector<int>& demand, int capacity, int depot,
+                                 double maxDistance, double serviceTime, int maxVehicles);
 // ======= INITIALIZATION METHODS (3) =======
 
+// Mỗi phương pháp sinh một cá thể từ gen được truyền vào (không có trạng thái chung
+// ngoài dữ liệu chỉ đọc), nên có thể gọi đồng thời từ nhiều worker.
+
+// Ghép các nhóm khách hàng thành giant tour, separator 0 giữa hai nhóm liên tiếp
+vector<int> groupsToSequence(const vector<vector<int>>& groups) {
+    vector<int> seq;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        for (int cust : groups[i]) seq.push_back(cust);
+        if (i != groups.size() - 1) seq.push_back(0);
+    }
+    return seq;
+}
+
 // 1. Enhanced Random Initialization with Multiple Strategies
-vector<vector<int>> initPopulationRandom(int vehicle, int n, int capacity, const vector<int>& demand, int populationSize) {
-    vector<vector<int>> populationSeq;
-    random_device rd;
-    mt19937 gen(rd());
+vector<int> randomIndividual(int vehicle, int n, int capacity, const vector<int>& demand, mt19937& gen) {
     uniform_real_distribution<> strategyDist(0.0, 1.0);
     
-    for (int p = 0; p < populationSize; ++p) {
-        vector<int> customers;
-        for (int i = 2; i <= n; ++i) customers.push_back(i);
+    vector<int> customers;
+    for (int i = 2; i <= n; ++i) customers.push_back(i);
+    
+    double strategy = strategyDist(gen);
+    vector<vector<int>> groups;
+    
+    if (strategy < 0.4) {
+        // Strategy 1: First-Fit Decreasing (40%)
+        sort(customers.begin(), customers.end(), [&](int a, int b) {
+            return demand[a] > demand[b]; // Sort by demand descending
+        });
         
-        double strategy = strategyDist(gen);
-        vector<vector<int>> groups;
+        vector<int> currentGroup;
+        int currentLoad = 0;
         
-        if (strategy < 0.4) {
-            // Strategy 1: First-Fit Decreasing (40%)
-            sort(customers.begin(), customers.end(), [&](int a, int b) {
-                return demand[a] > demand[b]; // Sort by demand descending
-            });
-            
-            vector<int> currentGroup;
-            int currentLoad = 0;
-            
-            for (int cust : customers) {
-                if (currentLoad + demand[cust] <= capacity) {
-                    currentGroup.push_back(cust);
-                    currentLoad += demand[cust];
-                } else {
-                    if (!currentGroup.empty()) groups.push_back(currentGroup);
-                    currentGroup = {cust};
-                    currentLoad = demand[cust];
-                }
+        for (int cust : customers) {
+            if (currentLoad + demand[cust] <= capacity) {
+                currentGroup.push_back(cust);
+                currentLoad += demand[cust];
+            } else {
+                if (!currentGroup.empty()) groups.push_back(currentGroup);
+                currentGroup = {cust};
+                currentLoad = demand[cust];
             }
-            if (!currentGroup.empty()) groups.push_back(currentGroup);
-            
-        } else if (strategy < 0.7) {
-            // Strategy 2: Best-Fit (30%)
-            shuffle(customers.begin(), customers.end(), gen);
-            vector<int> routeLoads(vehicle, 0);
-            vector<vector<int>> routes(vehicle);
+        }
+        if (!currentGroup.empty()) groups.push_back(currentGroup);
+        
+    } else if (strategy < 0.7) {
+        // Strategy 2: Best-Fit (30%)
+        shuffle(customers.begin(), customers.end(), gen);
+        vector<int> routeLoads(vehicle, 0);
+        vector<vector<int>> routes(vehicle);
+        
+        for (int cust : customers) {
+            int bestRoute = -1;
+            int minWaste = capacity + 1;
             
-            for (int cust : customers) {
-                int bestRoute = -1;
-                int minWaste = capacity + 1;
-                
-                // Find route with minimum waste that can fit this customer
-                for (int r = 0; r < vehicle; ++r) {
-                    if (routeLoads[r] + demand[cust] <= capacity) {
-                        int waste = capacity - (routeLoads[r] + demand[cust]);
-                        if (waste < minWaste) {
-                            minWaste = waste;
-                            bestRoute = r;
-                        }
-                    }
-                }
-                
-                if (bestRoute != -1) {
-                    routes[bestRoute].push_back(cust);
-                    routeLoads[bestRoute] += demand[cust];
-                } else {
-                    // Find route with minimum load
-                    int minLoadRoute = 0;
-                    for (int r = 1; r < vehicle; ++r) {
-                        if (routeLoads[r] < routeLoads[minLoadRoute]) {
-                            minLoadRoute = r;
-                        }
+            // Find route with minimum waste that can fit this customer
+            for (int r = 0; r < vehicle; ++r) {
+                if (routeLoads[r] + demand[cust] <= capacity) {
+                    int waste = capacity - (routeLoads[r] + demand[cust]);
+                    if (waste < minWaste) {
+                        minWaste = waste;
+                        bestRoute = r;
                     }
-                    routes[minLoadRoute].push_back(cust);
-                    routeLoads[minLoadRoute] += demand[cust];
                 }
             }
             
-            for (const auto& route : routes) {
-                if (!route.empty()) groups.push_back(route);
-            }
-            
-        } else {
-            // Strategy 3: Random Shuffle + First-Fit (30%)
-            shuffle(customers.begin(), customers.end(), gen);
-            
-            vector<int> currentGroup;
-            int currentLoad = 0;
-            
-            for (int cust : customers) {
-                if (currentLoad + demand[cust] <= capacity) {
-                    currentGroup.push_back(cust);
-                    currentLoad += demand[cust];
-                } else {
-                    if (!currentGroup.empty()) groups.push_back(currentGroup);
-                    currentGroup = {cust};
-                    currentLoad = demand[cust];
+            if (bestRoute != -1) {
+                routes[bestRoute].push_back(cust);
+                routeLoads[bestRoute] += demand[cust];
+            } else {
+                // Find route with minimum load
+                int minLoadRoute = 0;
+                for (int r = 1; r < vehicle; ++r) {
+                    if (routeLoads[r] < routeLoads[minLoadRoute]) {
+                        minLoadRoute = r;
+                    }
                 }
+                routes[minLoadRoute].push_back(cust);
+                routeLoads[minLoadRoute] += demand[cust];
             }
-            if (!currentGroup.empty()) groups.push_back(currentGroup);
         }
         
-        // Ensure we have enough routes
-        while ((int)groups.size() < vehicle) groups.push_back({});
-        
-        // Convert to sequence format
-        vector<int> seq;
-        for (size_t i = 0; i < groups.size(); ++i) {
-            for (int cust : groups[i]) seq.push_back(cust);
-            if (i != groups.size() - 1) seq.push_back(0);
+        for (const auto& route : routes) {
+            if (!route.empty()) groups.push_back(route);
         }
         
-        populationSeq.push_back(seq);
+    } else {
+        // Strategy 3: Random Shuffle + First-Fit (30%)
+        shuffle(customers.begin(), customers.end(), gen);
+        
+        vector<int> currentGroup;
+        int currentLoad = 0;
+        
+        for (int cust : customers) {
+            if (currentLoad + demand[cust] <= capacity) {
+                currentGroup.push_back(cust);
+                currentLoad += demand[cust];
+            } else {
+                if (!currentGroup.empty()) groups.push_back(currentGroup);
+                currentGroup = {cust};
+                currentLoad = demand[cust];
+            }
+        }
+        if (!currentGroup.empty()) groups.push_back(currentGroup);
     }
     
-    return populationSeq;
+    // Ensure we have enough routes
+    while ((int)groups.size() < vehicle) groups.push_back({});
+    
+    return groupsToSequence(groups);
 }
 
+vector<vector<int>> initPopulationRandom(int vehicle, int n, int capacity, const vector<int>& demand, int populationSize,
+                                         unsigned int seed = random_device{}()) {
+    vector<vector<int>> populationSeq;
+    mt19937 gen(seed);
+    for (int p = 0; p < populationSize; ++p) {
+        populationSeq.push_back(randomIndividual(vehicle, n, capacity, demand, gen));
+    }
+    return populationSeq;
+}
 // 2. Sweep Initialization
 vector<vector<int>> initPopulationSweep(int vehicle, int n, int capacity, const vector<int>& demand, 
-                                      const vector<pair<double, double>>& coords, int depot, int populationSize) {
+                                      const vector<pair<double, double>>& coords, int depot, int populationSize,
+                                      unsigned int seed = random_device{}()) {
     vector<vector<int>> populationSeq;
-    random_device rd;
-    mt19937 gen(rd());
+    mt19937 gen(seed);
     uniform_real_distribution<double> prob(0.0, 1.0);
 
     // Tính tổng demand để tính hệ số tightness
@@ -613,640 +626,472 @@ vector<vector<int>> initPopulationSweep(int vehicle, int n, int capacity, const
     return populationSeq;
 }
 
-// 3. Nearest Neighbor Initialization
-vector<vector<int>> initPopulationNearestNeighbor(int vehicle, int n, int capacity, const vector<int>& demand,
-                                                const vector<pair<double,double>>& coords, int depot, int populationSize) {
-    vector<vector<int>> populationSeq;
-    random_device rd;
-    mt19937 gen(rd());
+
+// Khách hàng sắp theo góc polar quanh depot ([0, 2π), tăng dần), tính một lần và dùng
+// chung: sweep với góc bắt đầu ngẫu nhiên chỉ là một phép xoay của thứ tự này.
+struct PolarOrder {
+    vector<int> customers;
+    vector<double> angles;
+
+    PolarOrder(int n, const vector<pair<double,double>>& coords, int depot) {
+        vector<pair<double, int>> byAngle;
+        for (int i = 2; i <= n; ++i) {
+            byAngle.emplace_back(polarAngle(coords[depot], coords[i], true), i);
+        }
+        sort(byAngle.begin(), byAngle.end());
+        for (const auto& entry : byAngle) {
+            angles.push_back(entry.first);
+            customers.push_back(entry.second);
+        }
+    }
+
+    // Vị trí bắt đầu khi cộng offset vào mọi góc (mod 2π) rồi sắp lại
+    size_t rotation(double offset) const {
+        size_t start = lower_bound(angles.begin(), angles.end(), 2 * M_PI - offset) - angles.begin();
+        return start == angles.size() ? 0 : start;
+    }
+};
+
+// Sweep từ góc bắt đầu ngẫu nhiên, mỗi route được 2-opt (dùng trong initStructuredPopulation)
+vector<int> sweepIndividual(int vehicle, int n, int capacity, const vector<int>& demand,
+                            const PolarOrder& polar, const DistMatrix& dist, int depot, mt19937& gen) {
+    uniform_real_distribution<double> angleDist(0.0, 2 * M_PI);
+    size_t start = polar.rotation(angleDist(gen));
+    size_t m = polar.customers.size();
+    
+    // Create routes using sweep
+    vector<vector<int>> routes;
+    vector<int> currentRoute;
+    int currentLoad = 0;
     
-    // Build distance matrix
-    vector<vector<double>> dist(n+1, vector<double>(n+1));
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= n; ++j) {
-            dist[i][j] = euclidDist(coords[i].first, coords[i].second, 
-                                   coords[j].first, coords[j].second);
+    for (size_t k = 0; k < m; ++k) {
+        int custId = polar.customers[(start + k) % m];
+        if (currentLoad + demand[custId] <= capacity) {
+            currentRoute.push_back(custId);
+            currentLoad += demand[custId];
+        } else {
+            if (!currentRoute.empty()) {
+                // Apply 2-opt improvement to the route
+                twoOptImproveRange(currentRoute.data(), currentRoute.size(), dist, depot, 30);
+                routes.push_back(currentRoute);
+            }
+            currentRoute = {custId};
+            currentLoad = demand[custId];
         }
     }
     
-    for (int p = 0; p < populationSize; ++p) {
-        vector<bool> visited(n+1, false);
-        visited[depot] = true; // Depot is always visited
-        vector<vector<int>> routes;
+    if (!currentRoute.empty()) {
+        twoOptImproveRange(currentRoute.data(), currentRoute.size(), dist, depot, 30);
+        routes.push_back(currentRoute);
+    }
+    
+    // Convert to sequence with separators (with size limit)
+    vector<int> seq;
+    seq.reserve(n + vehicle); // Pre-allocate memory
+    
+    for (size_t i = 0; i < routes.size() && seq.size() < n + vehicle - 1; ++i) {
+        for (int cust : routes[i]) {
+            if (seq.size() < n + vehicle - 1) seq.push_back(cust);
+        }
+        if (i < routes.size() - 1 && seq.size() < n + vehicle - 1) seq.push_back(0);
+    }
+    
+    // Limit the number of empty routes to prevent memory explosion
+    int maxEmptyRoutes = 2; // Limit empty routes
+    int emptyRoutesAdded = 0;
+    while ((int)routes.size() < vehicle && emptyRoutesAdded < maxEmptyRoutes) {
+        if (!seq.empty() && seq.back() != 0 && seq.size() < n + vehicle - 1) seq.push_back(0);
+        if (seq.size() < n + vehicle - 1) seq.push_back(0);
+        emptyRoutesAdded++;
+    }
+    return seq;
+}
+
+// 3. Nearest Neighbor Initialization
+// Ứng viên lấy từ danh sách láng giềng của dist trước; chỉ quét toàn bộ tập chưa thăm
+// khi không chứng minh được ứng viên đó tốt nhất: mọi khách hàng ngoài danh sách có
+// khoảng cách >= láng giềng thứ K, nên score >= d_K / maxDemand. Kết quả giống hệt
+// quét toàn bộ (cùng tie-break theo id nhỏ nhất).
+vector<int> nearestNeighborIndividual(int vehicle, int n, int capacity, const vector<int>& demand,
+                                      const DistMatrix& dist, int depot, int maxDemand, mt19937& gen) {
+    // Tập chưa thăm dạng mảng gọn, xóa bằng cách đổi chỗ với phần tử cuối
+    vector<int> unvisited, position(n + 1, -1);
+    for (int i = 2; i <= n; ++i) {
+        if (i == depot) continue;
+        position[i] = unvisited.size();
+        unvisited.push_back(i);
+    }
+    auto take = [&](int customer) {
+        int last = unvisited.back();
+        unvisited[position[customer]] = last;
+        position[last] = position[customer];
+        unvisited.pop_back();
+        position[customer] = -1;
+    };
+    
+    // For large problems, use efficiency score (distance/demand)
+    bool byEfficiency = n > 100;
+    auto score = [&](int from, int customer) {
+        double distance = dist[from][customer];
+        return byEfficiency ? distance / max(1.0, (double)demand[customer]) : distance;
+    };
+    int K = dist.neighborCount();
+    bool completeLists = K >= n - 1; // danh sách chứa mọi node
+    double demandBound = byEfficiency ? max(1.0, (double)maxDemand) : 1.0;
+    
+    vector<vector<int>> routes;
+    while (!unvisited.empty()) {
+        // Start new route from a random customer for diversity
+        vector<int> route;
+        int startCustomer = unvisited[uniform_int_distribution<>(0, unvisited.size() - 1)(gen)];
+        take(startCustomer);
+        route.push_back(startCustomer);
+        int currentLoad = demand[startCustomer];
+        int currentPos = startCustomer;
         
-        while (true) {
-            // Find unvisited customers
-            vector<int> unvisited;
-            for (int i = 2; i <= n; ++i) {
-                if (!visited[i]) unvisited.push_back(i);
-            }
-            
-            if (unvisited.empty()) break;
-            
-            // Start new route
-            vector<int> route;
-            int currentLoad = 0;
-            int currentPos = depot;
-            
-            // Choose random starting customer for diversity
-            uniform_int_distribution<> startDist(0, unvisited.size()-1);
-            int startIdx = startDist(gen);
-            int startCustomer = unvisited[startIdx];
-            
-            route.push_back(startCustomer);
-            visited[startCustomer] = true;
-            currentLoad += demand[startCustomer];
-            currentPos = startCustomer;
-            
-            // Build route using nearest neighbor with capacity constraint
-            while (true) {
-                int nearestCustomer = -1;
-                double nearestScore = numeric_limits<double>::max();
-                
-                // Find best unvisited customer that fits in capacity
-                for (int i = 2; i <= n; ++i) {
-                    if (!visited[i] && currentLoad + demand[i] <= capacity) {
-                        double distance = dist[currentPos][i];
-                        double score;
-                        
-                        // For large problems, use efficiency score (distance/demand)
-                        if (n > 100) {
-                            score = distance / max(1.0, (double)demand[i]);
-                        } else {
-                            score = distance; // Standard nearest neighbor
-                        }
-                        
-                        if (score < nearestScore) {
-                            nearestScore = score;
-                            nearestCustomer = i;
-                        }
-                    }
+        // Build route using nearest neighbor with capacity constraint
+        while (!unvisited.empty()) {
+            int nearestCustomer = -1;
+            double nearestScore = numeric_limits<double>::max();
+            auto consider = [&](int c) {
+                if (currentLoad + demand[c] > capacity) return false;
+                double s = score(currentPos, c);
+                if (s < nearestScore || (s == nearestScore && c < nearestCustomer)) {
+                    nearestScore = s;
+                    nearestCustomer = c;
                 }
-                
-                if (nearestCustomer == -1) break; // No more customers can fit
-                
-                route.push_back(nearestCustomer);
-                visited[nearestCustomer] = true;
-                currentLoad += demand[nearestCustomer];
-                currentPos = nearestCustomer;
+                return true;
+            };
+            
+            const int* nb = dist.neighbors(currentPos);
+            for (int k = 0; k < K; ++k) {
+                // Theo khoảng cách: danh sách tăng dần nên ứng viên hợp lệ đầu tiên là gần nhất
+                if (position[nb[k]] >= 0 && consider(nb[k]) && !byEfficiency) break;
+            }
+            bool proven = nearestCustomer != -1
+                && (completeLists || nearestScore < dist.neighborDistances(currentPos)[K - 1] / demandBound);
+            if (!proven && !completeLists) {
+                for (int c : unvisited) consider(c);
             }
             
-            routes.push_back(route);
+            if (nearestCustomer == -1) break; // No more customers can fit
             
-            if (routes.size() >= (size_t)vehicle) break; // Vehicle limit reached
+            take(nearestCustomer);
+            route.push_back(nearestCustomer);
+            currentLoad += demand[nearestCustomer];
+            currentPos = nearestCustomer;
         }
         
-        // Convert routes to sequence
-        vector<int> seq;
-        for (size_t i = 0; i < routes.size(); ++i) {
-            for (int customer : routes[i]) {
-                seq.push_back(customer);
-            }
-            if (i < routes.size() - 1) {
-                seq.push_back(0);
-            }
-        }
+        routes.push_back(route);
         
-        populationSeq.push_back(seq);
+        if (routes.size() >= (size_t)vehicle) break; // Vehicle limit reached
     }
     
+    return groupsToSequence(routes);
+}
+
+vector<vector<int>> initPopulationNearestNeighbor(int vehicle, int n, int capacity, const vector<int>& demand,
+                                                const DistMatrix& dist, int depot, int populationSize,
+                                                unsigned int seed = random_device{}()) {
+    vector<vector<int>> populationSeq;
+    mt19937 gen(seed);
+    int maxDemand = *max_element(demand.begin(), demand.end());
+    for (int p = 0; p < populationSize; ++p) {
+        populationSeq.push_back(nearestNeighborIndividual(vehicle, n, capacity, demand, dist, depot, maxDemand, gen));
+    }
     return populationSeq;
 }
 
 // 4. Cluster-based Initialization
-vector<vector<int>> initPopulationCluster(int vehicle, int n, int capacity, const vector<int>& demand, 
-                                        const vector<pair<double,double>>& coords, int depot, int populationSize) {
-    vector<vector<int>> populationSeq;
-    random_device rd;
-    mt19937 gen(rd());
+// Từ số centroid này trở lên, gán customer vào centroid gần nhất qua SpatialGrid thay vì
+// quét mọi centroid (cùng kết quả, kể cả tie-break theo centroid nhỏ nhất)
+const int CLUSTER_GRID_MIN_CENTROIDS = 32;
+
+vector<int> clusterIndividual(int vehicle, int n, int capacity, const vector<int>& demand,
+                              const vector<pair<double,double>>& coords, mt19937& gen) {
+    auto squaredDist = [&](int i, const pair<double,double>& c) {
+        double dx = coords[i].first - c.first, dy = coords[i].second - c.second;
+        return dx * dx + dy * dy;
+    };
+    
+    // Initialize centroids randomly
+    vector<pair<double,double>> centroids;
+    uniform_real_distribution<> coordDist(0, 100); // Adjust range as needed
+    
+    for (int k = 0; k < vehicle; ++k) {
+        centroids.push_back({coordDist(gen), coordDist(gen)});
+    }
     
-    for (int p = 0; p < populationSize; ++p) {
-        // Initialize centroids randomly
-        vector<pair<double,double>> centroids;
-        uniform_real_distribution<> coordDist(0, 100); // Adjust range as needed
-        
-        for (int k = 0; k < vehicle; ++k) {
-            centroids.push_back({coordDist(gen), coordDist(gen)});
+    // Assign customers to clusters using K-means (so sánh bình phương khoảng cách)
+    vector<int> assignment(n+1);
+    vector<double> sumX(vehicle), sumY(vehicle);
+    vector<int> count(vehicle);
+    bool useGrid = vehicle >= CLUSTER_GRID_MIN_CENTROIDS;
+    SpatialGrid grid;
+    vector<double> centroidX, centroidY;
+    vector<int> centroidIds(vehicle);
+    iota(centroidIds.begin(), centroidIds.end(), 0);
+    for (int iter = 0; iter < 10; ++iter) { // 10 iterations of k-means
+        if (useGrid) {
+            centroidX.clear();
+            centroidY.clear();
+            for (const auto& c : centroids) {
+                centroidX.push_back(c.first);
+                centroidY.push_back(c.second);
+            }
+            grid.build(centroidX.data(), centroidY.data(), centroidIds.data(), vehicle);
+            for (int i = 2; i <= n; ++i) assignment[i] = grid.nearest(coords[i].first, coords[i].second);
         }
-        
-        // Assign customers to clusters using K-means
-        vector<int> assignment(n+1);
-        for (int iter = 0; iter < 10; ++iter) { // 10 iterations of k-means
-            // Assign customers to nearest centroid
-            for (int i = 2; i <= n; ++i) {
-                double minDist = numeric_limits<double>::max();
-                int bestCluster = 0;
-                
-                for (int k = 0; k < vehicle; ++k) {
-                    double d = euclidDist(coords[i].first, coords[i].second, 
-                                        centroids[k].first, centroids[k].second);
-                    if (d < minDist) { 
-                        minDist = d; 
-                        bestCluster = k;
-                    }
-                }
-                
-                assignment[i] = bestCluster;
-            }
-            
-            // Update centroids
-            vector<double> sumX(vehicle, 0), sumY(vehicle, 0);
-            vector<int> count(vehicle, 0);
-            
-            for (int i = 2; i <= n; ++i) {
-                sumX[assignment[i]] += coords[i].first;
-                sumY[assignment[i]] += coords[i].second;
-                count[assignment[i]]++;
-            }
+        // Assign customers to nearest centroid
+        for (int i = 2; i <= n && !useGrid; ++i) {
+            double minDist = numeric_limits<double>::max();
+            int bestCluster = 0;
             
             for (int k = 0; k < vehicle; ++k) {
-                if (count[k] > 0) {
-                    centroids[k] = {sumX[k]/count[k], sumY[k]/count[k]};
+                double d = squaredDist(i, centroids[k]);
+                if (d < minDist) { 
+                    minDist = d; 
+                    bestCluster = k;
                 }
             }
+            
+            assignment[i] = bestCluster;
         }
         
-        // Create routes from clusters with capacity constraint
-        vector<vector<int>> routes(vehicle);
+        // Update centroids
+        fill(sumX.begin(), sumX.end(), 0.0);
+        fill(sumY.begin(), sumY.end(), 0.0);
+        fill(count.begin(), count.end(), 0);
         
-        // First, assign customers to their clusters
         for (int i = 2; i <= n; ++i) {
-            routes[assignment[i]].push_back(i);
+            sumX[assignment[i]] += coords[i].first;
+            sumY[assignment[i]] += coords[i].second;
+            count[assignment[i]]++;
         }
         
-        // Handle capacity constraints
-        vector<int> seq;
         for (int k = 0; k < vehicle; ++k) {
-            vector<int> cluster = routes[k];
-            
-            // Sort customers by distance from centroid
-            sort(cluster.begin(), cluster.end(), [&](int a, int b) {
-                double da = euclidDist(coords[a].first, coords[a].second,
-                                     centroids[k].first, centroids[k].second);
-                double db = euclidDist(coords[b].first, coords[b].second,
-                                     centroids[k].first, centroids[k].second);
-                return da < db;
-            });
-            
-            // Create feasible routes
-            int clusterLoad = 0;
-            vector<int> route;
-            
-            for (int customer : cluster) {
-                if (clusterLoad + demand[customer] <= capacity) {
-                    route.push_back(customer);
-                    clusterLoad += demand[customer];
-                } else {
-                    // This customer doesn't fit, add to next vehicle
-                    if (k+1 < vehicle) {
-                        routes[k+1].push_back(customer);
-                    } else {
-                        // No more vehicles, just add at the end and repair later
-                        route.push_back(customer);
-                    }
-                }
-            }
-            
-            // Add route to sequence
-            for (int customer : route) {
-                seq.push_back(customer);
-            }
-            
-            if (k < vehicle - 1) {
-                seq.push_back(0); // Separator
+            if (count[k] > 0) {
+                centroids[k] = {sumX[k]/count[k], sumY[k]/count[k]};
             }
         }
-        
-        populationSeq.push_back(seq);
     }
     
-    return populationSeq;
-}
-
-// ======= HYBRID INITIALIZATION =======
-vector<vector<int>> initStructuredPopulation(int populationSize, int vehicle, int n, int capacity, const vector<int>& demand, const vector<pair<double,double>>& coords, const vector<vector<double>>& dist, int depot, int runNumber = 1) {
-    random_device rd;
-    unsigned int seed = rd() + runNumber * 54321;  // Different seed for initialization
-    mt19937 gen(seed);
-    
-    // Calculate tightness factor
-    int totalDemand = 0;
-    for (int i = 2; i <= n; ++i) totalDemand += demand[i];
-    double tightness = (double)totalDemand / (vehicle * capacity);
-    
-    // Adaptive distribution based on problem size
-    // For large problems (n > 100), favor more structured methods
-    int sweepCount, randomCount, nnCount, clusterCount;
+    // Create routes from clusters with capacity constraint
+    vector<vector<int>> routes(vehicle);
     
-    if (n > 100) {
-        // Large problems: More sweep (40%) and nearest neighbor (35%), less random
-        sweepCount = (int)(populationSize * 0.40);
-        nnCount = (int)(populationSize * 0.35);
-        randomCount = (int)(populationSize * 0.15);
-        clusterCount = populationSize - sweepCount - randomCount - nnCount;
-    } else {
-        // Small-medium problems: Balanced distribution
-        sweepCount = (int)(populationSize * 0.30);
-        randomCount = (int)(populationSize * 0.25);
-        nnCount = (int)(populationSize * 0.25);
-        clusterCount = populationSize - sweepCount - randomCount - nnCount;
+    // First, assign customers to their clusters
+    for (int i = 2; i <= n; ++i) {
+        routes[assignment[i]].push_back(i);
     }
     
-    cout << " Population distribution: Sweep=" << sweepCount 
-         << ", Random=" << randomCount 
-         << ", NearestNeighbor=" << nnCount
-         << ", Cluster=" << clusterCount << endl;
-    
-    vector<vector<int>> population;
-    
-    // 1. Create sweep-based solutions with 2-opt improvement
-    for (int p = 0; p < sweepCount; ++p) {
-        // Get depot coordinates
-        pair<double, double> depotCoords = coords[depot];
-        
-        // Calculate polar angles for all customers
-        vector<pair<int, double>> customers;
-        for (int i = 2; i <= n; ++i) {
-            double angle = polarAngle(depotCoords, coords[i], true);
-            customers.emplace_back(i, angle);
-        }
-        
-        // Add randomization with different starting angles
-        uniform_real_distribution<double> angleDist(0.0, 2 * M_PI);
-        double startAngle = angleDist(gen);
-        
-        // Apply offset and normalize
-        for (auto& customer : customers) {
-            customer.second = fmod(customer.second + startAngle, 2 * M_PI);
-        }
-        
-        // Sort by angle
-        sort(customers.begin(), customers.end(), 
-             [](const auto& a, const auto& b) { return a.second < b.second; });
-        
-        // Create routes using sweep
-        vector<vector<int>> routes;
-        vector<int> currentRoute;
-        int currentLoad = 0;
-        
-        for (const auto& customer : customers) {
-    int custId = customer.first;
-    double angle = customer.second;
-    
-    if (currentLoad + demand[custId] <= capacity) {
-        currentRoute.push_back(custId);
-        currentLoad += demand[custId];
-    } else {
-        if (!currentRoute.empty()) {
-            // Apply 2-opt improvement to the route
-            currentRoute = twoOptImproveCustomers(currentRoute, dist, depot, 30);
-            routes.push_back(currentRoute);
-        }
-        currentRoute = {custId};
-        currentLoad = demand[custId];
-    }
-}
+    // Handle capacity constraints
+    vector<int> seq;
+    vector<pair<double, int>> cluster;
+    for (int k = 0; k < vehicle; ++k) {
+        // Sort customers by distance from centroid (khóa tính trước một lần)
+        cluster.clear();
+        for (int customer : routes[k]) cluster.emplace_back(squaredDist(customer, centroids[k]), customer);
+        stable_sort(cluster.begin(), cluster.end(),
+                    [](const pair<double, int>& a, const pair<double, int>& b) { return a.first < b.first; });
         
-        if (!currentRoute.empty()) {
-            currentRoute = twoOptImproveCustomers(currentRoute, dist, depot, 30);
-            routes.push_back(currentRoute);
-        }
-        
-        // Convert to sequence with separators (with size limit)
-        vector<int> seq;
-        seq.reserve(n + vehicle); // Pre-allocate memory
+        // Create feasible routes
+        int clusterLoad = 0;
+        vector<int> route;
         
-        for (size_t i = 0; i < routes.size() && seq.size() < n + vehicle - 1; ++i) {
-            for (int cust : routes[i]) {
-                if (seq.size() < n + vehicle - 1) seq.push_back(cust);
+        for (const auto& entry : cluster) {
+            int customer = entry.second;
+            if (clusterLoad + demand[customer] <= capacity) {
+                route.push_back(customer);
+                clusterLoad += demand[customer];
+            } else {
+                // This customer doesn't fit, add to next vehicle
+                if (k+1 < vehicle) {
+                    routes[k+1].push_back(customer);
+                } else {
+                    // No more vehicles, just add at the end and repair later
+                    route.push_back(customer);
+                }
             }
-            if (i < routes.size() - 1 && seq.size() < n + vehicle - 1) seq.push_back(0);
-        }
-        
-        // Limit the number of empty routes to prevent memory explosion
-        int maxEmptyRoutes = 2; // Limit empty routes
-        int emptyRoutesAdded = 0;
-        while ((int)routes.size() < vehicle && emptyRoutesAdded < maxEmptyRoutes) {
-            if (!seq.empty() && seq.back() != 0 && seq.size() < n + vehicle - 1) seq.push_back(0);
-            if (seq.size() < n + vehicle - 1) seq.push_back(0);
-            emptyRoutesAdded++;
         }
         
-        repairCustomer(seq, n, gen);
-        repairZero(seq, vehicle, gen);
-        population.push_back(seq);
-    }
-    
-    // 2. Add random solutions
-    vector<vector<int>> randomPop = initPopulationRandom(vehicle, n, capacity, demand, randomCount);
-    population.insert(population.end(), randomPop.begin(), randomPop.end());
-    
-    // 3. Add nearest neighbor solutions
-    vector<vector<int>> nnPop = initPopulationNearestNeighbor(vehicle, n, capacity, demand, coords, depot, nnCount);
-    for (auto& seq : nnPop) {
-        repairCustomer(seq, n, gen);
-        repairZero(seq, vehicle, gen);
-    }
-    population.insert(population.end(), nnPop.begin(), nnPop.end());
-    
-    // 4. Add cluster-based solutions with improvements
-    vector<vector<int>> clusterPop = initPopulationCluster(vehicle, n, capacity, demand, coords, depot, clusterCount);
-    
-    // Apply 2-opt to cluster solutions
-    for (auto& seq : clusterPop) {
-        vector<vector<int>> routes = decodeSeq(seq, depot);
-        for (auto& route : routes) {
-            if (route.size() <= 2) continue;
-            vector<int> customers(route.begin()+1, route.end()-1);
-            customers = twoOptImproveCustomers(customers, dist, depot, 30);
-            route = {depot};
-            route.insert(route.end(), customers.begin(), customers.end());
-            route.push_back(depot);
+        // Add route to sequence
+        for (int customer : route) {
+            seq.push_back(customer);
         }
         
-        // Convert back to sequence
-        seq.clear();
-        for (size_t i = 0; i < routes.size(); ++i) {
-            for (size_t j = 1; j < routes[i].size()-1; ++j) {
-                seq.push_back(routes[i][j]);
-            }
-            if (i < routes.size() - 1) seq.push_back(0);
+        if (k < vehicle - 1) {
+            seq.push_back(0); // Separator
         }
-        repairCustomer(seq, n, gen);
-        repairZero(seq, vehicle, gen);
     }
     
-    population.insert(population.end(), clusterPop.begin(), clusterPop.end());
-    cout << "Generated " << population.size() << " individuals with improved methods" << endl;
-    return population;
+    return seq;
 }
 
-// ======= REPAIR OPERATORS =======
+vector<vector<int>> initPopulationCluster(int vehicle, int n, int capacity, const vector<int>& demand, 
+                                        const vector<pair<double,double>>& coords, int depot, int populationSize,
+                                        unsigned int seed = random_device{}()) {
+    vector<vector<int>> populationSeq;
+    mt19937 gen(seed);
+    for (int p = 0; p < populationSize; ++p) {
+        populationSeq.push_back(clusterIndividual(vehicle, n, capacity, demand, coords, gen));
+    }
+    return populationSeq;
+}
+
+// ======= HYBRID INITIALIZATION =======
 
-void repairZero(vector<int>& seq, int vehicle, mt19937& gen) {
-    // Bước 1: Xóa các số 0 liền nhau
-    for (auto it = seq.begin(); it != seq.end(); ) {
-        if (*it == 0 && (it + 1) != seq.end() && *(it + 1) == 0) {
-            // Nếu số hiện tại là 0 và số tiếp theo cũng là 0, xóa số hiện tại
-            it = seq.erase(it);
+// Population khởi tạo có cấu trúc, sinh theo từng cá thể: cá thể index chỉ phụ thuộc
+// (seed, index) qua RNG riêng, nên có thể sinh song song, theo thứ tự bất kỳ hoặc
+// dần dần trong lúc GA chạy (lazy init) mà kết quả không đổi. Bảng góc polar, demand
+// lớn nhất và danh sách láng giềng của dist được dùng chung cho mọi cá thể.
+class StructuredInitializer {
+public:
+    StructuredInitializer(int populationSize, int vehicle, int n, int capacity, const vector<int>& demand,
+                          const vector<pair<double,double>>& coords, const DistMatrix& dist, int depot,
+                          int runNumber = 1, long long baseSeed = -1,
+                          double maxDistance = 0.0, double serviceTime = 0.0)
+        : populationSize(max(0, populationSize)), vehicle(vehicle), n(n), capacity(capacity), demand(demand),
+          coords(coords), dist(dist), depot(depot), maxDistance(maxDistance), serviceTime(serviceTime),
+          polar(n, coords, depot) {
+        // baseSeed >= 0: khởi tạo tái lập được (--seed), ngược lại dùng random_device
+        unsigned int base = baseSeed >= 0 ? (unsigned int)baseSeed : random_device{}();
+        seed = base + runNumber * 54321;  // Different seed for initialization
+        maxDemand = *max_element(demand.begin(), demand.end());
+        
+        // Adaptive distribution based on problem size
+        // For large problems (n > 100), favor more structured methods
+        if (n > 100) {
+            // Large problems: More sweep (40%) and nearest neighbor (35%), less random
+            sweepCount = (int)(this->populationSize * 0.40);
+            nnCount = (int)(this->populationSize * 0.35);
+            randomCount = (int)(this->populationSize * 0.15);
         } else {
-            ++it;
-        }
-    }
-    
-    // Bước 2: Xóa số 0 ở đầu chuỗi
-    while (!seq.empty() && seq.front() == 0) {
-        seq.erase(seq.begin());
-    }
-    
-    // Bước 3: Xóa số 0 ở cuối chuỗi
-    while (!seq.empty() && seq.back() == 0) {
-        seq.pop_back();
-    }
-    
-    int zeroCount = count(seq.begin(), seq.end(), 0);
-    int needZero = max(0, vehicle - 1);
-    
-    if (zeroCount == needZero) {
-        return;  // Không cần sửa
-    }
-    
-    // Trích xuất các tuyến từ chuỗi
-    vector<vector<int>> routes;
-    vector<int> currentRoute;
-    
-    for (int v : seq) {
-        if (v == 0) {
-            if (!currentRoute.empty()) {
-                routes.push_back(currentRoute);
-                currentRoute.clear();
-            }
-        } 
-        else {
-            currentRoute.push_back(v);
+            // Small-medium problems: Balanced distribution
+            sweepCount = (int)(this->populationSize * 0.30);
+            randomCount = (int)(this->populationSize * 0.25);
+            nnCount = (int)(this->populationSize * 0.25);
         }
+        clusterCount = this->populationSize - sweepCount - randomCount - nnCount;
     }
-    
-    if (!currentRoute.empty()) {
-        routes.push_back(currentRoute);
+
+    int size() const { return populationSize; }
+
+    void logDistribution() const {
+        GA_LOG(LOG_INFO) << " Population distribution: Sweep=" << sweepCount 
+             << ", Random=" << randomCount 
+             << ", NearestNeighbor=" << nnCount
+             << ", Cluster=" << clusterCount << endl;
     }
-    
-    // Trường hợp 1: Quá nhiều số 0 - xóa từ tuyến ngắn nhất
-    while (zeroCount > needZero && routes.size() > 1) {
-        // Tìm tuyến ngắn nhất
-        int shortestIdx = 0;
-        size_t minLength = routes[0].size();
-        
-        for (size_t i = 1; i < routes.size(); ++i) {
-            if (routes[i].size() < minLength) {
-                minLength = routes[i].size();
-                shortestIdx = i;
-            }
-        }
+
+    // Cá thể thứ index (0 <= index < size()): [sweep | random | nearest neighbor | cluster].
+    // fullRepair: thêm repairCustomerWithLocalSearch + repairZero như population ban đầu của runGA.
+    vector<int> build(int index, bool fullRepair = false) const {
+        // Seed riêng của cá thể: splitmix64 của (seed, index); rẻ hơn nhiều so với seed_seq
+        uint64_t z = ((uint64_t)seed << 32 | (uint32_t)index) + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        mt19937 gen((unsigned int)(z ^ (z >> 31)));
+        vector<int> seq;
         
-        // Hợp nhất tuyến ngắn nhất với tuyến tiếp theo
-        if (shortestIdx + 1 < routes.size()) {
-            routes[shortestIdx + 1].insert(routes[shortestIdx + 1].begin(), 
-                                          routes[shortestIdx].begin(), 
-                                          routes[shortestIdx].end());
-            routes.erase(routes.begin() + shortestIdx);
+        if (index < sweepCount) {
+            // 1. Sweep-based solutions with 2-opt improvement
+            seq = sweepIndividual(vehicle, n, capacity, demand, polar, dist, depot, gen);
+            repairCustomer(seq, n, gen);
+            repairZero(seq, vehicle, gen);
+        } else if (index < sweepCount + randomCount) {
+            // 2. Random solutions
+            seq = randomIndividual(vehicle, n, capacity, demand, gen);
+        } else if (index < sweepCount + randomCount + nnCount) {
+            // 3. Nearest neighbor solutions
+            seq = nearestNeighborIndividual(vehicle, n, capacity, demand, dist, depot, maxDemand, gen);
+            repairCustomer(seq, n, gen);
+            repairZero(seq, vehicle, gen);
         } else {
-            // Nếu là tuyến cuối, hợp nhất với tuyến trước đó
-            routes[shortestIdx - 1].insert(routes[shortestIdx - 1].end(), 
-                                         routes[shortestIdx].begin(), 
-                                         routes[shortestIdx].end());
-            routes.erase(routes.begin() + shortestIdx);
-        }
-        
-        zeroCount--;
-    }
-    
-    // Trường hợp 2: Quá ít số 0 - thêm vào tuyến dài nhất
-    while (zeroCount < needZero) {
-        if (routes.empty()) {
-            // Trường hợp đặc biệt: không có tuyến nào
-            routes.push_back({});
-            routes.push_back({});
-            zeroCount++;
-            continue;
-        }
-        
-        // Tìm tuyến dài nhất
-        int longestIdx = 0;
-        size_t maxLength = routes[0].size();
-        
-        for (size_t i = 1; i < routes.size(); ++i) {
-            if (routes[i].size() > maxLength) {
-                maxLength = routes[i].size();
-                longestIdx = i;
+            // 4. Cluster-based solutions, 2-opt từng route tại chỗ
+            seq = clusterIndividual(vehicle, n, capacity, demand, coords, gen);
+            for (size_t begin = 0; begin < seq.size(); ) {
+                size_t end = find(seq.begin() + begin, seq.end(), 0) - seq.begin();
+                twoOptImproveRange(seq.data() + begin, end - begin, dist, depot, 30);
+                begin = end + 1;
             }
+            repairCustomer(seq, n, gen);
+            repairZero(seq, vehicle, gen);
         }
         
-        if (maxLength <= 1) {
-            // Tất cả tuyến đều rất ngắn, thêm một tuyến trống
-            routes.push_back({});
-        } else {
-            // Chia tuyến dài nhất thành hai nửa
-            int splitPoint = routes[longestIdx].size() / 2;
-            vector<int> firstHalf(routes[longestIdx].begin(), 
-                                 routes[longestIdx].begin() + splitPoint);
-            vector<int> secondHalf(routes[longestIdx].begin() + splitPoint, 
-                                  routes[longestIdx].end());
-            
-            routes[longestIdx] = firstHalf;
-            routes.insert(routes.begin() + longestIdx + 1, secondHalf);
-        }
-        
-        zeroCount++;
-    }
-    
-    // Chuyển đổi lại sang định dạng chuỗi
-    seq.clear();
-    for (size_t i = 0; i < routes.size(); ++i) {
-        for (int v : routes[i]) {
-            seq.push_back(v);
-        }
-        if (i < routes.size() - 1) {
-            seq.push_back(0);  // Thêm dấu phân cách giữa các tuyến
+        if (fullRepair) {
+            repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+            repairZero(seq, vehicle, gen);
         }
+        return seq;
     }
-}
 
-// Optimized repairCustomer function using count tracking
-void repairCustomer(vector<int>& seq, int n, mt19937& gen) {
-    // Đếm số lần xuất hiện của mỗi customer
-    vector<int> count(n+1, 0);
-    for (int v : seq) {
-        if (v != 0 && v >= 2 && v <= n) {
-            count[v]++;
-        }
-    }
-    
-    // Tìm danh sách customers bị thiếu (count = 0)
-    vector<int> missing;
-    for (int i = 2; i <= n; ++i) {
-        if (count[i] == 0) {
-            missing.push_back(i);
-        }
-    }
-    
-    // Shuffle để randomize việc thay thế
-    shuffle(missing.begin(), missing.end(), gen);
-    int missingIdx = 0;
-    
-    // Lặp qua sequence và sửa từng vị trí
-    for (int& v : seq) {
-        if (v != 0 && v >= 2 && v <= n) {
-            if (count[v] > 1) {
-                // Customer này bị lặp
-                if (missingIdx < missing.size()) {
-                    // Thay bằng customer bị thiếu
-                    int oldCustomer = v;
-                    int newCustomer = missing[missingIdx];
-                    
-                    v = newCustomer;
-                    count[oldCustomer]--; // Giảm count của customer cũ
-                    count[newCustomer]++; // Tăng count của customer mới
-                    missingIdx++;
-                } else {
-                    // Không còn customer thiếu nào, thay bằng 0
-                    count[v]--; // Giảm count khi thay bằng 0
-                    v = 0;
-                }
-            }
-        }
-    }
-    
-    // Kiểm tra xem có customer nào còn thiếu không (count = 0)
-    for (int i = 2; i <= n; ++i) {
-        if (count[i] == 0) {
-            // Tìm route ngắn nhất để thêm customer này
-            vector<vector<int>*> routes;
-            vector<int> currentRoute;
-            
-            // Tách sequence thành các routes (dùng pointer để modify)
-            for (int& v : seq) {
-                if (v == 0) {
-                    if (!currentRoute.empty()) {
-                        routes.push_back(new vector<int>(currentRoute));
-                        currentRoute.clear();
-                    }
-                } else {
-                    currentRoute.push_back(v);
-                }
-            }
-            if (!currentRoute.empty()) {
-                routes.push_back(new vector<int>(currentRoute));
-            }
-            
-            if (routes.empty()) {
-                // Không có route nào, thêm vào cuối sequence
-                seq.push_back(i);
-            } else {
-                // Tìm route ngắn nhất
-                int shortestIdx = 0;
-                size_t minLength = routes[0]->size();
-                
-                for (size_t j = 1; j < routes.size(); ++j) {
-                    if (routes[j]->size() < minLength) {
-                        minLength = routes[j]->size();
-                        shortestIdx = j;
-                    }
-                }
-                
-                // Thêm customer vào route ngắn nhất
-                routes[shortestIdx]->push_back(i);
-                
-                // Rebuild sequence từ các routes
-                seq.clear();
-                for (size_t j = 0; j < routes.size(); ++j) {
-                    for (int customer : *routes[j]) {
-                        seq.push_back(customer);
-                    }
-                    if (j < routes.size() - 1) {
-                        seq.push_back(0);
-                    }
-                }
-            }
-            
-            // Cleanup memory
-            for (auto* route : routes) {
-                delete route;
-            }
-            
-            count[i] = 1; // Cập nhật count
-        }
-    }
+private:
+    int populationSize, vehicle, n, capacity;
+    const vector<int>& demand;
+    const vector<pair<double,double>>& coords;
+    const DistMatrix& dist;
+    int depot;
+    double maxDistance, serviceTime;
+    PolarOrder polar;
+    unsigned int seed;
+    int maxDemand;
+    int sweepCount, randomCount, nnCount, clusterCount;
+};
+
+vector<vector<int>> initStructuredPopulation(int populationSize, int vehicle, int n, int capacity, const vector<int>& demand, const vector<pair<double,double>>& coords, const DistMatrix& dist, int depot, int runNumber = 1, long long baseSeed = -1) {
+    StructuredInitializer initializer(populationSize, vehicle, n, capacity, demand, coords, dist, depot, runNumber, baseSeed);
+    initializer.logDistribution();
     
-    // Kiểm tra cuối cùng: nếu vẫn còn customer nào có count > 1, thay bằng 0
-    bool hasError = true;
-    while (hasError) {
-        hasError = false;
-        for (int& v : seq) {
-            if (v != 0 && v >= 2 && v <= n && count[v] > 1) {
-                count[v]--; // Giảm count
-                v = 0;      // Thay bằng 0
-                hasError = true;
-                break; // Chỉ thay 1 lần mỗi vòng lặp
-            }
-        }
-    }
+    vector<vector<int>> population;
+    population.reserve(initializer.size());
+    for (int i = 0; i < initializer.size(); ++i) population.push_back(initializer.build(i));
+    GA_LOG(LOG_INFO) << "Generated " << population.size() << " individuals with improved methods" << endl;
+    return population;
 }
+
+// ======= REPAIR OPERATORS =======
+
 void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
-                                 const vector<vector<double>>& dist, 
+                                 const DistMatrix& dist, 
                                  const vector<int>& demand, int capacity, int depot,
                                  double maxDistance = 0.0, double serviceTime = 0.0, int maxVehicles = -1) {
+    ScopedPhase phase(PHASE_REPAIR);
+    
     // Bước 1: Sử dụng hàm repairCustomer để sửa duplicate và missing customers
     repairCustomer(seq, n, gen);
     
-    // Bước 2: Decode thành routes và kiểm tra time violations
-    vector<vector<int>> routes = decodeSeq(seq, depot);
+    // Bước 2: Decode thành routes và kiểm tra time violations (vào bộ đệm của thread)
+    RepairScratch& scratch = repairScratch();
+    decodeSeqInto(seq, depot, scratch);
+    vector<vector<int>>& routes = scratch.routes;
+    size_t routeCount = scratch.routeCount;
     
     // Bước 3: Aggressive repair cho time constraints
     if (maxDistance > 0.0) {
         bool hasTimeViolation = true;
         int maxIterations = 10; // Tăng số iterations
         
+        // Granular insertion: vị trí (route, index) của từng customer để chỉ thử chèn
+        // cạnh các láng giềng gần nhất; tải và thời gian mỗi route được cache.
+        vector<int>& routeOfNode = scratch.routeOfNode;
+        vector<int>& posOfNode = scratch.posOfNode;
+        vector<int>& routeLoads = scratch.routeLoads;
+        vector<double>& routeTimes = scratch.routeTimes;
+        routeOfNode.assign(dist.size(), -1);
+        posOfNode.assign(dist.size(), -1);
+        routeLoads.assign(routeCount, 0);
+        routeTimes.assign(routeCount, 0.0);
+        auto indexRoute = [&](size_t r) {
+            for (size_t k = 1; k + 1 < routes[r].size(); ++k) {
+                routeOfNode[routes[r][k]] = r;
+                posOfNode[routes[r][k]] = k;
+            }
+        };
+        for (size_t r = 0; r < routeCount; ++r) {
+            indexRoute(r);
+            routeLoads[r] = routeDemand(routes[r], demand);
+        }
+        
         for (int iter = 0; iter < maxIterations && hasTimeViolation; iter++) {
             hasTimeViolation = false;
             
@@ -1254,8 +1099,9 @@ void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
             int worstRouteIdx = -1;
             double maxViolation = 0.0;
             
-            for (size_t i = 0; i < routes.size(); ++i) {
+            for (size_t i = 0; i < routeCount; ++i) {
                 double routeTime = calculateRouteTime(routes[i], dist, serviceTime);
+                routeTimes[i] = routeTime;
                 if (routeTime > maxDistance) {
                     double violation = routeTime - maxDistance;
                     if (violation > maxViolation) {
@@ -1285,23 +1131,39 @@ void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
                 double bestPriority = numeric_limits<double>::max();
                 int bestPosition = -1;
                 
-                for (size_t j = 0; j < routes.size(); ++j) {
-                    if (j == worstRouteIdx) continue; // Bỏ qua route hiện tại
+                // Chỉ thử chèn ngay trước/sau các láng giềng gần nhất, O(K) thay vì O(n)
+                const int* nb = dist.neighbors(customerToMove);
+                for (int t = 0; t < dist.neighborCount(); ++t) {
+                    int c = nb[t];
+                    int j = (c == depot) ? -1 : routeOfNode[c];
+                    if (j < 0 || j == worstRouteIdx) continue;
+                    if (routeLoads[j] + customerDemand > capacity) continue;
                     
-                    // Tính current load
-                    int routeLoad = 0;
-                    for (size_t k = 1; k < routes[j].size() - 1; k++) {
-                        routeLoad += demand[routes[j][k]];
+                    for (int insertAt = posOfNode[c]; insertAt <= posOfNode[c] + 1; ++insertAt) {
+                        int prev = routes[j][insertAt - 1], next = routes[j][insertAt];
+                        double increase = dist[prev][customerToMove] + dist[customerToMove][next] - dist[prev][next];
+                        if (routeTimes[j] + increase + serviceTime > maxDistance) continue;
+                        
+                        double priority = (double)routeLoads[j] / capacity + (increase / 100.0);
+                        if (priority < bestPriority) {
+                            bestPriority = priority;
+                            bestTargetRoute = j;
+                            bestPosition = insertAt;
+                        }
                     }
+                }
+                
+                // Không có láng giềng nào nhận được: quét toàn bộ các route như trước
+                for (size_t j = 0; j < routeCount && bestTargetRoute == -1; ++j) {
+                    if (j == worstRouteIdx) continue; // Bỏ qua route hiện tại
+                    
+                    int routeLoad = routeLoads[j];
                     
                     // Kiểm tra capacity
                     if (routeLoad + customerDemand <= capacity) {
                         // Kiểm tra time constraint sau khi thêm
                         auto insertInfo = findBestInsertPosition(routes[j], customerToMove, dist, depot);
-                        vector<int> tempRoute = routes[j];
-                        tempRoute.insert(tempRoute.begin() + insertInfo.first, customerToMove);
-                        
-                        double newRouteTime = calculateRouteTime(tempRoute, dist, serviceTime);
+                        double newRouteTime = routeTimes[j] + insertInfo.second + serviceTime;
                         if (newRouteTime <= maxDistance) {
                             // Priority = load% + distance_increase/100 (ưu tiên route ít tải và distance increase thấp)
                             double loadRatio = (double)routeLoad / capacity;
@@ -1320,6 +1182,10 @@ void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
                 if (bestTargetRoute != -1) {
                     worstRoute.erase(worstRoute.end() - 2); // Xóa customer
                     routes[bestTargetRoute].insert(routes[bestTargetRoute].begin() + bestPosition, customerToMove);
+                    routeLoads[worstRouteIdx] -= customerDemand;
+                    routeLoads[bestTargetRoute] += customerDemand;
+                    routeTimes[bestTargetRoute] = calculateRouteTime(routes[bestTargetRoute], dist, serviceTime);
+                    indexRoute(bestTargetRoute);
                     
                     // Kiểm tra xem route đã được sửa chưa
                     double newWorstRouteTime = calculateRouteTime(worstRoute, dist, serviceTime);
@@ -1329,78 +1195,434 @@ void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
                 }
             }
             
-            // Strategy 2: DISABLED - Không split route để giữ nguyên số vehicles
-            // (Chỉ di chuyển customers giữa các routes hiện có)
+            // Strategy 2, 3: chỉ bật ở bản fork gatest/ (CVRP_REPAIR_SPLIT_ROUTES). Bản chính
+            // không split route / tạo route đơn để giữ nguyên số vehicles.
+#ifdef CVRP_REPAIR_SPLIT_ROUTES
+            // Thời gian của depot -> route[from..to) -> depot
+            auto pathTime = [&](const vector<int>& route, size_t from, size_t to) {
+                double time = 0.0;
+                int prev = depot;
+                for (size_t k = from; k < to; ++k) {
+                    time += dist[prev][route[k]];
+                    prev = route[k];
+                }
+                return time + dist[prev][depot] + (to - from) * serviceTime;
+            };
+            // Tuyến mới nối vào scratch.routes (có thể cấp phát lại routes: lấy lại tham chiếu)
+            auto addRoute = [&]() -> vector<int>& {
+                if (routeCount == routes.size()) routes.emplace_back();
+                vector<int>& route = routes[routeCount++];
+                route.assign(1, depot);
+                routeLoads.push_back(0);
+                routeTimes.push_back(0.0);
+                return route;
+            };
+            
+            // Strategy 2: split route tại điểm giữa nếu cả hai nửa thỏa maxDistance
+            if (!routeFixed && worstRoute.size() > 5) {
+                size_t midPoint = worstRoute.size() / 2;
+                if (pathTime(worstRoute, 1, midPoint) <= maxDistance &&
+                    pathTime(worstRoute, midPoint, worstRoute.size() - 1) <= maxDistance) {
+                    vector<int>& newRoute = addRoute();
+                    vector<int>& oldRoute = routes[worstRouteIdx];
+                    newRoute.insert(newRoute.end(), oldRoute.begin() + midPoint, oldRoute.end());
+                    oldRoute.erase(oldRoute.begin() + midPoint, oldRoute.end() - 1);
+                    routeLoads[worstRouteIdx] = routeDemand(oldRoute, demand);
+                    routeLoads[routeCount - 1] = routeDemand(newRoute, demand);
+                    indexRoute(worstRouteIdx);
+                    indexRoute(routeCount - 1);
+                    routeFixed = true;
+                }
+            }
             
-            // Strategy 3: DISABLED - Không tạo routes đơn để giữ nguyên số vehicles  
-            // (Chỉ di chuyển customers giữa các routes hiện có)
+            // Strategy 3: tạo route đơn cho customer có demand cao nhất của route
+            if (!routeFixed && worstRoute.size() > 3) {
+                size_t maxDemandPos = 0;
+                int maxDemand = 0;
+                for (size_t k = 1; k + 1 < worstRoute.size(); ++k) {
+                    if (demand[worstRoute[k]] > maxDemand) {
+                        maxDemand = demand[worstRoute[k]];
+                        maxDemandPos = k;
+                    }
+                }
+                if (maxDemandPos > 0 && pathTime(worstRoute, maxDemandPos, maxDemandPos + 1) <= maxDistance) {
+                    int customer = worstRoute[maxDemandPos];
+                    worstRoute.erase(worstRoute.begin() + maxDemandPos);
+                    routeLoads[worstRouteIdx] -= maxDemand;
+                    indexRoute(worstRouteIdx);
+                    vector<int>& single = addRoute();
+                    single.push_back(customer);
+                    single.push_back(depot);
+                    routeLoads[routeCount - 1] = maxDemand;
+                    indexRoute(routeCount - 1);
+                    routeFixed = true;
+                }
+            }
+#endif
         }
     }
     
-    // Bước 4: Áp dụng 2-opt local search cho từng route
-    for (auto& route : routes) {
+    // Bước 4: Áp dụng 2-opt local search cho từng route (tại chỗ, bỏ depot đầu và cuối)
+    for (size_t r = 0; r < routeCount; ++r) {
+        vector<int>& route = routes[r];
         if (route.size() <= 3) continue; // Bỏ qua route quá ngắn
-        
-        // Trích xuất customers từ route (bỏ depot đầu và cuối)
-        vector<int> customers;
-        for (size_t i = 1; i < route.size() - 1; ++i) {
-            customers.push_back(route[i]);
-        }
-        
-        // Áp dụng 2-opt improvement
-        customers = twoOptImproveCustomers(customers, dist, depot, 50);
-        
-        // Cập nhật lại route với customers đã được cải thiện
-        route = {depot};
-        route.insert(route.end(), customers.begin(), customers.end());
-        route.push_back(depot);
+        twoOptImproveRange(route.data() + 1, route.size() - 2, dist, depot, 50);
     }
     
     // Bước 5: Chuyển đổi lại thành sequence format
     seq.clear();
-    for (size_t i = 0; i < routes.size(); ++i) {
+    for (size_t i = 0; i < routeCount; ++i) {
         // Thêm customers từ route (bỏ depot đầu và cuối)
-        for (size_t j = 1; j < routes[i].size() - 1; ++j) {
-            seq.push_back(routes[i][j]);
-        }
+        seq.insert(seq.end(), routes[i].begin() + 1, routes[i].end() - 1);
         // Thêm separator giữa các routes (trừ route cuối)
-        if (i < routes.size() - 1) {
+        if (i < routeCount - 1) {
             seq.push_back(0);
         }
     }
 }
 
-// ======= CROSSOVER OPERATORS (3) =======
+// ======= SPLIT DECODER =======
 
-// Helper for sequence conversion
-// vector<int> convertToSequenceFormat(const vector<int>& customers, int vehicle, const vector<int>& demand, int capacity, mt19937& gen) {
-//     vector<int> seq;
-//     vector<vector<int>> routes;
-//     vector<int> currentRoute;
-//     int currentLoad = 0;
-    
-//     for (int customer : customers) {
-//         if (currentLoad + demand[customer] <= capacity) {
-//             currentRoute.push_back(customer);
-//             currentLoad += demand[customer];
-//         } else {
-//             if (!currentRoute.empty()) routes.push_back(currentRoute);
-//             currentRoute = {customer};
-//             currentLoad = demand[customer];
-//         }
-//     }
-    
-//     if (!currentRoute.empty()) routes.push_back(currentRoute);
-    
-//     // Ensure we don't exceed vehicle count
-//     while (routes.size() > (size_t)vehicle) {
-//         vector<int> lastRoute = routes.back();
-//         routes.pop_back();
-//         bool merged = false;
+// Prins Split: bỏ separator, coi customers là một giant tour và chia lại thành các tuyến
+// thỏa capacity và maxDistance với tổng cost nhỏ nhất (giữ nguyên thứ tự customers).
+// Mỗi tầng Bellman là một lượt tuyến tính (Vidal 2016): với prefix sum của khoảng cách
+// và demand, cost tuyến (i, t] = d(depot, c[i+1]) - D[i+1] + D[t] + d(c[t], depot), nên chỉ
+// cần deque các điểm cắt i có potential p[i] + d(depot, c[i+1]) - D[i+1] tăng dần. Nhờ bất
+// đẳng thức tam giác, (i, t] không khả thi thì (i, t'] với t' > t và (i', t] với i' < i cũng
+// không: điểm cắt bị loại khỏi đầu deque không bao giờ cần lại.
+struct SplitScratch {
+    vector<int> customers;
+    vector<double> distPrefix;   // distPrefix[k] = tổng d(c[t], c[t+1]), t = 1..k-1
+    vector<int> loadPrefix;      // loadPrefix[k] = demand c[1..k]
+    vector<double> fromDepot, toDepot;
+    vector<double> cost, previous;
+    vector<int> pred;            // pred[level * (m + 1) + t]: điểm cắt, -1 = ít tuyến hơn
+    vector<int> window;          // deque các điểm cắt
+    vector<int> reach, reachBack; // chia tham lam từ đầu / từ cuối (giới hạn số xe)
+    int capacity = 0;
+    double timeLimit = 0.0;      // <= 0: không giới hạn thời gian tuyến
+    double serviceTime = 0.0;
+
+    bool feasible(int i, int t) const {
+        if (loadPrefix[t] - loadPrefix[i] > capacity) return false;
+        if (timeLimit <= 0.0) return true;
+        double routeTime = fromDepot[i + 1] + distPrefix[t] - distPrefix[i + 1] + toDepot[t] + serviceTime * (t - i);
+        return routeTime <= timeLimit;
+    }
+};
+
+inline SplitScratch& splitScratch() {
+    static thread_local SplitScratch scratch;
+    return scratch;
+}
+
+// Một tầng Bellman: next[t] = min(fewer[t], min_i fewer[i] + cost(i, t)) với t thuộc
+// (first, last] và các điểm cắt khả thi i thuộc [first, t).
+// fewer == next: Split không giới hạn số xe (next[i] với i < t đã có khi xét t).
+void splitLevel(SplitScratch& sc, const vector<double>& fewer, vector<double>& next, int* pred,
+                int first, int last) {
+    const double INF = numeric_limits<double>::infinity();
+    const vector<double>& D = sc.distPrefix;
+    vector<int>& window = sc.window;
+    window.resize(last + 1);
+    int head = 0, tail = 0;
+    bool sameLevel = &fewer == &next;
+    auto potential = [&](int i) { return fewer[i] + sc.fromDepot[i + 1] - D[i + 1]; };
+    
+    for (int t = first + 1; t <= last; ++t) {
+        int cut = t - 1;
+        if (fewer[cut] < INF) {
+            double p = potential(cut);
+            while (tail > head && potential(window[tail - 1]) >= p) tail--;
+            window[tail++] = cut;
+        }
+        while (tail > head && !sc.feasible(window[head], t)) head++;
         
-//         for (auto& route : routes) {
-//             int routeLoad = 0;
-//             for (int c : route) routeLoad += demand[c];
+        double best = sameLevel ? INF : fewer[t];
+        pred[t] = -1;
+        if (tail > head) {
+            int i = window[head];
+            double value = potential(i) + D[t] + sc.toDepot[t];
+            if (value < best) {
+                best = value;
+                pred[t] = i;
+            }
+        }
+        next[t] = best;
+    }
+}
+
+// Chia lại seq tại chỗ thành tối đa maxRoutes tuyến khả thi (maxRoutes <= 0: không giới
+// hạn) với cost nhỏ nhất theo dist. Trả về false và giữ nguyên seq khi không có cách chia
+// khả thi (customer vượt capacity / maxDistance một mình, hoặc không đủ xe).
+// Không giới hạn số xe: O(m). Cách chia tối ưu cần quá maxRoutes tuyến: tầng k của Bellman
+// (tối đa k tuyến) chỉ xét các t mà k tuyến chia tham lam từ đầu còn tới được và
+// maxRoutes - k tuyến từ cuối còn phủ nổi phần còn lại, nên khi số xe sát số tuyến tối
+// thiểu (thường gặp) chi phí vẫn gần O(m).
+bool splitTour(vector<int>& seq, int maxRoutes, const vector<int>& demand, int capacity, int depot,
+               const DistMatrix& dist, double maxDistance = 0.0, double serviceTime = 0.0) {
+    SplitScratch& sc = splitScratch();
+    vector<int>& c = sc.customers;
+    c.clear();
+    c.push_back(depot); // c[0] không dùng, customers đánh số 1..m
+    for (int v : seq) if (v != 0) c.push_back(v);
+    int m = c.size() - 1;
+    if (m == 0) return false;
+    
+    sc.distPrefix.resize(m + 1);
+    sc.loadPrefix.resize(m + 1);
+    sc.fromDepot.resize(m + 1);
+    sc.toDepot.resize(m + 1);
+    sc.loadPrefix[0] = 0;
+    sc.distPrefix[0] = sc.distPrefix[1] = 0.0;
+    for (int k = 1; k <= m; ++k) {
+        sc.loadPrefix[k] = sc.loadPrefix[k - 1] + demand[c[k]];
+        if (k > 1) sc.distPrefix[k] = sc.distPrefix[k - 1] + dist[c[k - 1]][c[k]];
+        sc.fromDepot[k] = dist[depot][c[k]];
+        sc.toDepot[k] = dist[c[k]][depot];
+    }
+    sc.capacity = capacity;
+    sc.serviceTime = serviceTime;
+    // Cost qua prefix sum lệch vài ulp so với cộng dồn của calculateFitness: chừa một
+    // khoảng nhỏ để tuyến sát giới hạn không bị validateCapacity coi là vi phạm
+    sc.timeLimit = maxDistance > 0.0 ? maxDistance - 1e-9 * max(1.0, maxDistance) : 0.0;
+    
+    const double INF = numeric_limits<double>::infinity();
+    vector<int>& pred = sc.pred;
+    
+    // Không giới hạn số xe
+    sc.cost.assign(m + 1, INF);
+    sc.cost[0] = 0.0;
+    pred.resize(m + 1);
+    splitLevel(sc, sc.cost, sc.cost, pred.data(), 0, m);
+    if (sc.cost[m] == INF) return false;
+    int routes = 0;
+    for (int t = m; t > 0; t = pred[t]) routes++;
+    
+    int levels = 0;
+    if (maxRoutes > 0 && routes > maxRoutes) {
+        // Số tuyến tối thiểu: chia tham lam (mọi customer đã khả thi một mình)
+        vector<int>& reach = sc.reach;
+        reach.assign(maxRoutes + 1, m);
+        reach[0] = 0;
+        int t = 0, used = 0;
+        while (t < m && used < maxRoutes) {
+            int end = t + 1;
+            while (end < m && sc.feasible(t, end + 1)) end++;
+            reach[++used] = t = end;
+        }
+        if (t < m) return false;
+        vector<int>& reachBack = sc.reachBack;
+        reachBack.assign(maxRoutes + 1, 0);
+        reachBack[0] = m;
+        t = m;
+        for (int r = 1; r <= maxRoutes && t > 0; ++r) {
+            int start = t - 1;
+            while (start > 0 && sc.feasible(start - 1, t)) start--;
+            reachBack[r] = t = start;
+        }
+        
+        // Bellman theo số tuyến, tầng k = tối đa k tuyến
+        levels = maxRoutes;
+        pred.resize((size_t)(levels + 1) * (m + 1));
+        sc.previous.assign(m + 1, INF);
+        sc.previous[0] = 0.0;
+        for (int k = 1; k <= levels; ++k) {
+            sc.cost.assign(m + 1, INF);
+            sc.cost[0] = 0.0;
+            splitLevel(sc, sc.previous, sc.cost, pred.data() + (size_t)k * (m + 1),
+                       reachBack[levels - k + 1], reach[k]);
+            swap(sc.previous, sc.cost);
+        }
+        if (sc.previous[m] == INF) return false;
+    }
+    
+    // Ghi lại từ cuối: customers của tuyến cuối trước, đảo ngược một lần
+    vector<int>& out = sc.window;
+    out.clear();
+    int t = m, level = levels;
+    while (t > 0) {
+        int i = levels > 0 ? pred[(size_t)level * (m + 1) + t] : pred[t];
+        if (i < 0) { // tầng này dùng ít tuyến hơn
+            level--;
+            continue;
+        }
+        if (!out.empty()) out.push_back(0);
+        for (int k = t; k > i; --k) out.push_back(c[k]);
+        t = i;
+        level--;
+    }
+    seq.assign(out.rbegin(), out.rend());
+    return true;
+}
+
+// ======= ADAPTIVE OPERATOR SELECTION =======
+
+// Operator chọn trong reproduceParents (crossover) và mutate (mutation)
+enum CrossoverOp { CROSSOVER_ONE_POINT, CROSSOVER_OX, CROSSOVER_PMX, CROSSOVER_SREX, CROSSOVER_COUNT };
+enum MutationOp {
+    MUTATION_SWAP, MUTATION_INVERSION, MUTATION_INSERTION, MUTATION_OR_OPT,
+    MUTATION_SCRAMBLE, MUTATION_ROUTE_EXCHANGE, MUTATION_COUNT
+};
+
+const char* const CROSSOVER_NAMES[CROSSOVER_COUNT] = {"one_point", "ox", "pmx", "srex"};
+const char* const MUTATION_NAMES[MUTATION_COUNT] = {
+    "swap", "inversion", "insertion", "or_opt", "scramble", "route_exchange"
+};
+
+// Xác suất cố định, và xác suất ban đầu khi bật --adaptive-operators
+const double CROSSOVER_WEIGHTS[CROSSOVER_COUNT] = {0.25, 0.25, 0.25, 0.25};
+const double MUTATION_WEIGHTS[MUTATION_COUNT] = {0.25, 0.20, 0.15, 0.15, 0.15, 0.10};
+
+// Chọn operator theo xác suất tích lũy với u trong [0, 1)
+inline int pickOperator(const double* probability, int count, double u) {
+    double edge = 0.0;
+    for (int k = 0; k + 1 < count; ++k) {
+        edge += probability[k];
+        if (u < edge) return k;
+    }
+    return count - 1;
+}
+
+// Một operator trong một generation: số lần dùng, tổng cải thiện fitness (chỉ phần dương)
+// và thời gian CPU (µs, gồm repair mà operator kéo theo)
+struct OperatorUsage {
+    long long uses = 0;
+    double gain = 0.0;
+    double us = 0.0;
+    
+    void add(double improvement, double micros) {
+        uses++;
+        gain += max(0.0, improvement);
+        us += micros;
+    }
+    double gainPerUs() const { return us > 0 ? gain / us : 0.0; }
+};
+
+// Adaptive pursuit (Thierens 2005): quality = trung bình trượt (alpha) của gain / µs mỗi
+// generation; xác suất của operator có quality cao nhất tiến về pMax, các operator khác
+// về pMin (beta mỗi generation), nên không operator nào bị loại hẳn.
+class OperatorPursuit {
+public:
+    OperatorPursuit(const double* weights, int count, double alpha = 0.3, double beta = 0.2)
+        : probability_(weights, weights + count), quality_(count, 0.0),
+          pMin_(0.5 / count), pMax_(1.0 - (count - 1) * 0.5 / count), alpha_(alpha), beta_(beta) {}
+    
+    int size() const { return probability_.size(); }
+    double probability(int k) const { return probability_[k]; }
+    double quality(int k) const { return quality_[k]; }
+    int pick(double u) const { return pickOperator(probability_.data(), size(), u); }
+    
+    void update(const OperatorUsage* usage) {
+        for (int k = 0; k < size(); ++k) {
+            if (usage[k].uses > 0) quality_[k] += alpha_ * (usage[k].gainPerUs() - quality_[k]);
+        }
+        int best = max_element(quality_.begin(), quality_.end()) - quality_.begin();
+        if (quality_[best] <= 0.0) return; // chưa operator nào cải thiện được
+        for (int k = 0; k < size(); ++k) {
+            double target = k == best ? pMax_ : pMin_;
+            probability_[k] += beta_ * (target - probability_[k]);
+        }
+    }
+    
+private:
+    vector<double> probability_, quality_;
+    double pMin_, pMax_, alpha_, beta_;
+};
+
+// Thống kê của một worker trong generation hiện tại (mỗi worker ghi bản của mình)
+struct alignas(64) OperatorStats {
+    OperatorUsage crossover[CROSSOVER_COUNT];
+    OperatorUsage mutation[MUTATION_COUNT];
+    
+    OperatorStats& operator+=(const OperatorStats& other) {
+        auto merge = [](OperatorUsage& into, const OperatorUsage& from) {
+            into.uses += from.uses;
+            into.gain += from.gain;
+            into.us += from.us;
+        };
+        for (int k = 0; k < CROSSOVER_COUNT; ++k) merge(crossover[k], other.crossover[k]);
+        for (int k = 0; k < MUTATION_COUNT; ++k) merge(mutation[k], other.mutation[k]);
+        return *this;
+    }
+};
+
+// Chọn crossover / mutation theo gain mỗi µs thay cho xác suất cố định (--adaptive-operators).
+// Xác suất giữ nguyên trong một generation; endGeneration() gộp thống kê của các worker
+// rồi mới cập nhật, nên thứ tự giữa các thread không ảnh hưởng. Reward dựa trên thời gian
+// đo được nên run không còn lặp lại đúng từng bit với cùng seed.
+class AdaptiveOperators {
+public:
+    explicit AdaptiveOperators(int workers)
+        : crossover_(CROSSOVER_WEIGHTS, CROSSOVER_COUNT), mutation_(MUTATION_WEIGHTS, MUTATION_COUNT),
+          stats_(max(1, workers)) {}
+    
+    const OperatorPursuit& crossover() const { return crossover_; }
+    const OperatorPursuit& mutation() const { return mutation_; }
+    OperatorStats& stats(int worker) { return stats_[worker]; }
+    
+    void endGeneration() {
+        last_ = OperatorStats();
+        for (OperatorStats& stats : stats_) {
+            last_ += stats;
+            stats = OperatorStats();
+        }
+        total_ += last_;
+        // Trace ghi xác suất đã dùng trong generation vừa xong
+        for (int k = 0; k < CROSSOVER_COUNT; ++k) lastProbability_[k] = crossover_.probability(k);
+        for (int k = 0; k < MUTATION_COUNT; ++k) lastProbability_[CROSSOVER_COUNT + k] = mutation_.probability(k);
+        crossover_.update(last_.crossover);
+        mutation_.update(last_.mutation);
+    }
+    
+    const OperatorStats& last() const { return last_; }
+    const OperatorStats& total() const { return total_; }
+    // Xác suất của generation vừa xong: crossover rồi mutation, theo thứ tự enum
+    const double* lastProbabilities() const { return lastProbability_; }
+    
+private:
+    OperatorPursuit crossover_, mutation_;
+    vector<OperatorStats> stats_;
+    OperatorStats last_, total_;
+    double lastProbability_[CROSSOVER_COUNT + MUTATION_COUNT] = {};
+};
+
+// Thời gian (µs) từ start tới hiện tại
+inline double microsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+// ======= CROSSOVER OPERATORS (4) =======
+
+// Helper for sequence conversion
+// vector<int> convertToSequenceFormat(const vector<int>& customers, int vehicle, const vector<int>& demand, int capacity, mt19937& gen) {
+//     vector<int> seq;
+//     vector<vector<int>> routes;
+//     vector<int> currentRoute;
+//     int currentLoad = 0;
+    
+//     for (int customer : customers) {
+//         if (currentLoad + demand[customer] <= capacity) {
+//             currentRoute.push_back(customer);
+//             currentLoad += demand[customer];
+//         } else {
+//             if (!currentRoute.empty()) routes.push_back(currentRoute);
+//             currentRoute = {customer};
+//             currentLoad = demand[customer];
+//         }
+//     }
+    
+//     if (!currentRoute.empty()) routes.push_back(currentRoute);
+    
+//     // Ensure we don't exceed vehicle count
+//     while (routes.size() > (size_t)vehicle) {
+//         vector<int> lastRoute = routes.back();
+//         routes.pop_back();
+//         bool merged = false;
+        
+//         for (auto& route : routes) {
+//             int routeLoad = 0;
+//             for (int c : route) routeLoad += demand[c];
             
 //             int lastRouteLoad = 0;
 //             for (int c : lastRoute) lastRouteLoad += demand[c];
@@ -1427,57 +1649,156 @@ void repairCustomerWithLocalSearch(vector<int>& seq, int n, mt19937& gen,
 //     return seq;
 // }
 
-// 1. One-Point Crossover
-pair<vector<int>, vector<int>> crossoverOnePoint(const vector<int>& parent1, const vector<int>& parent2, 
-                                              int n, int vehicle, const vector<int>& demand, 
-                                              int capacity, int depot, mt19937& gen,
-                                              const vector<vector<double>>& dist,
-                                              double maxDistance = 0.0, double serviceTime = 0.0) {
+// Tập đánh dấu theo "thế hệ": mark() ghi stamp hiện tại, next() mở thế hệ mới trong O(1)
+// thay vì xóa cả mảng (mảng chỉ được xóa khi bộ đếm 32 bit quay vòng).
+struct StampSet {
+    vector<uint32_t> stamp;
+    uint32_t current = 0;
+    
+    void next(size_t size) {
+        if (stamp.size() < size) stamp.resize(size, 0);
+        if (++current == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            current = 1;
+        }
+    }
+    bool test(int v) const { return stamp[v] == current; }
+    void mark(int v) { stamp[v] = current; }
+};
+
+// Bộ đệm của các crossover, mỗi thread một bộ (crossoverScratch()); con được ghi thẳng
+// vào child1/child2 của caller nên khi các bộ đệm đã đủ lớn crossover không cấp phát.
+struct CrossoverScratch {
+    vector<int> customers1, customers2;  // cha mẹ bỏ số 0
+    vector<int> offspring1, offspring2;  // customers của con trước khi chèn số 0
+    vector<int> positions1, positions2;  // vị trí chèn số 0
+    StampSet used1, used2;               // customer đã có trong con
+    vector<int> map1to2, map2to1;        // PMX: ánh xạ của đoạn giữa, hợp lệ khi mapped*.test(v)
+    StampSet mapped1, mapped2;
+    
+    // SREX: tuyến của cha mẹ dạng phẳng (nodes + offset bắt đầu mỗi tuyến, bỏ tuyến rỗng)
+    vector<int> nodesA, startA, nodesB, startB;
+    vector<int> overlap, order, missing;
+    StampSet fromB, removedA, inChild;
+    vector<vector<int>> routes;          // tuyến của con (không có depot), routes[0..routeCount)
+    size_t routeCount = 0;
+    vector<int> loads, routeOf, posOf;
+};
+
+inline CrossoverScratch& crossoverScratch() {
+    static thread_local CrossoverScratch scratch;
+    return scratch;
+}
+
+void extractCustomers(const vector<int>& seq, vector<int>& customers) {
+    customers.clear();
+    for (int v : seq) if (v != 0) customers.push_back(v);
+}
+
+// Vị trí chèn zeros số 0 cho hai con (rút xen kẽ từ gen), sắp tăng dần
+void drawSeparatorPositions(size_t length1, size_t length2, int zeros, mt19937& gen,
+                            vector<int>& positions1, vector<int>& positions2) {
+    positions1.clear();
+    positions2.clear();
+    uniform_int_distribution<> posDis1(0, length1);
+    uniform_int_distribution<> posDis2(0, length2);
+    for (int i = 0; i < zeros; ++i) {
+        positions1.push_back(posDis1(gen));
+        positions2.push_back(posDis2(gen));
+    }
+    sort(positions1.begin(), positions1.end());
+    sort(positions2.begin(), positions2.end());
+}
+
+// out = customers với một số 0 chèn trước phần tử thứ p cho mỗi p trong positions (một lượt,
+// cùng kết quả với chèn lần lượt từ phải sang trái)
+void mergeSeparators(const vector<int>& customers, const vector<int>& positions, vector<int>& out) {
+    out.clear();
+    size_t next = 0;
+    for (size_t i = 0; i <= customers.size(); ++i) {
+        while (next < positions.size() && positions[next] == (int)i) {
+            out.push_back(0);
+            next++;
+        }
+        if (i < customers.size()) out.push_back(customers[i]);
+    }
+}
+
+// 1. One-Point Crossover: đầu của một cha (cả số 0) + đuôi của cha kia; customer ở đuôi đã có
+// trong phần đầu được thay tại chỗ bằng customer bị thiếu (phần đầu của cha kia, theo thứ
+// tự), nên con luôn là hoán vị hợp lệ và chỉ số separator cần repairZero.
+void crossoverOnePoint(const vector<int>& parent1, const vector<int>& parent2,
+                       vector<int>& child1, vector<int>& child2,
+                       int n, int vehicle, const vector<int>& demand,
+                       int capacity, int depot, mt19937& gen,
+                       const DistMatrix& dist,
+                       double maxDistance = 0.0, double serviceTime = 0.0) {
     int len1 = parent1.size();
     int len2 = parent2.size();
     int len = min(len1, len2);
     
     if (len < 2) {
-        return {parent1, parent2}; // Can't crossover, return parents
+        child1 = parent1; // Can't crossover, return parents
+        child2 = parent2;
+        return;
     }
     
     uniform_int_distribution<> dis(1, len - 1);
     int cut = dis(gen);
     
-    vector<int> child1, child2;
-    
-    child1.insert(child1.end(), parent1.begin(), parent1.begin() + cut);
-    child1.insert(child1.end(), parent2.begin() + cut, parent2.end());
-    
-    child2.insert(child2.end(), parent2.begin(), parent2.begin() + cut);
-    child2.insert(child2.end(), parent1.begin() + cut, parent1.end());
+    CrossoverScratch& scratch = crossoverScratch();
+    auto build = [&](const vector<int>& head, const vector<int>& tail, StampSet& used, vector<int>& child) {
+        auto valid = [&](int v) { return v > 0 && v <= n; };
+        used.next(n + 1);
+        child.assign(head.begin(), head.begin() + cut);
+        for (int v : child) if (valid(v)) used.mark(v);
+        vector<int>& missing = scratch.offspring1;
+        missing.clear();
+        for (int i = 0; i < cut; ++i) {
+            if (valid(tail[i]) && !used.test(tail[i])) missing.push_back(tail[i]);
+        }
+        size_t next = 0;
+        for (int i = cut; i < (int)tail.size(); ++i) {
+            int v = tail[i];
+            if (valid(v) && used.test(v)) {
+                if (next == missing.size()) continue;
+                v = missing[next++];
+            }
+            if (valid(v)) used.mark(v);
+            child.push_back(v);
+        }
+        for (; next < missing.size(); ++next) {
+            if (!used.test(missing[next])) child.push_back(missing[next]);
+        }
+    };
+    build(parent1, parent2, scratch.used1, child1);
+    build(parent2, parent1, scratch.used2, child2);
 
     repairCustomerWithLocalSearch(child1, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
     repairZero(child1, vehicle, gen);
 
     repairCustomerWithLocalSearch(child2, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
     repairZero(child2, vehicle, gen);
-
-    return {child1, child2};
 }
 
 // 2. Order Crossover (OX)
-pair<vector<int>, vector<int>> crossoverOX(const vector<int>& parent1, const vector<int>& parent2, 
-                                        int n, int vehicle, const vector<int>& demand, 
-                                        int capacity, int depot, mt19937& gen, const vector<vector<double>>& dist,
-                                        double maxDistance = 0.0, double serviceTime = 0.0) {
+void crossoverOX(const vector<int>& parent1, const vector<int>& parent2,
+                 vector<int>& child1, vector<int>& child2,
+                 int n, int vehicle, const vector<int>& demand,
+                 int capacity, int depot, mt19937& gen, const DistMatrix& dist,
+                 double maxDistance = 0.0, double serviceTime = 0.0) {
     // Bước 1: Trích xuất customers (bỏ hết số 0)
-    vector<int> customers1, customers2;
-    for (int v : parent1) if (v != 0) customers1.push_back(v);
-    for (int v : parent2) if (v != 0) customers2.push_back(v);
-    
-    if (customers1.empty() || customers2.empty()) {
-        return {parent1, parent2};
-    }
+    CrossoverScratch& scratch = crossoverScratch();
+    vector<int>& customers1 = scratch.customers1;
+    vector<int>& customers2 = scratch.customers2;
+    extractCustomers(parent1, customers1);
+    extractCustomers(parent2, customers2);
     
     int minLen = min(customers1.size(), customers2.size());
     if (minLen < 2) {
-        return {parent1, parent2};
+        child1 = parent1;
+        child2 = parent2;
+        return;
     }
     
     // Bước 2: Lai ghép OX trên customer list
@@ -1486,86 +1807,55 @@ pair<vector<int>, vector<int>> crossoverOX(const vector<int>& parent1, const vec
     int cut2 = dis(gen);
     if (cut1 > cut2) swap(cut1, cut2);
     
-    vector<int> child1Customers(customers1.size(), -1);
-    vector<int> child2Customers(customers2.size(), -1);
-    set<int> used1, used2;
-    
-    // Copy đoạn giữa
-    for (int i = cut1; i <= cut2 && i < minLen; ++i) {
-        child1Customers[i] = customers1[i];
-        child2Customers[i] = customers2[i];
-        used1.insert(customers1[i]);
-        used2.insert(customers2[i]);
-    }
-    
-    // Fill phần còn lại
-    int pos1 = 0, pos2 = 0;
-    for (int cust : customers2) {
-        if (used1.find(cust) == used1.end()) {
-            while (pos1 < (int)child1Customers.size() && child1Customers[pos1] != -1) pos1++;
-            if (pos1 < (int)child1Customers.size()) child1Customers[pos1] = cust;
-        }
-    }
-    for (int cust : customers1) {
-        if (used2.find(cust) == used2.end()) {
-            while (pos2 < (int)child2Customers.size() && child2Customers[pos2] != -1) pos2++;
-            if (pos2 < (int)child2Customers.size()) child2Customers[pos2] = cust;
+    // Đoạn giữa giữ nguyên vị trí, các vị trí còn lại điền theo thứ tự của cha kia
+    auto build = [&](const vector<int>& keep, const vector<int>& fill, StampSet& used, vector<int>& out) {
+        used.next(n + 1);
+        for (int i = cut1; i <= cut2; ++i) used.mark(keep[i]);
+        out.clear();
+        size_t from = 0;
+        auto nextFree = [&]() {
+            while (from < fill.size() && used.test(fill[from])) from++;
+            return from < fill.size() ? fill[from++] : -1;
+        };
+        for (int i = 0; i < (int)keep.size(); ++i) {
+            int v = (i >= cut1 && i <= cut2) ? keep[i] : nextFree();
+            if (v != -1) out.push_back(v);
         }
-    }
+    };
+    build(customers1, customers2, scratch.used1, scratch.offspring1);
+    build(customers2, customers1, scratch.used2, scratch.offspring2);
     
     // Bước 3: Chèn vehicle-1 số 0 ngẫu nhiên
-    vector<int> child1 = child1Customers;
-    vector<int> child2 = child2Customers;
-    
-    int zerosToAdd = vehicle - 1;
-    
-    // Pre-calculate insertion positions to avoid exponential growth
-    vector<int> positions1, positions2;
-    uniform_int_distribution<> posDis1(0, child1.size());
-    uniform_int_distribution<> posDis2(0, child2.size());
-    
-    for (int i = 0; i < zerosToAdd; ++i) {
-        positions1.push_back(posDis1(gen));
-        positions2.push_back(posDis2(gen));
-    }
-    
-    // Sort positions in descending order to insert from right to left
-    sort(positions1.rbegin(), positions1.rend());
-    sort(positions2.rbegin(), positions2.rend());
-    
-    for (int pos : positions1) {
-        if (pos <= child1.size()) child1.insert(child1.begin() + pos, 0);
-    }
-    for (int pos : positions2) {
-        if (pos <= child2.size()) child2.insert(child2.begin() + pos, 0);
-    }
+    drawSeparatorPositions(scratch.offspring1.size(), scratch.offspring2.size(), vehicle - 1, gen,
+                           scratch.positions1, scratch.positions2);
+    mergeSeparators(scratch.offspring1, scratch.positions1, child1);
+    mergeSeparators(scratch.offspring2, scratch.positions2, child2);
     
     // Repair customers first, then zeros
     repairCustomerWithLocalSearch(child1, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
     repairZero(child1, vehicle, gen);
     repairCustomerWithLocalSearch(child2, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
     repairZero(child2, vehicle, gen);
-    
-    return {child1, child2};
 }
 
 // 3. Partially Mapped Crossover (PMX)
-pair<vector<int>, vector<int>> crossoverPMX(const vector<int>& parent1, const vector<int>& parent2,
-                                         int n, int vehicle, const vector<int>& demand,
-                                         int capacity, int depot, mt19937& gen, const vector<vector<double>>& dist,
-                                         double maxDistance = 0.0, double serviceTime = 0.0) {
+void crossoverPMX(const vector<int>& parent1, const vector<int>& parent2,
+                  vector<int>& child1, vector<int>& child2,
+                  int n, int vehicle, const vector<int>& demand,
+                  int capacity, int depot, mt19937& gen, const DistMatrix& dist,
+                  double maxDistance = 0.0, double serviceTime = 0.0) {
     // Bước 1: Trích xuất customers (bỏ hết số 0)
-    vector<int> customers1, customers2;
-    for (int v : parent1) if (v != 0) customers1.push_back(v);
-    for (int v : parent2) if (v != 0) customers2.push_back(v);
-    
-    if (customers1.empty() || customers2.empty()) {
-        return {parent1, parent2};
-    }
+    CrossoverScratch& scratch = crossoverScratch();
+    vector<int>& customers1 = scratch.customers1;
+    vector<int>& customers2 = scratch.customers2;
+    extractCustomers(parent1, customers1);
+    extractCustomers(parent2, customers2);
     
     int minLen = min(customers1.size(), customers2.size());
     if (minLen < 2) {
-        return {parent1, parent2};
+        child1 = parent1;
+        child2 = parent2;
+        return;
     }
     
     // Bước 2: Lai ghép PMX trên customer list
@@ -1574,75 +1864,394 @@ pair<vector<int>, vector<int>> crossoverPMX(const vector<int>& parent1, const ve
     int cut2 = dis(gen);
     if (cut1 > cut2) swap(cut1, cut2);
     
-    vector<int> child1 = customers1;
-    vector<int> child2 = customers2;
-    
-    // Tạo mapping và swap đoạn giữa
-    map<int, int> mapping1to2, mapping2to1;
-    for (int i = cut1; i <= cut2 && i < minLen; ++i) {
-        mapping1to2[customers1[i]] = customers2[i];  
-        mapping2to1[customers2[i]] = customers1[i];
-        child1[i] = customers2[i];
-        child2[i] = customers1[i];
+    vector<int>& offspring1 = scratch.offspring1;
+    vector<int>& offspring2 = scratch.offspring2;
+    offspring1.assign(customers1.begin(), customers1.end());
+    offspring2.assign(customers2.begin(), customers2.end());
+    
+    // Tạo mapping và swap đoạn giữa (mảng theo customer, stamp thay cho map)
+    vector<int>& map1to2 = scratch.map1to2;
+    vector<int>& map2to1 = scratch.map2to1;
+    if ((int)map1to2.size() < n + 1) {
+        map1to2.resize(n + 1);
+        map2to1.resize(n + 1);
+    }
+    scratch.mapped1.next(n + 1);
+    scratch.mapped2.next(n + 1);
+    for (int i = cut1; i <= cut2; ++i) {
+        map1to2[customers1[i]] = customers2[i];
+        map2to1[customers2[i]] = customers1[i];
+        scratch.mapped1.mark(customers1[i]);
+        scratch.mapped2.mark(customers2[i]);
+        offspring1[i] = customers2[i];
+        offspring2[i] = customers1[i];
     }
     
     // Áp dụng mapping để tránh duplicate
     for (int i = 0; i < minLen; ++i) {
         if (i < cut1 || i > cut2) {
-            // Fix child1
-            int val = child1[i];
-            while (mapping1to2.find(val) != mapping1to2.end()) {
-                val = mapping1to2[val];
-            }
-            child1[i] = val;
+            int val = offspring1[i];
+            while (scratch.mapped1.test(val)) val = map1to2[val];
+            offspring1[i] = val;
             
-            // Fix child2
-            val = child2[i];
-            while (mapping2to1.find(val) != mapping2to1.end()) {
-                val = mapping2to1[val];
-            }
-            child2[i] = val;
+            val = offspring2[i];
+            while (scratch.mapped2.test(val)) val = map2to1[val];
+            offspring2[i] = val;
         }
     }
     
     // Bước 3: Chèn vehicle-1 số 0 ngẫu nhiên
-    int zerosToAdd = vehicle - 1;
+    drawSeparatorPositions(offspring1.size(), offspring2.size(), vehicle - 1, gen,
+                           scratch.positions1, scratch.positions2);
+    mergeSeparators(offspring1, scratch.positions1, child1);
+    mergeSeparators(offspring2, scratch.positions2, child2);
+    
+    // Repair zeros to ensure valid format
+    repairZero(child1, vehicle, gen);
+    repairCustomerWithLocalSearch(child1, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+    repairZero(child2, vehicle, gen);
+    repairCustomerWithLocalSearch(child2, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+}
+
+// Tách seq thành tuyến dạng phẳng: customers của tuyến r là nodes[start[r] .. start[r + 1])
+void flattenRoutes(const vector<int>& seq, vector<int>& nodes, vector<int>& start) {
+    nodes.clear();
+    start.clear();
+    start.push_back(0);
+    for (int v : seq) {
+        if (v != 0) {
+            nodes.push_back(v);
+        } else if ((int)nodes.size() > start.back()) {
+            start.push_back(nodes.size());
+        }
+    }
+    if ((int)nodes.size() > start.back()) start.push_back(nodes.size());
+}
+
+// Con SREX từ tuyến của A (scratch.nodesA/startA) và B: lấy k tuyến liên tiếp của B từ
+// tuyến firstB, bỏ k tuyến của A trùng nhiều customer với chúng nhất. Customer của B được
+// xóa khỏi các tuyến còn lại của A; customer của các tuyến A bị bỏ mà B không có được chèn
+// lại ở vị trí rẻ nhất cạnh láng giềng gần (cùng capacity), rồi mới quét toàn bộ.
+void buildSREXChild(CrossoverScratch& scratch, int k, int firstB, int n, const vector<int>& demand,
+                    int capacity, int depot, const DistMatrix& dist, vector<int>& child) {
+    const vector<int>& nodesA = scratch.nodesA;
+    const vector<int>& startA = scratch.startA;
+    const vector<int>& nodesB = scratch.nodesB;
+    const vector<int>& startB = scratch.startB;
+    int routesA = startA.size() - 1, routesB = startB.size() - 1;
+    
+    scratch.fromB.next(n + 1);
+    for (int j = 0; j < k; ++j) {
+        int r = (firstB + j) % routesB;
+        for (int i = startB[r]; i < startB[r + 1]; ++i) scratch.fromB.mark(nodesB[i]);
+    }
     
-    // Pre-calculate insertion positions to avoid exponential growth
-    vector<int> positions1, positions2;
-    uniform_int_distribution<> posDis1(0, child1.size());
-    uniform_int_distribution<> posDis2(0, child2.size());
+    // k tuyến của A có nhiều customer thuộc phần lấy từ B nhất
+    vector<int>& overlap = scratch.overlap;
+    vector<int>& order = scratch.order;
+    overlap.assign(routesA, 0);
+    order.resize(routesA);
+    for (int r = 0; r < routesA; ++r) {
+        order[r] = r;
+        for (int i = startA[r]; i < startA[r + 1]; ++i) overlap[r] += scratch.fromB.test(nodesA[i]);
+    }
+    nth_element(order.begin(), order.begin() + (k - 1), order.end(), [&](int a, int b) {
+        return overlap[a] != overlap[b] ? overlap[a] > overlap[b] : a < b;
+    });
+    scratch.removedA.next(routesA);
+    for (int j = 0; j < k; ++j) scratch.removedA.mark(order[j]);
+    
+    // Tuyến của con: tuyến A được giữ (bỏ customer của B) + các tuyến lấy từ B
+    vector<vector<int>>& routes = scratch.routes;
+    if ((int)routes.size() < routesA + k) routes.resize(routesA + k);
+    scratch.routeCount = 0;
+    vector<int>& missing = scratch.missing;
+    missing.clear();
+    for (int r = 0; r < routesA; ++r) {
+        bool removed = scratch.removedA.test(r);
+        vector<int>* route = nullptr;
+        if (!removed) {
+            route = &routes[scratch.routeCount++];
+            route->clear();
+        }
+        for (int i = startA[r]; i < startA[r + 1]; ++i) {
+            int v = nodesA[i];
+            if (scratch.fromB.test(v)) continue;
+            if (removed) missing.push_back(v);
+            else route->push_back(v);
+        }
+    }
+    for (int j = 0; j < k; ++j) {
+        int r = (firstB + j) % routesB;
+        routes[scratch.routeCount++].assign(nodesB.begin() + startB[r], nodesB.begin() + startB[r + 1]);
+    }
     
-    for (int i = 0; i < zerosToAdd; ++i) {
-        positions1.push_back(posDis1(gen));
-        positions2.push_back(posDis2(gen));
+    // Vị trí và tải của từng tuyến cho việc chèn lại
+    const size_t routeCount = scratch.routeCount;
+    vector<int>& loads = scratch.loads;
+    vector<int>& routeOf = scratch.routeOf;
+    vector<int>& posOf = scratch.posOf;
+    if ((int)routeOf.size() < n + 1) {
+        routeOf.resize(n + 1);
+        posOf.resize(n + 1);
+    }
+    scratch.inChild.next(n + 1);
+    loads.assign(routeCount, 0);
+    auto indexFrom = [&](size_t r, size_t from) {
+        for (size_t p = from; p < routes[r].size(); ++p) {
+            routeOf[routes[r][p]] = r;
+            posOf[routes[r][p]] = p;
+        }
+    };
+    for (size_t r = 0; r < routeCount; ++r) {
+        indexFrom(r, 0);
+        for (int v : routes[r]) {
+            scratch.inChild.mark(v);
+            if (v < (int)demand.size()) loads[r] += demand[v];
+        }
     }
     
-    // Sort positions in descending order to insert from right to left
-    sort(positions1.rbegin(), positions1.rend());
-    sort(positions2.rbegin(), positions2.rend());
+    // Chi phí chèn c vào tuyến r trước vị trí p
+    auto insertCost = [&](int c, size_t r, size_t p) {
+        int prev = p > 0 ? routes[r][p - 1] : depot;
+        int next = p < routes[r].size() ? routes[r][p] : depot;
+        return dist[prev][c] + dist[c][next] - dist[prev][next];
+    };
+    for (int c : missing) {
+        int load = c < (int)demand.size() ? demand[c] : 0;
+        int bestRoute = -1;
+        size_t bestPos = 0;
+        double bestCost = numeric_limits<double>::max();
+        auto consider = [&](size_t r, size_t p) {
+            double cost = insertCost(c, r, p);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestRoute = r;
+                bestPos = p;
+            }
+        };
+        const int* nb = dist.neighbors(c);
+        for (int t = 0; t < dist.neighborCount(); ++t) {
+            int u = nb[t];
+            if (u == depot || u > n || !scratch.inChild.test(u)) continue;
+            size_t r = routeOf[u];
+            if (loads[r] + load > capacity) continue;
+            consider(r, posOf[u]);
+            consider(r, posOf[u] + 1);
+        }
+        for (int pass = 0; pass < 2 && bestRoute < 0; ++pass) { // pass 1 bỏ qua capacity
+            for (size_t r = 0; r < routeCount; ++r) {
+                if (pass == 0 && loads[r] + load > capacity) continue;
+                for (size_t p = 0; p <= routes[r].size(); ++p) consider(r, p);
+            }
+        }
+        routes[bestRoute].insert(routes[bestRoute].begin() + bestPos, c);
+        loads[bestRoute] += load;
+        scratch.inChild.mark(c);
+        indexFrom(bestRoute, bestPos);
+    }
     
-    for (int pos : positions1) {
-        if (pos <= child1.size()) child1.insert(child1.begin() + pos, 0);
+    child.clear();
+    for (size_t r = 0; r < scratch.routeCount; ++r) {
+        if (routes[r].empty()) continue;
+        if (!child.empty()) child.push_back(0);
+        child.insert(child.end(), routes[r].begin(), routes[r].end());
     }
-    for (int pos : positions2) {
-        if (pos <= child2.size()) child2.insert(child2.begin() + pos, 0);
+}
+
+// 4. Selective Route Exchange Crossover (SREX, Nagata & Kobayashi): trao đổi nguyên tuyến
+// giữa hai cha mẹ nên giữ được các tuyến tốt; con là hoán vị hợp lệ ngay khi tạo.
+void crossoverSREX(const vector<int>& parent1, const vector<int>& parent2,
+                   vector<int>& child1, vector<int>& child2,
+                   int n, int vehicle, const vector<int>& demand,
+                   int capacity, int depot, mt19937& gen, const DistMatrix& dist,
+                   double maxDistance = 0.0, double serviceTime = 0.0) {
+    CrossoverScratch& scratch = crossoverScratch();
+    flattenRoutes(parent1, scratch.nodesA, scratch.startA);
+    flattenRoutes(parent2, scratch.nodesB, scratch.startB);
+    int routes1 = scratch.startA.size() - 1, routes2 = scratch.startB.size() - 1;
+    if (routes1 < 1 || routes2 < 1) {
+        child1 = parent1;
+        child2 = parent2;
+        return;
     }
     
-    // Repair zeros to ensure valid format
-    repairZero(child1, vehicle, gen);
+    uniform_int_distribution<> countDis(1, max(1, min(routes1, routes2) / 2));
+    int k1 = countDis(gen), k2 = countDis(gen);
+    int first2 = uniform_int_distribution<>(0, routes2 - 1)(gen);
+    int first1 = uniform_int_distribution<>(0, routes1 - 1)(gen);
+    
+    // child1 = tuyến của parent1 + k1 tuyến của parent2; child2 ngược lại
+    buildSREXChild(scratch, k1, first2, n, demand, capacity, depot, dist, child1);
+    swap(scratch.nodesA, scratch.nodesB);
+    swap(scratch.startA, scratch.startB);
+    buildSREXChild(scratch, k2, first1, n, demand, capacity, depot, dist, child2);
+    
     repairCustomerWithLocalSearch(child1, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
-    repairZero(child2, vehicle, gen);
+    repairZero(child1, vehicle, gen);
     repairCustomerWithLocalSearch(child2, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+    repairZero(child2, vehicle, gen);
+}
+
+// ======= DELTA EVALUATION =======
+
+// Cache theo tuyến của một giant tour: tải, số khách và quãng đường mỗi tuyến.
+// zerosBefore[p] = số separator đứng trước vị trí p = chỉ số tuyến chứa p
+// (separator thuộc tuyến mà nó đóng lại; zerosBefore[seq.size()] = tuyến cuối).
+struct RouteCache {
+    vector<int> zerosBefore;
+    vector<int> load;
+    vector<int> customers;
+    vector<double> cost;
+};
+
+void buildRouteCache(const vector<int>& seq, const vector<int>& demand, const DistMatrix& dist,
+                     int depot, RouteCache& cache) {
+    int routes = 1 + count(seq.begin(), seq.end(), 0);
+    cache.zerosBefore.resize(seq.size() + 1);
+    cache.load.assign(routes, 0);
+    cache.customers.assign(routes, 0);
+    cache.cost.assign(routes, 0.0);
+    
+    int r = 0;
+    int prev = depot;
+    for (size_t p = 0; p < seq.size(); ++p) {
+        cache.zerosBefore[p] = r;
+        int v = seq[p];
+        if (v == 0) {
+            cache.cost[r] += dist[prev][depot];
+            prev = depot;
+            r++;
+            continue;
+        }
+        cache.load[r] += demand[v];
+        cache.customers[r]++;
+        cache.cost[r] += dist[prev][v];
+        prev = v;
+    }
+    cache.zerosBefore[seq.size()] = r;
+    cache.cost[r] += dist[prev][depot];
+}
+
+// Thay đổi của một tuyến do một move gây ra
+struct RouteChange {
+    int route;
+    double cost;
+    int load;
+    int customers;
+};
+
+// Kết quả của một mutation operator ở chế độ delta:
+// applied = seq có bị thay đổi; local = delta từng tuyến tính được chính xác
+// (move giữ nguyên thứ tự các separator). Khi local = false chỉ có cost tổng là đúng
+// hoặc move làm thay đổi cấu trúc tuyến, cần đánh giá lại toàn bộ.
+// routes là mảng cố định (không cấp phát khi trả về theo giá trị): swap / insertion / or-opt
+// chạm tối đa 2 tuyến; scramble trên đoạn dài hơn MAX_ROUTES tuyến đặt overflow và không local.
+struct MoveDelta {
+    static constexpr int MAX_ROUTES = 8;
+    
+    bool applied = false;
+    bool local = false;
+    bool overflow = false; // có tuyến bị thay đổi nhưng không còn chỗ trong routes
+    double cost = 0.0;
+    
+    struct Changes {
+        RouteChange items[MAX_ROUTES];
+        int count = 0;
+        
+        const RouteChange* begin() const { return items; }
+        const RouteChange* end() const { return items + count; }
+        RouteChange* begin() { return items; }
+        RouteChange* end() { return items + count; }
+        size_t size() const { return count; }
+    } routes;
+
+    void add(int route, double costDelta, int loadDelta, int customerDelta) {
+        cost += costDelta;
+        for (auto& change : routes) {
+            if (change.route == route) {
+                change.cost += costDelta;
+                change.load += loadDelta;
+                change.customers += customerDelta;
+                return;
+            }
+        }
+        if (routes.count == MAX_ROUTES) {
+            overflow = true;
+            return;
+        }
+        routes.items[routes.count++] = {route, costDelta, loadDelta, customerDelta};
+    }
+};
+
+// Ngữ cảnh để operator tính delta: cache của seq trước khi mutate.
+// Giả định ma trận dist đối xứng (EUC_2D), nên đảo đoạn không đổi chi phí bên trong.
+struct DeltaContext {
+    const RouteCache& cache;
+    const DistMatrix& dist;
+    const vector<int>& demand;
+    int depot;
+
+    // Node tại vị trí pos, separator và hai đầu chuỗi đều là depot
+    int node(const vector<int>& seq, int pos) const {
+        return (pos < 0 || pos >= (int)seq.size() || seq[pos] == 0) ? depot : seq[pos];
+    }
+    double d(int a, int b) const { return dist[a][b]; }
+    int routeOf(int pos) const { return cache.zerosBefore[pos]; }
+};
+
+// Delta của việc đổi chỗ hai khách hàng ở vị trí i và j (O(1))
+void swapDelta(const vector<int>& seq, int i, int j, const DeltaContext& ctx, MoveDelta& delta) {
+    int lo = min(i, j), hi = max(i, j);
+    int x = seq[lo], y = seq[hi];
+    if (hi == lo + 1) {
+        int p = ctx.node(seq, lo - 1), nx = ctx.node(seq, hi + 1);
+        double before = ctx.d(p, x) + ctx.d(x, y) + ctx.d(y, nx);
+        double after = ctx.d(p, y) + ctx.d(y, x) + ctx.d(x, nx);
+        delta.add(ctx.routeOf(lo), after - before, 0, 0);
+    } else {
+        int pl = ctx.node(seq, lo - 1), nl = ctx.node(seq, lo + 1);
+        int ph = ctx.node(seq, hi - 1), nh = ctx.node(seq, hi + 1);
+        double dl = ctx.d(pl, y) + ctx.d(y, nl) - ctx.d(pl, x) - ctx.d(x, nl);
+        double dh = ctx.d(ph, x) + ctx.d(x, nh) - ctx.d(ph, y) - ctx.d(y, nh);
+        int dy = ctx.demand[y] - ctx.demand[x];
+        delta.add(ctx.routeOf(lo), dl, dy, 0);
+        delta.add(ctx.routeOf(hi), dh, -dy, 0);
+    }
+    delta.local = true;
+}
 
-    return {child1, child2};
+// Delta của việc cắt đoạn [start, start+len) rồi chèn vào vị trí insertPos của chuỗi
+// sau khi cắt (O(1)); dùng cho insertion (len = 1) và or-opt.
+void segmentMoveDelta(const vector<int>& seq, int start, int len, int insertPos,
+                      const DeltaContext& ctx, MoveDelta& delta) {
+    int first = seq[start], last = seq[start + len - 1];
+    int segLoad = ctx.demand[first];
+    double segCost = 0.0; // các cạnh bên trong đoạn chuyển sang tuyến đích
+    for (int i = start + 1; i < start + len; ++i) {
+        segLoad += ctx.demand[seq[i]];
+        segCost += ctx.d(seq[i - 1], seq[i]);
+    }
+    
+    int p = ctx.node(seq, start - 1), nx = ctx.node(seq, start + len);
+    delta.add(ctx.routeOf(start), ctx.d(p, nx) - ctx.d(p, first) - ctx.d(last, nx) - segCost, -segLoad, -len);
+    
+    // Chỉ số trong chuỗi sau khi cắt -> chỉ số trong seq gốc
+    int reducedSize = seq.size() - len;
+    auto original = [&](int k) { return k < start ? k : k + len; };
+    auto reducedNode = [&](int k) { return (k < 0 || k >= reducedSize) ? ctx.depot : ctx.node(seq, original(k)); };
+    int q = reducedNode(insertPos - 1), r = reducedNode(insertPos);
+    delta.add(ctx.routeOf(original(insertPos)), ctx.d(q, first) + ctx.d(last, r) - ctx.d(q, r) + segCost, segLoad, len);
+    delta.local = true;
 }
 
 // ======= MUTATION OPERATORS =======
+// Mỗi operator nhận DeltaContext tùy chọn; khi có, nó trả về delta cost/load của move.
 
 // 1. Swap Mutation - Swaps two random customers
-void mutateSwap(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 2) return;
+MoveDelta mutateSwap(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 2) return delta;
     
     uniform_int_distribution<> posDis(0, (int)seq.size()-1);
     int i = posDis(gen);
@@ -1657,33 +2266,52 @@ void mutateSwap(vector<int>& seq, mt19937& gen) {
     }
     
     if (i != j && seq[i] != 0 && seq[j] != 0) {
+        if (ctx) swapDelta(seq, i, j, *ctx, delta);
         swap(seq[i], seq[j]);
+        delta.applied = true;
     }
+    return delta;
 }
 
 // 2. Inversion Mutation - Reverses a segment of the route
-void mutateInversion(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 3) return;
+MoveDelta mutateInversion(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 3) return delta;
     
     uniform_int_distribution<> posDis(0, (int)seq.size()-1);
     int start = posDis(gen);
     int end = posDis(gen);
     
     if (start > end) swap(start, end);
-    if (end - start < 1) return;
+    if (end - start < 1) return delta;
     
     // Make sure we don't reverse depot positions
-    while (start < seq.size() && seq[start] == 0) start++;
+    while (start < (int)seq.size() && seq[start] == 0) start++;
     while (end >= 0 && seq[end] == 0) end--;
     
-    if (start < end && start < seq.size() && end >= 0) {
+    if (start < end && start < (int)seq.size() && end >= 0) {
+        if (ctx) {
+            // Chỉ hai cạnh biên thay đổi; nếu đoạn chứa separator thì tuyến bị cấu trúc lại
+            int p = ctx->node(seq, start - 1), nx = ctx->node(seq, end + 1);
+            int a = seq[start], b = seq[end];
+            double costDelta = ctx->d(p, b) + ctx->d(a, nx) - ctx->d(p, a) - ctx->d(b, nx);
+            if (ctx->routeOf(start) == ctx->routeOf(end)) {
+                delta.add(ctx->routeOf(start), costDelta, 0, 0);
+                delta.local = true;
+            } else {
+                delta.cost = costDelta;
+            }
+        }
         reverse(seq.begin() + start, seq.begin() + end + 1);
+        delta.applied = true;
     }
+    return delta;
 }
 
 // 3. Insertion Mutation - Moves a customer to a different position
-void mutateInsertion(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 3) return;
+MoveDelta mutateInsertion(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 3) return delta;
     
     uniform_int_distribution<> posDis(0, (int)seq.size()-1);
     int from = posDis(gen);
@@ -1697,18 +2325,22 @@ void mutateInsertion(vector<int>& seq, mt19937& gen) {
     }
     
     if (from != to && seq[from] != 0) {
+        // Adjust insertion position if needed
+        if (to >= (int)seq.size() - 1) to = seq.size() - 1;
+        if (ctx) segmentMoveDelta(seq, from, 1, to, *ctx, delta);
+        
         int customer = seq[from];
         seq.erase(seq.begin() + from);
-        
-        // Adjust insertion position if needed
-        if (to >= seq.size()) to = seq.size();
         seq.insert(seq.begin() + to, customer);
+        delta.applied = true;
     }
+    return delta;
 }
 
 // 4. Or-opt Mutation - Moves a segment of 1-3 customers to another position
-void mutateOrOpt(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 4) return;
+MoveDelta mutateOrOpt(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 4) return delta;
     
     uniform_int_distribution<> segSizeDis(1, 3);
     uniform_int_distribution<> posDis(0, (int)seq.size()-1);
@@ -1718,7 +2350,7 @@ void mutateOrOpt(vector<int>& seq, mt19937& gen) {
     int insertPos = posDis(gen);
     
     // Ensure segment doesn't go out of bounds
-    if (start + segSize >= seq.size()) return;
+    if (start + segSize >= (int)seq.size()) return delta;
     
     // Check if segment contains only customers (no depots)
     bool validSegment = true;
@@ -1730,29 +2362,34 @@ void mutateOrOpt(vector<int>& seq, mt19937& gen) {
     }
     
     if (validSegment && insertPos != start) {
+        // Adjust insertion position
+        if (insertPos > start) insertPos -= segSize;
+        if (insertPos >= (int)seq.size() - segSize) insertPos = seq.size() - segSize;
+        if (insertPos < 0) insertPos = 0; // insertPos nằm trong segment
+        if (ctx) segmentMoveDelta(seq, start, segSize, insertPos, *ctx, delta);
+        
         // Extract segment
         vector<int> segment(seq.begin() + start, seq.begin() + start + segSize);
         seq.erase(seq.begin() + start, seq.begin() + start + segSize);
         
-        // Adjust insertion position
-        if (insertPos > start) insertPos -= segSize;
-        if (insertPos >= seq.size()) insertPos = seq.size();
-        
         // Insert segment at new position
         seq.insert(seq.begin() + insertPos, segment.begin(), segment.end());
+        delta.applied = true;
     }
+    return delta;
 }
 
 // 5. Scramble Mutation - Randomly shuffles a segment
-void mutateScramble(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 3) return;
+MoveDelta mutateScramble(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 3) return delta;
     
     uniform_int_distribution<> posDis(0, (int)seq.size()-1);
     int start = posDis(gen);
     int end = posDis(gen);
     
     if (start > end) swap(start, end);
-    if (end - start < 1) return;
+    if (end - start < 1) return delta;
     
     // Make sure segment contains only customers
     vector<int> customers;
@@ -1763,6 +2400,17 @@ void mutateScramble(vector<int>& seq, mt19937& gen) {
     }
     
     if (customers.size() > 1) {
+        // Separator giữ nguyên vị trí: delta = các cạnh trong [start-1, end+1], O(segment)
+        auto windowCost = [&](double sign) {
+            for (int k = start - 1; k <= end; ++k) {
+                delta.add(ctx->routeOf(k + 1), sign * ctx->d(ctx->node(seq, k), ctx->node(seq, k + 1)), 0, 0);
+            }
+            for (int k = start; k <= end; ++k) {
+                if (seq[k] != 0) delta.add(ctx->routeOf(k), 0.0, (int)sign * ctx->demand[seq[k]], 0);
+            }
+        };
+        if (ctx) windowCost(-1.0);
+        
         shuffle(customers.begin(), customers.end(), gen);
         
         // Put scrambled customers back
@@ -1772,28 +2420,36 @@ void mutateScramble(vector<int>& seq, mt19937& gen) {
                 seq[i] = customers[custIdx++];
             }
         }
+        
+        if (ctx) {
+            windowCost(1.0);
+            delta.local = !delta.overflow;
+        }
+        delta.applied = true;
     }
+    return delta;
 }
 
 // 6. Route Exchange Mutation - Exchanges segments between different routes
-void mutateRouteExchange(vector<int>& seq, mt19937& gen) {
-    if (seq.size() < 5) return;
+MoveDelta mutateRouteExchange(vector<int>& seq, mt19937& gen, const DeltaContext* ctx = nullptr) {
+    MoveDelta delta;
+    if (seq.size() < 5) return delta;
     
     // Find depot positions to identify routes
     vector<int> depotPos;
-    for (int i = 0; i < seq.size(); i++) {
+    for (int i = 0; i < (int)seq.size(); i++) {
         if (seq[i] == 0) {
             depotPos.push_back(i);
         }
     }
     
-    if (depotPos.size() < 3) return; // Need at least 2 routes
+    if (depotPos.size() < 3) return delta; // Need at least 2 routes
     
     uniform_int_distribution<> routeDis(0, depotPos.size()-2);
     int route1 = routeDis(gen);
     int route2 = routeDis(gen);
     
-    if (route1 == route2) return;
+    if (route1 == route2) return delta;
     
     int start1 = depotPos[route1] + 1;
     int end1 = depotPos[route1 + 1] - 1;
@@ -1809,123 +2465,1002 @@ void mutateRouteExchange(vector<int>& seq, mt19937& gen) {
             int pos1 = pos1Dis(gen);
             int pos2 = pos2Dis(gen);
             
+            if (ctx) swapDelta(seq, pos1, pos2, *ctx, delta);
             swap(seq[pos1], seq[pos2]);
+            delta.applied = true;
+        }
+    }
+    return delta;
+}
+
+// Kiểm tra các tuyến bị move thay đổi còn thỏa time constraint không (dựa trên cache)
+bool touchedRoutesWithinTime(const MoveDelta& delta, const RouteCache& cache,
+                             double maxDistance, double serviceTime) {
+    if (maxDistance <= 0.0) return true;
+    for (const auto& change : delta.routes) {
+        double routeTime = cache.cost[change.route] + change.cost
+                         + (cache.customers[change.route] + change.customers) * serviceTime;
+        if (routeTime > maxDistance) return false;
+    }
+    return true;
+}
+
+// 2-opt lại riêng các tuyến bị move thay đổi, ghi đè tại chỗ trong seq
+void improveTouchedRoutes(vector<int>& seq, const MoveDelta& delta, const DistMatrix& dist, int depot) {
+    for (const auto& change : delta.routes) {
+        int route = 0;
+        size_t begin = 0;
+        while (begin < seq.size() && route < change.route) {
+            if (seq[begin++] == 0) route++;
         }
+        size_t end = begin;
+        while (end < seq.size() && seq[end] != 0) end++;
+        twoOptImproveRange(seq.data() + begin, end - begin, dist, depot, 50);
     }
 }
 
-// Main mutation function with multiple operators
+// Main mutation function with multiple operators.
+// Move giữ nguyên cấu trúc tuyến và không tạo time violation chỉ cần 2-opt lại
+// các tuyến bị ảnh hưởng; các trường hợp còn lại mới chạy full repair như trước.
+// adaptive != nullptr: operator chọn theo AdaptiveOperators, cải thiện fitness và thời gian
+// (cả repair) ghi vào thống kê của worker.
 void mutate(vector<int>& seq, int n, int vehicle, const vector<int>& demand, 
-           int capacity, mt19937& gen, const vector<vector<double>>& dist, int depot,
-           double maxDistance = 0.0, double serviceTime = 0.0) {
+           int capacity, mt19937& gen, const DistMatrix& dist, int depot,
+           double maxDistance = 0.0, double serviceTime = 0.0,
+           AdaptiveOperators* adaptive = nullptr, int worker = 0) {
     // Adaptive mutation rate based on problem size
     double mutationRate = (n > 100) ? 0.40 : 0.30; // Higher rate for large problems
     uniform_real_distribution<> prob(0.0, 1.0);
     
-    if (prob(gen) < mutationRate) {
-        if (seq.size() < 2) return;
-        
-         // Select mutation operator based on probability distribution
-        double randValue = prob(gen);
-        
-        if (randValue < 0.25) {
-            // 25% - Swap Mutation
-            mutateSwap(seq, gen);
-        } else if (randValue < 0.45) {
-            // 20% - Inversion Mutation  
-            mutateInversion(seq, gen);
-        } else if (randValue < 0.60) {
-            // 15% - Insertion Mutation
-            mutateInsertion(seq, gen);
-        } else if (randValue < 0.75) {
-            // 15% - Or-opt Mutation
-            mutateOrOpt(seq, gen);
-        } else if (randValue < 0.90) {
-            // 15% - Scramble Mutation
-            mutateScramble(seq, gen);
-        } else {
-            // 10% - Route Exchange Mutation
-            mutateRouteExchange(seq, gen);
-        }
+    static thread_local RouteCache cache;
+    MoveDelta delta;
+    
+    if (!(prob(gen) < mutationRate) || seq.size() < 2) return;
+    
+    chrono::steady_clock::time_point start;
+    double before = 0.0;
+    FitnessParams params(dist, demand, capacity, depot, maxDistance, serviceTime);
+    if (adaptive) {
+        start = chrono::steady_clock::now();
+        bool feasible;
+        before = fitnessOfGenes(seq.data(), seq.size(), params, feasible);
+    }
+    
+    buildRouteCache(seq, demand, dist, depot, cache);
+    DeltaContext ctx{cache, dist, demand, depot};
+    
+     // Select mutation operator based on probability distribution
+    double randValue = prob(gen);
+    int op = adaptive ? adaptive->mutation().pick(randValue)
+                      : pickOperator(MUTATION_WEIGHTS, MUTATION_COUNT, randValue);
+    
+    switch (op) {
+        case MUTATION_SWAP: delta = mutateSwap(seq, gen, &ctx); break;                    // 25%
+        case MUTATION_INVERSION: delta = mutateInversion(seq, gen, &ctx); break;          // 20%
+        case MUTATION_INSERTION: delta = mutateInsertion(seq, gen, &ctx); break;          // 15%
+        case MUTATION_OR_OPT: delta = mutateOrOpt(seq, gen, &ctx); break;                 // 15%
+        case MUTATION_SCRAMBLE: delta = mutateScramble(seq, gen, &ctx); break;            // 15%
+        default: delta = mutateRouteExchange(seq, gen, &ctx); break;                      // 10%
+    }
+    
+    if (!delta.applied) { // seq không đổi, đã được repair từ trước
+    } else if (delta.local && touchedRoutesWithinTime(delta, cache, maxDistance, serviceTime)) {
+        improveTouchedRoutes(seq, delta, dist, depot);
+    } else {
+        repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+        repairZero(seq, vehicle, gen);
     }
     
-    repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
-    repairZero(seq, vehicle, gen);
+    if (adaptive) {
+        bool feasible;
+        double after = fitnessOfGenes(seq.data(), seq.size(), params, feasible);
+        adaptive->stats(worker).mutation[op].add(before - after, microsSince(start));
+    }
 }
 
-// ======= FEASIBILITY TRACKING =======
+// ======= LOCAL SEARCH =======
 
-struct FeasibleSolution {
-    vector<int> sequence;
-    double cost;
-    int generation;
-    bool isFeasible;
-    
-    FeasibleSolution() : cost(numeric_limits<double>::max()), generation(-1), isFeasible(false) {}
-    
-    FeasibleSolution(const vector<int>& seq, double c, int gen, bool feasible) 
-        : sequence(seq), cost(c), generation(gen), isFeasible(feasible) {}
+// Local search giữa các tuyến cho con sinh ra (memetic): relocate, Or-opt (đoạn 2-3
+// customer, cả chiều đảo), swap và 2-opt*. Mỗi tuyến giữ tải và quãng đường cộng dồn theo
+// vị trí, nên delta của mọi move là O(1): tuyến mới = prefix tuyến này + cạnh nối + suffix
+// tuyến kia. Chỉ xét move tạo cạnh (u, v) với v trong danh sách láng giềng của u (mọi node
+// khi --neighbors 0). Objective giống calculateFitness (quãng đường + 1000 * vượt tải
+// + 500 * vượt maxDistance) nên move cũng sửa được con chưa khả thi. First-improvement;
+// sau mỗi move chỉ build lại cache của tuyến bị đổi (O(độ dài tuyến)). Từ lượt thứ hai, cặp
+// (u, v) chỉ được xét lại khi tuyến của u hoặc v đã đổi kể từ lần duyệt u trước.
+// Giả định ma trận dist đối xứng (EUC_2D) như DELTA EVALUATION: đảo đoạn không đổi chi phí.
+
+enum LocalSearchMove { LS_RELOCATE, LS_OR_OPT, LS_SWAP, LS_TWO_OPT_STAR, LS_MOVE_COUNT };
+
+const char* const LS_MOVE_NAMES[LS_MOVE_COUNT] = {"relocate", "or_opt", "swap", "two_opt_star"};
+
+struct LocalSearchOptions {
+    double rate = 0.0;      // tỉ lệ con được local search, 0 = tắt
+    int maxMoves = 1000;    // số move cải thiện tối đa mỗi con
+    double maxMicros = 0.0; // thời gian tối đa mỗi con (µs), 0 = không giới hạn
+
+    bool enabled() const { return rate > 0.0; }
 };
 
-// Hàm lấy feasible solution tốt nhất từ một generation
-FeasibleSolution getBestFeasibleFromGeneration(const vector<vector<int>>& population,
-                                             const vector<pair<double, int>>& fitnessIndex,
-                                             const vector<int>& demand,
-                                             int capacity, int depot, int generation,
-                                             const vector<vector<double>>& dist = {},
-                                             double maxDistance = 0.0, double serviceTime = 0.0) {
-    
-    FeasibleSolution bestFeasible;
-    int feasibleCount = 0;
-    
-    // Duyệt population theo thứ tự fitness tốt nhất trước
-    for (const auto& entry : fitnessIndex) {
+// Bộ đệm theo thread, giữ capacity qua các lần gọi
+struct LocalSearchScratch {
+    vector<vector<int>> routes;        // [depot, customers..., depot]
+    vector<vector<int>> loadPrefix;    // tải của route[0..i]
+    vector<vector<double>> distPrefix; // quãng đường depot -> route[i]
+    vector<int> routeOf, posOf;        // theo node, -1 = không thuộc lời giải đang xét
+    vector<long long> changedAt;       // theo tuyến: số move lúc tuyến đổi lần cuối
+    vector<long long> testedAt;        // theo node: số move lúc bắt đầu duyệt u lần cuối
+    vector<int> order;                 // thứ tự duyệt customer
+    vector<int> buffer;                // đoạn / đuôi tuyến đang chuyển
+};
+
+inline LocalSearchScratch& localSearchScratch() {
+    static thread_local LocalSearchScratch scratch;
+    return scratch;
+}
+
+// Cải thiện seq tại chỗ, giữ nguyên số tuyến (số separator); dừng ở local optimum, sau
+// maxMoves move hoặc maxMicros µs (> 0). Trả về số move đã áp dụng, moveCounts (nếu có)
+// cộng thêm theo LocalSearchMove. seq có customer lặp / ngoài phạm vi: bỏ qua, trả về 0.
+int localSearchImprove(vector<int>& seq, const DistMatrix& dist, const vector<int>& demand,
+                       int capacity, int depot, double maxDistance, double serviceTime,
+                       int maxMoves, double maxMicros, mt19937& gen, long long* moveCounts = nullptr) {
+    ScopedPhase phase(PHASE_LOCAL_SEARCH);
+    LocalSearchScratch& s = localSearchScratch();
+    const int nodes = dist.size();
+    if ((int)s.routeOf.size() < nodes) {
+        s.routeOf.assign(nodes, -1);
+        s.posOf.assign(nodes, -1);
+        s.testedAt.resize(nodes);
+    }
+    int routeCount = 1 + count(seq.begin(), seq.end(), 0);
+    if ((int)s.routes.size() < routeCount) {
+        s.routes.resize(routeCount);
+        s.loadPrefix.resize(routeCount);
+        s.distPrefix.resize(routeCount);
+    }
+    s.changedAt.assign(routeCount, 0);
+    
+    auto release = [&]() {
+        for (int v : s.order) s.routeOf[v] = s.posOf[v] = -1;
+    };
+    s.order.clear();
+    int r = 0;
+    s.routes[0].assign(1, depot);
+    for (int v : seq) {
+        if (v == 0) {
+            s.routes[r].push_back(depot);
+            s.routes[++r].assign(1, depot);
+            continue;
+        }
+        if (v < 0 || v >= nodes || v == depot || s.routeOf[v] >= 0) {
+            release();
+            return 0;
+        }
+        s.routeOf[v] = r;
+        s.routes[r].push_back(v);
+        s.order.push_back(v);
+    }
+    s.routes[r].push_back(depot);
+    
+    long long moves = 0;
+    auto rebuild = [&](int r) {
+        const vector<int>& route = s.routes[r];
+        vector<int>& load = s.loadPrefix[r];
+        vector<double>& length = s.distPrefix[r];
+        load.resize(route.size());
+        length.resize(route.size());
+        load[0] = 0;
+        length[0] = 0.0;
+        s.changedAt[r] = moves;
+        for (size_t i = 1; i < route.size(); ++i) {
+            int v = route[i];
+            load[i] = load[i - 1] + (v == depot ? 0 : demand[v]);
+            length[i] = length[i - 1] + dist[route[i - 1]][v];
+            if (v != depot) {
+                s.routeOf[v] = r;
+                s.posOf[v] = i;
+            }
+        }
+    };
+    for (int k = 0; k < routeCount; ++k) rebuild(k);
+    
+    const bool checkTime = maxDistance > 0.0;
+    auto cost = [&](int load, double length, int customers) {
+        double total = length;
+        if (load > capacity) total += 1000.0 * (load - capacity);
+        if (checkTime && customers > 0) {
+            double routeTime = length + customers * serviceTime;
+            if (routeTime > maxDistance) total += 500.0 * (routeTime - maxDistance);
+        }
+        return total;
+    };
+    auto load = [&](int r) { return s.loadPrefix[r].back(); };
+    auto length = [&](int r) { return s.distPrefix[r].back(); };
+    auto customers = [&](int r) { return (int)s.routes[r].size() - 2; };
+    auto routeCost = [&](int r) { return cost(load(r), length(r), customers(r)); };
+    
+    // Đoạn route[ru][i, i+len) chuyển tới ngay sau vị trí j của tuyến rv (đảo chiều nếu reversed).
+    // Cùng tuyến: j không thuộc [i-1, i+len).
+    auto segmentDelta = [&](int ru, int i, int len, int rv, int j, bool reversed) {
+        const vector<int>& a = s.routes[ru];
+        const vector<int>& b = s.routes[rv];
+        int first = a[i], last = a[i + len - 1], before = a[i - 1], after = a[i + len];
+        int v = b[j], y = b[j + 1];
+        double removed = dist[before][after] - dist[before][first] - dist[last][after];
+        double added = (reversed ? dist[v][last] + dist[first][y] : dist[v][first] + dist[last][y]) - dist[v][y];
+        if (ru == rv) return cost(load(ru), length(ru) + removed + added, customers(ru)) - routeCost(ru);
+        
+        int segLoad = s.loadPrefix[ru][i + len - 1] - s.loadPrefix[ru][i - 1];
+        double segLength = s.distPrefix[ru][i + len - 1] - s.distPrefix[ru][i];
+        return cost(load(ru) - segLoad, length(ru) + removed - segLength, customers(ru) - len)
+             + cost(load(rv) + segLoad, length(rv) + added + segLength, customers(rv) + len)
+             - routeCost(ru) - routeCost(rv);
+    };
+    auto applySegment = [&](int ru, int i, int len, int rv, int j, bool reversed) {
+        vector<int>& a = s.routes[ru];
+        s.buffer.assign(a.begin() + i, a.begin() + i + len);
+        if (reversed) reverse(s.buffer.begin(), s.buffer.end());
+        a.erase(a.begin() + i, a.begin() + i + len);
+        int at = (ru == rv && j > i) ? j - len : j;
+        vector<int>& b = s.routes[rv];
+        b.insert(b.begin() + at + 1, s.buffer.begin(), s.buffer.end());
+        rebuild(ru);
+        if (rv != ru) rebuild(rv);
+    };
+    
+    // Đổi chỗ customer ở (ra, i) và (rb, j)
+    auto swapDelta = [&](int ra, int i, int rb, int j) {
+        if (ra == rb && i > j) swap(i, j);
+        const vector<int>& a = s.routes[ra];
+        const vector<int>& b = s.routes[rb];
+        int x = a[i], y = b[j];
+        if (ra == rb && j == i + 1) {
+            double change = dist[a[i - 1]][y] + dist[x][a[j + 1]] - dist[a[i - 1]][x] - dist[y][a[j + 1]];
+            return cost(load(ra), length(ra) + change, customers(ra)) - routeCost(ra);
+        }
+        double da = dist[a[i - 1]][y] + dist[y][a[i + 1]] - dist[a[i - 1]][x] - dist[x][a[i + 1]];
+        double db = dist[b[j - 1]][x] + dist[x][b[j + 1]] - dist[b[j - 1]][y] - dist[y][b[j + 1]];
+        if (ra == rb) return cost(load(ra), length(ra) + da + db, customers(ra)) - routeCost(ra);
+        int shift = demand[y] - demand[x];
+        return cost(load(ra) + shift, length(ra) + da, customers(ra))
+             + cost(load(rb) - shift, length(rb) + db, customers(rb))
+             - routeCost(ra) - routeCost(rb);
+    };
+    auto applySwap = [&](int ra, int i, int rb, int j) {
+        swap(s.routes[ra][i], s.routes[rb][j]);
+        rebuild(ra);
+        if (rb != ra) rebuild(rb);
+    };
+    
+    // 2-opt*: đổi đuôi sau vị trí i của ru và sau vị trí j của rv (ru != rv)
+    auto tailsDelta = [&](int ru, int i, int rv, int j) {
+        const vector<int>& a = s.routes[ru];
+        const vector<int>& b = s.routes[rv];
+        double lengthU = s.distPrefix[ru][i] + dist[a[i]][b[j + 1]] + (length(rv) - s.distPrefix[rv][j + 1]);
+        double lengthV = s.distPrefix[rv][j] + dist[b[j]][a[i + 1]] + (length(ru) - s.distPrefix[ru][i + 1]);
+        int loadU = s.loadPrefix[ru][i] + (load(rv) - s.loadPrefix[rv][j]);
+        int loadV = s.loadPrefix[rv][j] + (load(ru) - s.loadPrefix[ru][i]);
+        return cost(loadU, lengthU, i + (customers(rv) - j)) + cost(loadV, lengthV, j + (customers(ru) - i))
+             - routeCost(ru) - routeCost(rv);
+    };
+    auto applyTails = [&](int ru, int i, int rv, int j) {
+        vector<int>& a = s.routes[ru];
+        vector<int>& b = s.routes[rv];
+        s.buffer.assign(a.begin() + i + 1, a.end());
+        a.resize(i + 1);
+        a.insert(a.end(), b.begin() + j + 1, b.end());
+        b.resize(j + 1);
+        b.insert(b.end(), s.buffer.begin(), s.buffer.end());
+        rebuild(ru);
+        rebuild(rv);
+    };
+    
+    const double EPS = 1e-9;
+    // Thử các move tạo cạnh (u, v); áp dụng move cải thiện đầu tiên, trả về loại move hoặc -1
+    auto improveWith = [&](int u, int v) -> int {
+        int ru = s.routeOf[u], i = s.posOf[u];
+        int rv = s.routeOf[v], j = s.posOf[v];
+        bool same = ru == rv;
+        int sizeU = s.routes[ru].size();
+        
+        // Relocate u sau v, trước v
+        if (!(same && j == i - 1) && segmentDelta(ru, i, 1, rv, j, false) < -EPS) {
+            applySegment(ru, i, 1, rv, j, false);
+            return LS_RELOCATE;
+        }
+        if (!(same && j - 1 == i) && segmentDelta(ru, i, 1, rv, j - 1, false) < -EPS) {
+            applySegment(ru, i, 1, rv, j - 1, false);
+            return LS_RELOCATE;
+        }
+        // Or-opt: đoạn bắt đầu hoặc kết thúc tại u, đặt sau / trước v sao cho u kề v
+        for (int len = 2; len <= 3; ++len) {
+            for (int start : {i, i - len + 1}) {
+                if (start < 1 || start + len - 1 > sizeU - 2) continue;
+                bool startsAtU = start == i;
+                auto outside = [&](int at) { return !same || at < start - 1 || at >= start + len; };
+                // u đầu đoạn: sau v giữ chiều, trước v đảo; u cuối đoạn: ngược lại
+                if (outside(j) && segmentDelta(ru, start, len, rv, j, !startsAtU) < -EPS) {
+                    applySegment(ru, start, len, rv, j, !startsAtU);
+                    return LS_OR_OPT;
+                }
+                if (outside(j - 1) && segmentDelta(ru, start, len, rv, j - 1, startsAtU) < -EPS) {
+                    applySegment(ru, start, len, rv, j - 1, startsAtU);
+                    return LS_OR_OPT;
+                }
+            }
+        }
+        // Swap u với node kề v, để u đứng cạnh v
+        for (int k : {j + 1, j - 1}) {
+            int w = s.routes[rv][k];
+            if (w == depot || w == u) continue;
+            if (swapDelta(ru, i, rv, k) < -EPS) {
+                applySwap(ru, i, rv, k);
+                return LS_SWAP;
+            }
+        }
+        // 2-opt*: u -> v hoặc v -> u
+        if (!same) {
+            if (tailsDelta(ru, i, rv, j - 1) < -EPS) {
+                applyTails(ru, i, rv, j - 1);
+                return LS_TWO_OPT_STAR;
+            }
+            if (tailsDelta(ru, i - 1, rv, j) < -EPS) {
+                applyTails(ru, i - 1, rv, j);
+                return LS_TWO_OPT_STAR;
+            }
+        }
+        return -1;
+    };
+    // Relocate u vào một tuyến rỗng (không có trong danh sách láng giềng)
+    auto improveEmpty = [&](int u) -> int {
+        int ru = s.routeOf[u];
+        if (customers(ru) < 2) return -1;
+        for (int r = 0; r < routeCount; ++r) {
+            if (customers(r) > 0) continue;
+            if (segmentDelta(ru, s.posOf[u], 1, r, 0, false) < -EPS) {
+                applySegment(ru, s.posOf[u], 1, r, 0, false);
+                return LS_RELOCATE;
+            }
+            break;
+        }
+        return -1;
+    };
+    
+    shuffle(s.order.begin(), s.order.end(), gen);
+    const int K = dist.neighborCount();
+    const int candidates = K > 0 ? K : nodes - 1;
+    auto start = chrono::steady_clock::now();
+    bool improved = true, stopped = false, firstPass = true;
+    auto record = [&](int move) {
+        if (move < 0) return;
+        moves++;
+        improved = true;
+        if (moveCounts) moveCounts[move]++;
+    };
+    while (improved && !stopped) {
+        improved = false;
+        for (int u : s.order) {
+            if (moves >= maxMoves || (maxMicros > 0 && microsSince(start) > maxMicros)) {
+                stopped = true;
+                break;
+            }
+            const int* nb = K > 0 ? dist.neighbors(u) : nullptr;
+            long long testedAt = firstPass ? -1 : s.testedAt[u];
+            s.testedAt[u] = moves;
+            for (int c = 0; c < candidates && moves < maxMoves; ++c) {
+                int v = nb ? nb[c] : c + 1;
+                if (v == u || v == depot || s.routeOf[v] < 0) continue;
+                if (max(s.changedAt[s.routeOf[u]], s.changedAt[s.routeOf[v]]) <= testedAt) continue;
+                record(improveWith(u, v));
+            }
+            record(improveEmpty(u));
+        }
+        firstPass = false;
+    }
+    
+    if (moves > 0) {
+        seq.clear();
+        for (int k = 0; k < routeCount; ++k) {
+            if (k > 0) seq.push_back(0);
+            seq.insert(seq.end(), s.routes[k].begin() + 1, s.routes[k].end() - 1);
+        }
+    }
+    release();
+    return (int)moves;
+}
+
+// Thống kê của một worker, gộp khi in kết quả
+struct alignas(64) LocalSearchStats {
+    long long children = 0;
+    long long moves[LS_MOVE_COUNT] = {};
+    double micros = 0.0;
+    
+    LocalSearchStats& operator+=(const LocalSearchStats& other) {
+        children += other.children;
+        for (int k = 0; k < LS_MOVE_COUNT; ++k) moves[k] += other.moves[k];
+        micros += other.micros;
+        return *this;
+    }
+};
+
+// Local search của một run: mỗi worker cộng vào stats riêng, không cần khóa
+class LocalSearch {
+public:
+    LocalSearch(const LocalSearchOptions& options, int workers) : options_(options), stats_(max(1, workers)) {}
+    
+    const LocalSearchOptions& options() const { return options_; }
+    
+    // Với xác suất options().rate: local search child tại chỗ, trả về true nếu đã chạy
+    bool maybeImprove(vector<int>& child, mt19937& gen, int worker, const DistMatrix& dist,
+                      const vector<int>& demand, int capacity, int depot, double maxDistance, double serviceTime) {
+        uniform_real_distribution<> chance(0.0, 1.0);
+        if (chance(gen) >= options_.rate) return false;
+        LocalSearchStats& stats = stats_[worker];
+        auto start = chrono::steady_clock::now();
+        localSearchImprove(child, dist, demand, capacity, depot, maxDistance, serviceTime,
+                           options_.maxMoves, options_.maxMicros, gen, stats.moves);
+        stats.children++;
+        stats.micros += microsSince(start);
+        return true;
+    }
+    
+    LocalSearchStats total() const {
+        LocalSearchStats sum;
+        for (const LocalSearchStats& stats : stats_) sum += stats;
+        return sum;
+    }
+    
+private:
+    LocalSearchOptions options_;
+    vector<LocalSearchStats> stats_;
+};
+
+// ======= POPULATION WITH CACHED FITNESS =======
+
+// Gene của mọi cá thể trong một khối nhớ liên tục: mỗi cá thể một slot cố định stride()
+// gene, độ dài thật lưu riêng. Gene là uint16_t khi node id < 65536 (mọi instance CMT),
+// ngược lại uint32_t; bằng một nửa vector<int> và không có cấp phát riêng cho từng cá thể.
+// Slot tự nới rộng (sắp xếp lại arena) nếu gặp giant tour dài hơn stride hiện tại.
+class ChromosomeArena {
+public:
+    explicit ChromosomeArena(int maxNode = 0) : maxNode_(maxNode), width_(maxNode < 65536 ? 2 : 4) {}
+
+    int maxNode() const { return maxNode_; }
+    int width() const { return width_; }
+    size_t stride() const { return stride_; }
+    size_t size() const { return length_.size(); }
+    size_t length(size_t i) const { return length_[i]; }
+    size_t bytes() const { return data_.size(); }
+
+    void reserve(size_t count, size_t slotLength) {
+        if (slotLength > stride_) restride(slotLength);
+        data_.reserve(count * stride_ * width_);
+        length_.reserve(count);
+    }
+
+    void clear() {
+        data_.clear();
+        length_.clear();
+    }
+
+    // Thêm slot mới chứa seq, trả về chỉ số slot
+    size_t push(const vector<int>& seq) {
+        if (seq.size() > stride_) restride(seq.size() + SLOT_SLACK);
+        length_.push_back(0);
+        data_.resize(data_.size() + stride_ * width_);
+        store(length_.size() - 1, seq);
+        return length_.size() - 1;
+    }
+
+    // Thêm bản sao slot index của arena khác (chép thẳng dạng đã mã hóa)
+    size_t pushCopy(const ChromosomeArena& from, size_t index) {
+        if (from.width_ != width_) return push(from.get(index));
+        if (from.length_[index] > stride_) restride(from.length_[index] + SLOT_SLACK);
+        length_.push_back(from.length_[index]);
+        data_.resize(data_.size() + stride_ * width_);
+        memcpy(slot(length_.size() - 1), from.slot(index), from.length_[index] * width_);
+        return length_.size() - 1;
+    }
+
+    void store(size_t i, const vector<int>& seq) {
+        if (seq.size() > stride_) restride(seq.size() + SLOT_SLACK);
+        length_[i] = seq.size();
+        if (width_ == 2) encode(reinterpret_cast<uint16_t*>(slot(i)), seq);
+        else encode(reinterpret_cast<uint32_t*>(slot(i)), seq);
+    }
+
+    // Giải mã slot i vào out (dùng lại capacity của out)
+    void load(size_t i, vector<int>& out) const {
+        out.resize(length_[i]);
+        if (width_ == 2) decode(reinterpret_cast<const uint16_t*>(slot(i)), out);
+        else decode(reinterpret_cast<const uint32_t*>(slot(i)), out);
+    }
+
+    vector<int> get(size_t i) const {
+        vector<int> seq;
+        load(i, seq);
+        return seq;
+    }
+
+    // Gene của slot i dạng đã mã hóa (Gene = uint16_t khi width() == 2, ngược lại uint32_t)
+    template <typename Gene>
+    const Gene* genes(size_t i) const { return reinterpret_cast<const Gene*>(slot(i)); }
+
+private:
+    template <typename Gene>
+    static void encode(Gene* genes, const vector<int>& seq) {
+        for (size_t k = 0; k < seq.size(); ++k) genes[k] = (Gene)seq[k];
+    }
+    template <typename Gene>
+    static void decode(const Gene* genes, vector<int>& seq) {
+        for (size_t k = 0; k < seq.size(); ++k) seq[k] = genes[k];
+    }
+
+    unsigned char* slot(size_t i) { return data_.data() + i * stride_ * width_; }
+    const unsigned char* slot(size_t i) const { return data_.data() + i * stride_ * width_; }
+
+    static const size_t SLOT_SLACK = 8; // chừa chỗ cho vài separator thêm khi phải nới slot
+
+    void restride(size_t newStride) {
+        vector<unsigned char, AlignedAllocator<unsigned char, DIST_ALIGNMENT>> data(length_.size() * newStride * width_);
+        for (size_t i = 0; i < length_.size(); ++i) {
+            memcpy(data.data() + i * newStride * width_, slot(i), length_[i] * width_);
+        }
+        data.reserve(data_.capacity() / max<size_t>(1, stride_ * width_) * newStride * width_);
+        data_.swap(data);
+        stride_ = newStride;
+    }
+
+    int maxNode_;
+    int width_;
+    size_t stride_ = 0;
+    vector<unsigned char, AlignedAllocator<unsigned char, DIST_ALIGNMENT>> data_;
+    vector<uint32_t> length_;
+};
+
+// Bộ đệm giải mã chromosome của mỗi thread (geneScratch()): cha mẹ trong reproducePair
+// và cá thể đang được đánh giá được giải mã từ arena vào đây, không tạo vector mới.
+struct GeneScratch {
+    vector<int> parent1, parent2, decoded;
+};
+
+inline GeneScratch& geneScratch() {
+    static thread_local GeneScratch scratch;
+    return scratch;
+}
+
+// Population dạng structure-of-arrays: genes (ChromosomeArena) kèm fitness/feasibility
+// đã tính sẵn cho từng cá thể. Cá thể được giữ lại từ thế hệ trước (elite, random parent)
+// mang theo kết quả cũ, chỉ các con mới tạo bởi crossover/mutate mới phải đánh giá lại.
+struct Population {
+    ChromosomeArena genes;
+    vector<double> fitness;
+    vector<char> feasible;
+    vector<char> evaluated;
+    vector<pair<double, int>> fitnessIndex; // (fitness, index) sắp xếp tăng dần
+
+    explicit Population(int maxNode = 0) : genes(maxNode) {}
+
+    size_t size() const { return fitness.size(); }
+
+    // Xóa mọi cá thể, giữ capacity (dùng lại làm buffer của thế hệ sau)
+    void clear() {
+        genes.clear();
+        fitness.clear();
+        feasible.clear();
+        evaluated.clear();
+        fitnessIndex.clear();
+    }
+
+    void reserve(size_t count, size_t slotLength = 0) {
+        genes.reserve(count, slotLength);
+        fitness.reserve(count);
+        feasible.reserve(count);
+        evaluated.reserve(count);
+    }
+
+    vector<int> individual(size_t i) const { return genes.get(i); }
+    void individual(size_t i, vector<int>& out) const { genes.load(i, out); }
+
+    // Toàn bộ cá thể dạng giant tour (checkpoint)
+    vector<vector<int>> individuals() const {
+        vector<vector<int>> all(size());
+        for (size_t i = 0; i < size(); ++i) genes.load(i, all[i]);
+        return all;
+    }
+
+    // Thêm cá thể mới, cần đánh giá lại
+    void add(const vector<int>& seq) {
+        genes.push(seq);
+        fitness.push_back(0.0);
+        feasible.push_back(0);
+        evaluated.push_back(0);
+    }
+
+    // Thêm cá thể giữ nguyên từ population khác, dùng lại fitness đã cache
+    void addEvaluated(const Population& from, int index) {
+        genes.pushCopy(from.genes, index);
+        fitness.push_back(from.fitness[index]);
+        feasible.push_back(from.feasible[index]);
+        evaluated.push_back(from.evaluated[index]);
+    }
+
+    // Thay cá thể i (fitness do caller gán lại, hoặc đánh dấu chưa đánh giá)
+    void replace(size_t i, const vector<int>& seq) {
+        genes.store(i, seq);
+        evaluated[i] = 0;
+    }
+};
+
+Population makePopulation(const vector<vector<int>>& individuals, int n) {
+    Population pop(n);
+    size_t longest = 0;
+    for (const auto& seq : individuals) longest = max(longest, seq.size());
+    pop.reserve(individuals.size(), longest);
+    for (const auto& seq : individuals) pop.add(seq);
+    return pop;
+}
+
+// ======= BATCH FITNESS =======
+
+// Kernel SIMD: mỗi lane một cá thể, đi tuần tự theo gene của chính nó nên phép cộng
+// trong từng lane cùng thứ tự với bản scalar và kết quả trùng từng bit. Mỗi bước gather
+// dist[prev][next] và demand[gene] cho mọi lane; separator (và một separator ảo sau gene
+// cuối, đóng tuyến cuối; đóng tuyến rỗng không đổi kết quả) đóng tuyến dưới mask.
+// NEON không có gather: trên ARM dùng bản scalar (SimdLevel: xem SIMD DISPATCH).
+
+// Mức SIMD của evaluatePopulation (--simd). Mặc định AVX-512 nếu có, ngược lại scalar:
+// gather 4 lane của AVX2 chậm hơn kernel scalar trên các CPU đã đo (xem make bench-fitness).
+inline SimdLevel& fitnessSimd() {
+    static SimdLevel level = detectSimdLevel() == SimdLevel::AVX512 ? SimdLevel::AVX512 : SimdLevel::Scalar;
+    return level;
+}
+
+// Trả về mức thực sự dùng (không vượt quá mức CPU hỗ trợ)
+SimdLevel setFitnessSimd(SimdLevel level) {
+    fitnessSimd() = min(level, detectSimdLevel());
+    return fitnessSimd();
+}
+
+#ifdef CVRP_X86_SIMD
+// limits[l] = số bước của lane l (độ dài + 1 separator ảo), 0 = lane trống
+template <typename Gene>
+__attribute__((target("avx2")))
+void fitnessLanesAVX2(const Gene* const* genes, const int* limits, const FitnessParams& p,
+                      double* fitness, char* feasible) {
+    const dist_t* base = p.dist->data();
+    const __m128i stride = _mm_set1_epi32((int)p.dist->stride());
+    const __m128i depot = _mm_set1_epi32(p.depot);
+    const __m128i capacity = _mm_set1_epi32(p.capacity);
+    const __m128i zero = _mm_setzero_si128();
+    // Gather dạng _mask_ với mask đủ lane và nguồn 0 (bản không mask để nguồn chưa khởi tạo,
+    // gây -Wmaybe-uninitialized); cùng một lệnh vgather
+    const __m128i allLanes = _mm_set1_epi32(-1);
+    const __m256d maxDistance = _mm256_set1_pd(p.maxDistance);
+    const __m256d serviceTime = _mm256_set1_pd(p.serviceTime);
+    const bool checkTime = p.maxDistance > 0.0;
+    const __m128i limit = _mm_loadu_si128(reinterpret_cast<const __m128i*>(limits));
+    int steps = max(max(limits[0], limits[1]), max(limits[2], limits[3]));
+    
+    __m128i prev = depot, load = zero, customers = zero;
+    __m256d routeCost = _mm256_setzero_pd(), totalCost = routeCost, totalPenalty = routeCost;
+    __m256d violated = routeCost;
+    // Gene của lane l tại pos (0 = separator ảo / lane đã hết)
+    auto gene = [&](int l, int pos) { return pos + 1 < limits[l] ? (int)genes[l][pos] : 0; };
+    
+    for (int pos = 0; pos < steps; ++pos) {
+        __m128i v = _mm_setr_epi32(gene(0, pos), gene(1, pos), gene(2, pos), gene(3, pos));
+        __m128i active = _mm_cmpgt_epi32(limit, _mm_set1_epi32(pos));
+        __m128i separator = _mm_cmpeq_epi32(v, zero);
+        __m128i next = _mm_blendv_epi8(v, depot, separator);
+        __m128i index = _mm_add_epi32(_mm_mullo_epi32(prev, stride), next);
+        __m256d d;
+        if (sizeof(dist_t) == sizeof(float)) {
+            d = _mm256_cvtps_pd(_mm_mask_i32gather_ps(_mm_setzero_ps(), reinterpret_cast<const float*>(base), index,
+                                                      _mm_castsi128_ps(allLanes), 4));
+        } else {
+            d = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), reinterpret_cast<const double*>(base), index,
+                                         _mm256_castsi256_pd(_mm256_cvtepi32_epi64(allLanes)), 8);
+        }
+        __m256d activeMask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(active));
+        routeCost = _mm256_blendv_pd(routeCost, _mm256_add_pd(routeCost, d), activeMask);
+        
+        __m128i visit = _mm_andnot_si128(separator, active);
+        __m128i demand = _mm_mask_i32gather_epi32(zero, p.demand, v, allLanes, 4);
+        load = _mm_add_epi32(load, _mm_and_si128(demand, visit));
+        customers = _mm_sub_epi32(customers, visit);
+        prev = _mm_blendv_epi8(prev, v, visit);
+        
+        __m128i closing = _mm_and_si128(separator, active);
+        if (_mm_movemask_epi8(closing) == 0) continue;
+        __m256d closeMask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(closing));
+        
+        __m128i over = _mm_and_si128(_mm_cmpgt_epi32(load, capacity), closing);
+        __m256d overMask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(over));
+        __m256d violation = _mm256_cvtepi32_pd(_mm_sub_epi32(load, capacity));
+        totalPenalty = _mm256_blendv_pd(totalPenalty,
+                                        _mm256_add_pd(totalPenalty, _mm256_mul_pd(_mm256_set1_pd(1000.0), violation)),
+                                        overMask);
+        violated = _mm256_or_pd(violated, overMask);
+        if (checkTime) {
+            __m256d routeTime = _mm256_add_pd(routeCost, _mm256_mul_pd(_mm256_cvtepi32_pd(customers), serviceTime));
+            __m256d late = _mm256_and_pd(_mm256_cmp_pd(routeTime, maxDistance, _CMP_GT_OQ), closeMask);
+            __m256d timeViolation = _mm256_sub_pd(routeTime, maxDistance);
+            totalPenalty = _mm256_blendv_pd(totalPenalty,
+                                            _mm256_add_pd(totalPenalty, _mm256_mul_pd(_mm256_set1_pd(500.0), timeViolation)),
+                                            late);
+            violated = _mm256_or_pd(violated, late);
+        }
+        totalCost = _mm256_blendv_pd(totalCost, _mm256_add_pd(totalCost, routeCost), closeMask);
+        routeCost = _mm256_andnot_pd(closeMask, routeCost);
+        load = _mm_andnot_si128(closing, load);
+        customers = _mm_andnot_si128(closing, customers);
+        prev = _mm_blendv_epi8(prev, depot, closing);
+    }
+    
+    alignas(32) double result[4];
+    _mm256_store_pd(result, _mm256_add_pd(totalCost, totalPenalty));
+    int violatedBits = _mm256_movemask_pd(violated);
+    for (int l = 0; l < 4; ++l) {
+        fitness[l] = result[l];
+        feasible[l] = !((violatedBits >> l) & 1);
+    }
+}
+
+template <typename Gene>
+__attribute__((target("avx2,avx512f,avx512vl")))
+void fitnessLanesAVX512(const Gene* const* genes, const int* limits, const FitnessParams& p,
+                        double* fitness, char* feasible) {
+    const dist_t* base = p.dist->data();
+    const __m256i stride = _mm256_set1_epi32((int)p.dist->stride());
+    const __m256i depot = _mm256_set1_epi32(p.depot);
+    const __m256i capacity = _mm256_set1_epi32(p.capacity);
+    const __m256i zero = _mm256_setzero_si256();
+    // Như fitnessLanesAVX2: gather / chuyển kiểu dạng mask để không có nguồn chưa khởi tạo
+    const __m256i allLanes = _mm256_set1_epi32(-1);
+    const __m512d maxDistance = _mm512_set1_pd(p.maxDistance);
+    const __m512d serviceTime = _mm512_set1_pd(p.serviceTime);
+    const bool checkTime = p.maxDistance > 0.0;
+    const __m256i limit = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(limits));
+    int steps = *max_element(limits, limits + 8);
+    
+    __m256i prev = depot, load = zero, customers = zero;
+    __m512d routeCost = _mm512_setzero_pd(), totalCost = routeCost, totalPenalty = routeCost;
+    __mmask8 violated = 0;
+    auto gene = [&](int l, int pos) { return pos + 1 < limits[l] ? (int)genes[l][pos] : 0; };
+    
+    for (int pos = 0; pos < steps; ++pos) {
+        __m256i v = _mm256_setr_epi32(gene(0, pos), gene(1, pos), gene(2, pos), gene(3, pos),
+                                      gene(4, pos), gene(5, pos), gene(6, pos), gene(7, pos));
+        __mmask8 active = _mm256_cmpgt_epi32_mask(limit, _mm256_set1_epi32(pos));
+        __mmask8 separator = _mm256_cmpeq_epi32_mask(v, zero);
+        __m256i next = _mm256_mask_mov_epi32(v, separator, depot);
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(prev, stride), next);
+        __m512d d;
+        if (sizeof(dist_t) == sizeof(float)) {
+            d = _mm512_maskz_cvtps_pd(0xFF, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), reinterpret_cast<const float*>(base),
+                                                                      index, _mm256_castsi256_ps(allLanes), 4));
+        } else {
+            d = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, index, reinterpret_cast<const double*>(base), 8);
+        }
+        routeCost = _mm512_mask_add_pd(routeCost, active, routeCost, d);
+        
+        __mmask8 visit = active & ~separator;
+        __m256i demand = _mm256_mask_i32gather_epi32(zero, p.demand, v, allLanes, 4);
+        load = _mm256_mask_add_epi32(load, visit, load, demand);
+        customers = _mm256_mask_add_epi32(customers, visit, customers, _mm256_set1_epi32(1));
+        prev = _mm256_mask_mov_epi32(prev, visit, v);
+        
+        __mmask8 closing = active & separator;
+        if (!closing) continue;
+        
+        __mmask8 over = _mm256_mask_cmpgt_epi32_mask(closing, load, capacity);
+        __m512d violation = _mm512_maskz_cvtepi32_pd(0xFF, _mm256_sub_epi32(load, capacity));
+        totalPenalty = _mm512_mask_add_pd(totalPenalty, over, totalPenalty,
+                                          _mm512_mul_pd(_mm512_set1_pd(1000.0), violation));
+        violated |= over;
+        if (checkTime) {
+            __m512d routeTime = _mm512_add_pd(routeCost, _mm512_mul_pd(_mm512_maskz_cvtepi32_pd(0xFF, customers), serviceTime));
+            __mmask8 late = _mm512_mask_cmp_pd_mask(closing, routeTime, maxDistance, _CMP_GT_OQ);
+            totalPenalty = _mm512_mask_add_pd(totalPenalty, late, totalPenalty,
+                                              _mm512_mul_pd(_mm512_set1_pd(500.0), _mm512_sub_pd(routeTime, maxDistance)));
+            violated |= late;
+        }
+        totalCost = _mm512_mask_add_pd(totalCost, closing, totalCost, routeCost);
+        routeCost = _mm512_mask_mov_pd(routeCost, closing, _mm512_setzero_pd());
+        load = _mm256_mask_mov_epi32(load, closing, zero);
+        customers = _mm256_mask_mov_epi32(customers, closing, zero);
+        prev = _mm256_mask_mov_epi32(prev, closing, depot);
+    }
+    
+    alignas(64) double result[8];
+    _mm512_store_pd(result, _mm512_add_pd(totalCost, totalPenalty));
+    for (int l = 0; l < 8; ++l) {
+        fitness[l] = result[l];
+        feasible[l] = !((violated >> l) & 1);
+    }
+}
+#endif
+
+template <typename Gene>
+void evaluateBatchGenes(const ChromosomeArena& arena, const int* indices, size_t count, const FitnessParams& p,
+                        double* fitness, char* feasible, SimdLevel level) {
+    size_t done = 0;
+#ifdef CVRP_X86_SIMD
+    // Chỉ số gather 32 bit và demand không cần kiểm tra biên; on-demand không có khối để gather
+    bool vectorizable = !p.dist->onDemand() && (double)p.dist->size() * p.dist->stride() < (double)INT_MAX
+                     && arena.maxNode() < p.demandSize;
+    int lanes = level == SimdLevel::AVX512 ? 8 : level == SimdLevel::AVX2 ? 4 : 0;
+    if (vectorizable && lanes > 0) {
+        const Gene* genes[8];
+        int limits[8];
+        double laneFitness[8];
+        char laneFeasible[8];
+        for (; done < count; done += lanes) {
+            int used = min((size_t)lanes, count - done);
+            for (int l = 0; l < lanes; ++l) {
+                size_t i = l < used ? indices[done + l] : 0;
+                genes[l] = arena.genes<Gene>(i);
+                limits[l] = l < used && arena.length(i) > 0 ? (int)arena.length(i) + 1 : 0;
+            }
+            if (lanes == 8) fitnessLanesAVX512(genes, limits, p, laneFitness, laneFeasible);
+            else fitnessLanesAVX2(genes, limits, p, laneFitness, laneFeasible);
+            for (int l = 0; l < used; ++l) {
+                if (limits[l] == 0) { // seq rỗng
+                    laneFitness[l] = 1e6;
+                    laneFeasible[l] = 1;
+                }
+                fitness[done + l] = laneFitness[l];
+                feasible[done + l] = laneFeasible[l];
+            }
+        }
+    }
+#else
+    (void)level;
+#endif
+    for (; done < count; ++done) {
+        size_t i = indices[done];
+        bool ok;
+        fitness[done] = fitnessOfGenes(arena.genes<Gene>(i), arena.length(i), p, ok);
+        feasible[done] = ok;
+    }
+}
+
+// Đánh giá các cá thể indices[0..count) của arena: fitness[k], feasible[k] của indices[k]
+void evaluateBatch(const ChromosomeArena& arena, const int* indices, size_t count, const FitnessParams& p,
+                   double* fitness, char* feasible, SimdLevel level = fitnessSimd()) {
+    if (arena.width() == 2) evaluateBatchGenes<uint16_t>(arena, indices, count, p, fitness, feasible, level);
+    else evaluateBatchGenes<uint32_t>(arena, indices, count, p, fitness, feasible, level);
+}
+
+// Đánh giá các cá thể chưa có fitness và sắp xếp lại fitnessIndex.
+// Trả về số lần gọi calculateFitness thực sự. fitnessIndex đủ kích thước và không có
+// cá thể mới (steady-state engine tự cập nhật index) thì giữ nguyên, không sort lại.
+int evaluatePopulation(Population& pop, const vector<pair<double,double>>& coords,
+                       const vector<int>& demand, int capacity, int depot,
+                       const DistMatrix& dist,
+                       double maxDistance = 0.0, double serviceTime = 0.0) {
+    if (pop.fitnessIndex.size() == pop.size()
+        && find(pop.evaluated.begin(), pop.evaluated.end(), 0) == pop.evaluated.end()) {
+        return 0;
+    }
+    int evaluations = 0;
+    pop.fitnessIndex.clear();
+    pop.fitnessIndex.reserve(pop.size());
+
+    ScopedPhase phase(PHASE_EVALUATION);
+    if (dist.empty()) {
+        vector<int>& seq = geneScratch().decoded;
+        for (size_t i = 0; i < pop.size(); ++i) {
+            if (pop.evaluated[i]) continue;
+            pop.individual(i, seq);
+            pop.fitness[i] = calculateFitness(seq, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+            pop.feasible[i] = validateCapacity(seq, demand, capacity, depot, dist, maxDistance, serviceTime);
+            pop.evaluated[i] = 1;
+            evaluations++;
+        }
+    } else if (fitnessSimd() == SimdLevel::Scalar) {
+        // Không có SIMD: kernel streaming một lượt (fitness + feasible) cho từng cá thể, đọc
+        // thẳng gene trong arena, không gom batch / lane
+        const ChromosomeArena& arena = pop.genes;
+        FitnessParams params(dist, demand, capacity, depot, maxDistance, serviceTime);
+        for (size_t i = 0; i < pop.size(); ++i) {
+            if (pop.evaluated[i]) continue;
+            bool ok;
+            pop.fitness[i] = arena.width() == 2 ? fitnessOfGenes(arena.genes<uint16_t>(i), arena.length(i), params, ok)
+                                                : fitnessOfGenes(arena.genes<uint32_t>(i), arena.length(i), params, ok);
+            pop.feasible[i] = ok;
+            pop.evaluated[i] = 1;
+            evaluations++;
+        }
+    } else {
+        // Batch kernel SIMD đọc thẳng gene trong arena
+        static thread_local vector<int> pending;
+        static thread_local vector<double> fitness;
+        static thread_local vector<char> feasible;
+        pending.clear();
+        for (size_t i = 0; i < pop.size(); ++i) {
+            if (!pop.evaluated[i]) pending.push_back(i);
+        }
+        fitness.resize(pending.size());
+        feasible.resize(pending.size());
+        evaluateBatch(pop.genes, pending.data(), pending.size(),
+                      FitnessParams(dist, demand, capacity, depot, maxDistance, serviceTime),
+                      fitness.data(), feasible.data());
+        for (size_t k = 0; k < pending.size(); ++k) {
+            int i = pending[k];
+            pop.fitness[i] = fitness[k];
+            pop.feasible[i] = feasible[k];
+            pop.evaluated[i] = 1;
+        }
+        evaluations = pending.size();
+    }
+    for (size_t i = 0; i < pop.size(); ++i) pop.fitnessIndex.push_back({pop.fitness[i], (int)i});
+    ScopedPhase sortPhase(PHASE_SORT);
+    sort(pop.fitnessIndex.begin(), pop.fitnessIndex.end());
+    return evaluations;
+}
+
+// ======= FEASIBILITY TRACKING =======
+
+// FeasibleSolution: xem cvrp_solver.h
+
+// Hàm lấy feasible solution tốt nhất từ một generation
+// (population phải đã được evaluatePopulation cho generation này)
+FeasibleSolution getBestFeasibleFromGeneration(const Population& population, int generation) {
+    
+    FeasibleSolution bestFeasible;
+    int feasibleCount = 0;
+    
+    // Duyệt population theo thứ tự fitness tốt nhất trước
+    for (const auto& entry : population.fitnessIndex) {
         double fitness = entry.first;
         int index = entry.second;
-        const vector<int>& individual = population[index];
         
-        // Kiểm tra feasibility với cả capacity và distance constraints
-        bool isFeasible = validateCapacity(individual, demand, capacity, depot, dist, maxDistance, serviceTime);
-        
-        if (isFeasible) {
+        // Feasibility (capacity + distance) đã được cache khi đánh giá
+        if (population.feasible[index]) {
             feasibleCount++;
             // Nếu đây là feasible solution tốt nhất cho đến nay
             if (fitness < bestFeasible.cost) {
-                bestFeasible = FeasibleSolution(individual, fitness, generation, true);
+                bestFeasible = FeasibleSolution(population.individual(index), fitness, generation, true);
             }
         }
     }
     
-    // Log thông tin mỗi 10 generations
-    if (generation % 10 == 0 || generation == 1) {
-        cout << "   Generation " << generation << ": " << feasibleCount << "/" 
-             << population.size() << " feasible solutions" << endl;
+    // Log thông tin mỗi 10 generations (chỉ có trong bản debug)
+    if ((generation % 10 == 0 || generation == 1) && logEnabled(LOG_DEBUG)) {
+        gaOut() << "   Generation " << generation << ": " << feasibleCount << "/" 
+             << population.size() << " feasible solutions" << '\n';
         
         if (bestFeasible.isFeasible) {
-            cout << "   Best feasible cost: " << bestFeasible.cost << endl;
+            gaOut() << "   Best feasible cost: " << bestFeasible.cost << '\n';
         }
     }
     
     return bestFeasible;
 }
 
-// Hàm update global best feasible
-void updateGlobalBestFeasible(FeasibleSolution& globalBest, const FeasibleSolution& candidate) {
+// Hàm update global best feasible; trả về true nếu globalBest được thay
+bool updateGlobalBestFeasible(FeasibleSolution& globalBest, const FeasibleSolution& candidate) {
     if (candidate.isFeasible && candidate.cost < globalBest.cost) {
         globalBest = candidate;
-        cout << " NEW GLOBAL BEST FEASIBLE: " << candidate.cost 
-             << " (generation " << candidate.generation << ")" << endl;
+        GA_LOG(LOG_INFO) << " NEW GLOBAL BEST FEASIBLE: " << candidate.cost 
+             << " (generation " << candidate.generation << ")" << '\n';
+        return true;
     }
+    return false;
 }
 
 // ======= SOLUTION DISPLAY =======
 
 void displaySolution(const vector<int>& sequence, const vector<pair<double,double>>& coords,
                     const vector<int>& demand, int capacity, int depot, 
-                    const vector<vector<double>>& dist, double maxDistance = 0.0, double serviceTime = 0.0) {
+                    const DistMatrix& dist, double maxDistance = 0.0, double serviceTime = 0.0) {
     
+    if (!logEnabled(LOG_INFO)) return;
     if (sequence.empty()) {
-        cout << "Empty solution!" << endl;
+        gaOut() << "Empty solution!" << endl;
         return;
     }
     
@@ -1934,15 +3469,15 @@ void displaySolution(const vector<int>& sequence, const vector<pair<double,doubl
     int totalVehicles = routes.size();
     bool allFeasible = true;
     
-    cout << "Number of vehicles used: " << totalVehicles << endl;
-    cout << "Vehicle capacity: " << capacity << endl;
+    gaOut() << "Number of vehicles used: " << totalVehicles << endl;
+    gaOut() << "Vehicle capacity: " << capacity << endl;
     if (maxDistance > 0.0) {
-        cout << "Maximum distance/time per route: " << maxDistance << endl;
+        gaOut() << "Maximum distance/time per route: " << maxDistance << endl;
     }
     if (serviceTime > 0.0) {
-        cout << "Service time per customer: " << serviceTime << endl;
+        gaOut() << "Service time per customer: " << serviceTime << endl;
     }
-    cout << "\nRoute details:" << endl;
+    gaOut() << "\nRoute details:" << endl;
     
     for (size_t i = 0; i < routes.size(); ++i) {
         // Calculate route demand
@@ -1962,38 +3497,38 @@ void displaySolution(const vector<int>& sequence, const vector<pair<double,doubl
         // Calculate route time = travel time + service time
         double routeTime = calculateRouteTime(routes[i], dist, serviceTime);
         
-        cout << "Route " << (i + 1) << ": ";
-        for (int v : routes[i]) cout << v << " ";
-        cout << "| Cost: " << fixed << setprecision(2) << routeCost;
-        cout << " | Demand: " << routeDemand << "/" << capacity;
+        gaOut() << "Route " << (i + 1) << ": ";
+        for (int v : routes[i]) gaOut() << v << " ";
+        gaOut() << "| Cost: " << fixed << setprecision(2) << routeCost;
+        gaOut() << " | Demand: " << routeDemand << "/" << capacity;
         
         if (maxDistance > 0.0) {
-            cout << " | Time: " << fixed << setprecision(2) << routeTime << "/" << maxDistance;
+            gaOut() << " | Time: " << fixed << setprecision(2) << routeTime << "/" << maxDistance;
         }
         
         bool routeFeasible = true;
         if (routeDemand > capacity) {
-            cout << "  CAPACITY VIOLATION!";
+            gaOut() << "  CAPACITY VIOLATION!";
             routeFeasible = false;
         }
         if (maxDistance > 0.0 && routeTime > maxDistance) {
-            cout << "  TIME VIOLATION!";
+            gaOut() << "  TIME VIOLATION!";
             routeFeasible = false;
         }
         if (routeFeasible) {
-            cout << " ✓";
+            gaOut() << " ✓";
         }
         
         allFeasible = allFeasible && routeFeasible;
-        cout << endl;
+        gaOut() << endl;
         
         totalCost += routeCost;
     }
     
-    cout << "\n SUMMARY:" << endl;
-    cout << "Total cost: " << fixed << setprecision(2) << totalCost << endl;
-    cout << "Total vehicles: " << totalVehicles << endl;
-    cout << "Solution status: " << (allFeasible ? "FEASIBLE" : "INFEASIBLE") << endl;
+    gaOut() << "\n SUMMARY:" << endl;
+    gaOut() << "Total cost: " << fixed << setprecision(2) << totalCost << endl;
+    gaOut() << "Total vehicles: " << totalVehicles << endl;
+    gaOut() << "Solution status: " << (allFeasible ? "FEASIBLE" : "INFEASIBLE") << endl;
     
     if (allFeasible) {
         // Calculate utilization
@@ -2004,228 +3539,1673 @@ void displaySolution(const vector<int>& sequence, const vector<pair<double,doubl
             }
         }
         double utilization = (double)totalDemandServed / (totalVehicles * capacity) * 100;
-        cout << "Vehicle utilization: " << fixed << setprecision(1) << utilization << "%" << endl;
+        gaOut() << "Vehicle utilization: " << fixed << setprecision(1) << utilization << "%" << endl;
     }
 }
 
+// ======= PARALLEL WORKERS =======
+
+// Thread pool cố định cho các bước song song của GA. run(job) gọi job(worker)
+// với mọi worker trong [0, size()) và chờ tất cả hoàn thành; thread gọi run()
+// tự đảm nhận worker 0. Với 1 thread, job chạy trực tiếp không qua đồng bộ.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) : workerCount(max(1, threads)) {
+        for (int w = 1; w < workerCount; ++w) {
+            threads_.emplace_back([this, w]() { workerLoop(w); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cvStart.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return workerCount; }
+
+    void run(const function<void(int)>& job) {
+        if (workerCount == 1) {
+            job(0);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(mtx);
+            currentJob = &job;
+            pending = workerCount - 1;
+            ++epoch;
+        }
+        cvStart.notify_all();
+        job(0);
+        unique_lock<mutex> lock(mtx);
+        cvDone.wait(lock, [this]() { return pending == 0; });
+        currentJob = nullptr;
+    }
+
+private:
+    void workerLoop(int worker) {
+        unsigned long long seenEpoch = 0;
+        while (true) {
+            const function<void(int)>* job;
+            {
+                unique_lock<mutex> lock(mtx);
+                cvStart.wait(lock, [&]() { return stopping || epoch != seenEpoch; });
+                if (stopping) return;
+                seenEpoch = epoch;
+                job = currentJob;
+            }
+            (*job)(worker);
+            {
+                lock_guard<mutex> lock(mtx);
+                if (--pending == 0) cvDone.notify_one();
+            }
+        }
+    }
+
+    int workerCount;
+    vector<thread> threads_;
+    mutex mtx;
+    condition_variable cvStart, cvDone;
+    const function<void(int)>* currentJob = nullptr;
+    unsigned long long epoch = 0;
+    int pending = 0;
+    bool stopping = false;
+};
+
+int resolveThreadCount(int requested) {
+    if (requested > 0) return requested;
+    unsigned int hw = thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+class PopulationDiversity;
+
+// Worker cho bước sinh con: thread pool + một mt19937 riêng cho mỗi worker.
+// Seed của worker w được suy ra từ run seed nên kết quả tái lập được
+// với cùng số thread (mỗi worker luôn xử lý cùng tập cặp cha mẹ).
+struct ReproductionContext {
+    ThreadPool pool;
+    vector<mt19937> rngs;
+    Decoder decoder = Decoder::Separators; // cách cắt tuyến của con sinh ra
+    AdaptiveOperators* adaptive = nullptr; // chọn operator theo gain / µs (--adaptive-operators)
+    LocalSearch* localSearch = nullptr;    // local search một phần con (--local-search)
+    PopulationDiversity* diversity = nullptr; // loại trùng + biased fitness (--diversity)
+
+    ReproductionContext(int threads, unsigned int runSeed) : pool(threads) {
+        for (int w = 0; w < pool.size(); ++w) {
+            seed_seq seq{runSeed, (unsigned int)w, 0x9e3779b9u};
+            rngs.emplace_back(seq);
+        }
+    }
+};
+
+// Sinh các cá thể [begin, end) của initializer trên pool, đã repair đầy đủ, ghi vào
+// out[index - begin]. Worker lấy index qua bộ đếm chung (chi phí các phương pháp khác
+// nhau nhiều); mỗi cá thể có RNG riêng nên kết quả không phụ thuộc số thread.
+void buildInitialIndividuals(const StructuredInitializer& initializer, int begin, int end,
+                             ThreadPool& pool, vector<vector<int>>& out) {
+    out.assign(max(0, end - begin), vector<int>());
+    atomic<int> next(begin);
+    pool.run([&](int) {
+        for (int index = next++; index < end; index = next++) {
+            out[index - begin] = initializer.build(index, true);
+        }
+    });
+}
+
+// ======= DIVERSITY MANAGEMENT =======
+
+// Chống hội tụ sớm (--diversity, --restart-after):
+//  - Hash kiểu Zobrist của lời giải: tổng (mod 2^64) khóa ngẫu nhiên của mọi cạnh vô hướng,
+//    không phụ thuộc thứ tự / chiều tuyến, nên hai chromosome cùng tập tuyến trùng hash.
+//    Cộng thay vì XOR để cạnh lặp (depot - c - depot) không tự triệt tiêu. Con sinh ra qua
+//    crossover + repair + local search nên hash được tính lại O(n) cho mỗi cá thể được
+//    xét vào thế hệ mới; tập hash dựng lại mỗi generation.
+//  - Broken-pairs distance trên bitset cạnh: mỗi generation đánh số các cạnh có mặt trong
+//    population, mỗi cá thể một hàng bit; d(a, b) = 1 - |E_a ∩ E_b| / max(|E_a|, |E_b|).
+//  - Biased fitness (như HGS): hạng fitness + weight * hạng đóng góp đa dạng (khoảng cách
+//    trung bình tới closest cá thể gần nhất), dùng để chọn cá thể sống sót.
+
+struct DiversityOptions {
+    bool enabled = false; // loại con trùng lặp + chọn sống sót theo biased fitness
+    int closest = 5;      // số cá thể gần nhất khi tính đóng góp đa dạng
+    int restartAfter = 0; // khởi tạo lại population sau mỗi G generation không cải thiện, 0 = tắt
+    double restartKeep = 0.05; // tỉ lệ cá thể tốt nhất giữ lại khi restart
+    // Trọng số hạng đa dạng. HGS dùng 1 - elite / N, nhưng ở đây chỉ 15% elite được giữ làm
+    // cha mẹ; trọng số lớn hơn ~0.3 đẩy cá thể tệ vào elite (thử trên CMT5)
+    double weight = 0.3;
+};
+
+inline uint64_t edgeKey(int a, int b) {
+    if (a > b) swap(a, b);
+    uint64_t z = ((uint64_t)(uint32_t)a << 32 | (uint32_t)b) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Gọi f(a, b) cho mọi cạnh của các tuyến khác rỗng (depot ở hai đầu mỗi tuyến)
+template <typename F>
+void forEachEdge(const vector<int>& seq, int depot, F&& f) {
+    int prev = depot;
+    for (int v : seq) {
+        if (v == 0) {
+            if (prev != depot) f(prev, depot);
+            prev = depot;
+            continue;
+        }
+        f(prev, v);
+        prev = v;
+    }
+    if (prev != depot) f(prev, depot);
+}
+
+uint64_t solutionHash(const vector<int>& seq, int depot) {
+    uint64_t hash = 0;
+    forEachEdge(seq, depot, [&](int a, int b) { hash += edgeKey(a, b); });
+    return hash;
+}
+
+// Hash của các lời giải đã vào thế hệ đang dựng: thêm / kiểm tra trùng O(1) trung bình.
+// Thay thế theo thế hệ điền lại mọi slot của newGen, nên tập chỉ sống trong một lần
+// newGeneration (clear() giữ bucket, không cấp phát lại); giữ qua các generation thì cũng
+// phải xóa hết hash của thế hệ cũ. Steady-state xóa / thêm từng cá thể: xem
+// SteadyStateEngine::tours_.
+class SolutionHashSet {
+public:
+    void clear() { hashes_.clear(); }
+    bool contains(uint64_t hash) const { return hashes_.count(hash) > 0; }
+    void add(uint64_t hash) { hashes_.insert(hash); }
+    
+private:
+    unordered_set<uint64_t> hashes_;
+};
+
+// Số bit chung của hai hàng bitset. Build mặc định không bật -mpopcnt, nên bản dùng lệnh
+// POPCNT được chọn lúc chạy (nhanh ~3 lần so với popcount phần mềm trên hàng dài).
+int commonEdgesPortable(const uint64_t* a, const uint64_t* b, int words) {
+    int common = 0;
+    for (int w = 0; w < words; ++w) common += __builtin_popcountll(a[w] & b[w]);
+    return common;
+}
+
+#ifdef CVRP_X86_SIMD
+__attribute__((target("popcnt")))
+int commonEdgesPopcnt(const uint64_t* a, const uint64_t* b, int words) {
+    int common = 0;
+    for (int w = 0; w < words; ++w) common += __builtin_popcountll(a[w] & b[w]);
+    return common;
+}
+#endif
+
+typedef int (*CommonEdgesFn)(const uint64_t*, const uint64_t*, int);
+
+CommonEdgesFn commonEdgeCount() {
+#ifdef CVRP_X86_SIMD
+    if (__builtin_cpu_supports("popcnt")) return commonEdgesPopcnt;
+#endif
+    return commonEdgesPortable;
+}
+
+class PopulationDiversity {
+public:
+    PopulationDiversity(const DiversityOptions& options, int depot) : options_(options), depot_(depot) {}
+    
+    const DiversityOptions& options() const { return options_; }
+    
+    // Thứ tự sống sót của population đã đánh giá: (biased fitness, index) tăng dần, cá thể
+    // có fitness tốt nhất luôn đứng đầu. Trọng số hạng đa dạng: options().weight.
+    const vector<pair<double, int>>& rank(const Population& population, ThreadPool& pool) {
+        int size = population.size();
+        buildEdgeSets(population);
+        
+        // Đóng góp đa dạng: khoảng cách trung bình tới closest cá thể gần nhất
+        contribution_.assign(size, 0.0);
+        int closest = max(1, min(options_.closest, size - 1));
+        int workers = pool.size();
+        pool.run([&](int worker) {
+            vector<double>& row = rowScratch();
+            for (int i = worker; i < size; i += workers) {
+                row.clear();
+                for (int j = 0; j < size; ++j) {
+                    if (j != i) row.push_back(distance(i, j));
+                }
+                if (row.empty()) continue;
+                int k = min(closest, (int)row.size());
+                nth_element(row.begin(), row.begin() + (k - 1), row.end());
+                contribution_[i] = accumulate(row.begin(), row.begin() + k, 0.0) / k;
+            }
+        });
+        
+        // Biased fitness theo hạng, chuẩn hóa về [0, 1]
+        byDiversity_.resize(size);
+        for (int i = 0; i < size; ++i) byDiversity_[i] = {-contribution_[i], i};
+        sort(byDiversity_.begin(), byDiversity_.end());
+        fitnessRank_.resize(size);
+        for (int r = 0; r < size; ++r) fitnessRank_[population.fitnessIndex[r].second] = r;
+        double scale = size > 1 ? 1.0 / (size - 1) : 0.0;
+        double weight = options_.weight;
+        order_.resize(size);
+        double total = 0.0;
+        for (int r = 0; r < size; ++r) {
+            int i = byDiversity_[r].second;
+            order_[r] = {fitnessRank_[i] * scale + weight * r * scale, i};
+            total += contribution_[i];
+        }
+        sort(order_.begin(), order_.end());
+        if (size > 0) {
+            int best = population.fitnessIndex[0].second;
+            auto it = find_if(order_.begin(), order_.end(), [best](const pair<double, int>& e) { return e.second == best; });
+            rotate(order_.begin(), it, it + 1);
+        }
+        meanDistance_ = size > 0 ? total / size : 0.0;
+        return order_;
+    }
+    
+    // Tập hash của thế hệ đang được dựng (newGeneration)
+    SolutionHashSet& hashes() { return hashes_; }
+    
+    void countDuplicate() { duplicates_++; }
+    void countRestart() { restarts_++; }
+    long long duplicates() const { return duplicates_; }
+    long long restarts() const { return restarts_; }
+    double meanDistance() const { return meanDistance_; } // của lần rank() gần nhất
+    
+private:
+    // Đánh số các cạnh có trong population (bảng băm địa chỉ mở trên khóa a << 32 | b, a < b),
+    // rồi đặt bit của từng cá thể
+    void buildEdgeSets(const Population& population) {
+        int size = population.size();
+        edgeIds_.resize(size);
+        size_t occurrences = 0;
+        vector<int>& seq = geneScratch().decoded;
+        for (int i = 0; i < size; ++i) {
+            population.individual(i, seq);
+            vector<uint64_t>& keys = edgeIds_[i];
+            keys.clear();
+            forEachEdge(seq, depot_, [&](int a, int b) {
+                if (a > b) swap(a, b);
+                keys.push_back((uint64_t)(uint32_t)a << 32 | (uint32_t)b);
+            });
+            occurrences += keys.size();
+        }
+        
+        size_t slots = 64;
+        while (slots < 2 * occurrences) slots *= 2;
+        slotKeys_.assign(slots, 0); // node >= 1 nên khóa 0 = ô trống
+        slotIds_.resize(slots);
+        int edges = 0;
+        for (auto& keys : edgeIds_) {
+            for (uint64_t& key : keys) {
+                size_t slot = edgeKey((int)(key >> 32), (int)(uint32_t)key) & (slots - 1);
+                while (slotKeys_[slot] != 0 && slotKeys_[slot] != key) slot = (slot + 1) & (slots - 1);
+                if (slotKeys_[slot] == 0) {
+                    slotKeys_[slot] = key;
+                    slotIds_[slot] = edges++;
+                }
+                key = slotIds_[slot]; // từ đây giữ id của cạnh
+            }
+        }
+        
+        words_ = (edges + 63) / 64;
+        bits_.assign((size_t)size * words_, 0);
+        edgeCount_.assign(size, 0);
+        for (int i = 0; i < size; ++i) {
+            uint64_t* row = &bits_[(size_t)i * words_];
+            for (uint64_t id : edgeIds_[i]) row[id >> 6] |= 1ull << (id & 63);
+            int count = 0;
+            for (int w = 0; w < words_; ++w) count += __builtin_popcountll(row[w]);
+            edgeCount_[i] = count;
+        }
+    }
+    
+    double distance(int i, int j) const {
+        int common = commonEdges_(&bits_[(size_t)i * words_], &bits_[(size_t)j * words_], words_);
+        int larger = max(edgeCount_[i], edgeCount_[j]);
+        return larger > 0 ? 1.0 - (double)common / larger : 0.0;
+    }
+    
+    static vector<double>& rowScratch() {
+        static thread_local vector<double> row;
+        return row;
+    }
+    
+    DiversityOptions options_;
+    int depot_;
+    CommonEdgesFn commonEdges_ = commonEdgeCount();
+    vector<vector<uint64_t>> edgeIds_; // khóa cạnh, sau khi đánh số là id
+    vector<uint64_t> slotKeys_;
+    vector<int> slotIds_;
+    vector<uint64_t> bits_;       // size x words_, hàng i = cạnh của cá thể i
+    int words_ = 0;
+    vector<int> edgeCount_;
+    vector<double> contribution_;
+    vector<pair<double, int>> byDiversity_;
+    vector<int> fitnessRank_;
+    vector<pair<double, int>> order_;
+    SolutionHashSet hashes_;
+    long long duplicates_ = 0, restarts_ = 0;
+    double meanDistance_ = 0.0;
+};
+
 // ======= GENETIC ALGORITHM =======
 
-vector<vector<int>> newGeneration(const vector<vector<int>>& population, int depot, 
-                                 const vector<vector<double>>& dist, int n, int vehicle, 
-                                 const vector<int>& demand, int capacity, const vector<pair<double,double>>& coords,
-                                 double maxDistance = 0.0, double serviceTime = 0.0) {
+// Sinh một cặp con từ hai cha mẹ (chỉ số trong population): crossover (đã gồm
+// repair + 2-opt) và mutation. Chỉ dùng gen được truyền vào nên có thể gọi đồng thời
+// từ nhiều worker.
+// Decoder::Split: crossover và mutation bỏ qua time repair, cuối cùng splitTour chia lại
+// tuyến tối ưu cho thứ tự customers của con; chỉ khi không chia được mới repair đầy đủ.
+void reproduceParents(const Population& population, int parent1, int parent2,
+                      vector<int>& child1, vector<int>& child2, int n, int vehicle,
+                      const vector<int>& demand, int capacity, int depot,
+                      mt19937& gen, const DistMatrix& dist,
+                      double maxDistance, double serviceTime,
+                      Decoder decoder = Decoder::Separators,
+                      AdaptiveOperators* adaptive = nullptr, int worker = 0,
+                      LocalSearch* localSearch = nullptr) {
+    uniform_real_distribution<> crossoverChoice(0.0, 1.0);
+    uniform_real_distribution<> mutProb(0.0, 1.0);
+    bool split = decoder == Decoder::Split;
+    double fullMaxDistance = maxDistance;
+    if (split) maxDistance = 0.0;
+    
+    // Cha mẹ giải mã từ arena vào bộ đệm của thread
+    GeneScratch& scratch = geneScratch();
+    population.individual(parent1, scratch.parent1);
+    population.individual(parent2, scratch.parent2);
+    
+    // Choose crossover operator (4 operators with balanced probabilities, hoặc adaptive)
+    double choice = crossoverChoice(gen);
+    int op = adaptive ? adaptive->crossover().pick(choice)
+                      : pickOperator(CROSSOVER_WEIGHTS, CROSSOVER_COUNT, choice);
+    auto start = chrono::steady_clock::now();
+    
+    ScopedPhase crossoverPhase(PHASE_CROSSOVER);
+    switch (op) {
+        case CROSSOVER_ONE_POINT:
+            crossoverOnePoint(scratch.parent1, scratch.parent2, child1, child2,
+                              n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
+            break;
+        case CROSSOVER_OX:
+            crossoverOX(scratch.parent1, scratch.parent2, child1, child2,
+                        n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
+            break;
+        case CROSSOVER_PMX:
+            crossoverPMX(scratch.parent1, scratch.parent2, child1, child2,
+                         n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
+            break;
+        default:
+            crossoverSREX(scratch.parent1, scratch.parent2, child1, child2,
+                          n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
+            break;
+    }
+    
+    // Credit: mức con tốt hơn cha mẹ tốt hơn (fitness đã cache trong population), trên µs
+    if (adaptive) {
+        FitnessParams params(dist, demand, capacity, depot, fullMaxDistance, serviceTime);
+        double parentBest = min(population.fitness[parent1], population.fitness[parent2]);
+        double gain = 0.0;
+        for (const vector<int>* child : {&child1, &child2}) {
+            bool feasible;
+            gain += max(0.0, parentBest - fitnessOfGenes(child->data(), child->size(), params, feasible));
+        }
+        adaptive->stats(worker).crossover[op].add(gain, microsSince(start));
+    }
+    
+    // Apply mutation with adaptive probability
+    double mutationProb = (n > 100) ? 0.30 : 0.20; // Higher for large problems
+    ScopedPhase mutationPhase(PHASE_MUTATION);
+    if (mutProb(gen) < mutationProb) {
+        mutate(child1, n, vehicle, demand, capacity, gen, dist, depot, maxDistance, serviceTime, adaptive, worker);
+    }
+    
+    if (mutProb(gen) < mutationProb) {
+        mutate(child2, n, vehicle, demand, capacity, gen, dist, depot, maxDistance, serviceTime, adaptive, worker);
+    }
+    
+    if (split) {
+        ScopedPhase repairPhase(PHASE_REPAIR);
+        for (vector<int>* child : {&child1, &child2}) {
+            if (splitTour(*child, vehicle, demand, capacity, depot, dist, fullMaxDistance, serviceTime)) continue;
+            if (fullMaxDistance > 0.0) {
+                repairCustomerWithLocalSearch(*child, n, gen, dist, demand, capacity, depot, fullMaxDistance,
+                                              serviceTime, vehicle);
+                repairZero(*child, vehicle, gen);
+            }
+        }
+    }
+    
+    if (localSearch) {
+        for (vector<int>* child : {&child1, &child2}) {
+            localSearch->maybeImprove(*child, gen, worker, dist, demand, capacity, depot, fullMaxDistance, serviceTime);
+        }
+    }
+}
+
+// Sinh một cặp con với 2 cha mẹ khác nhau chọn ngẫu nhiên trong parentPool
+void reproducePair(const Population& population, const vector<int>& parentPool,
+                   vector<int>& child1, vector<int>& child2, int n, int vehicle,
+                   const vector<int>& demand, int capacity, int depot,
+                   mt19937& gen, const DistMatrix& dist,
+                   double maxDistance, double serviceTime,
+                   Decoder decoder = Decoder::Separators,
+                   AdaptiveOperators* adaptive = nullptr, int worker = 0,
+                   LocalSearch* localSearch = nullptr) {
+    uniform_int_distribution<> parentDis(0, max(0, (int)parentPool.size()-1));
     
-    // Calculate fitness once
-    vector<pair<double, int>> fitnessIndex;
-    fitnessIndex.reserve(population.size());
+    // Select two different parents
+    int idx1 = parentDis(gen);
+    int idx2 = parentDis(gen);
     
-    for(size_t i = 0; i < population.size(); i++){
-        double fitness = calculateFitness(population[i], coords, demand, capacity, depot, dist, maxDistance, serviceTime);
-        fitnessIndex.push_back({fitness, (int)i});
+    // Ensure parents are different
+    int attempts = 0;
+    while (idx2 == idx1 && parentPool.size() > 1 && attempts < 10) {
+        idx2 = parentDis(gen);
+        attempts++;
     }
-    sort(fitnessIndex.begin(), fitnessIndex.end());
     
-    vector<vector<int>> newGen;
+    reproduceParents(population, parentPool[idx1], parentPool[idx2], child1, child2, n, vehicle, demand, capacity,
+                     depot, gen, dist, maxDistance, serviceTime, decoder, adaptive, worker, localSearch);
+}
+
+// Bộ đệm của bước tạo thế hệ, giữ qua các generation của một run: sau vài generation
+// đầu mọi vector đã đủ capacity, phần chọn lọc / ghép thế hệ không còn cấp phát heap.
+struct GenerationBuffers {
+    Population spare;                 // population thứ hai của double buffer
+    vector<int> remainingIndices;
+    vector<int> parentPool;           // chỉ số cha mẹ trong population hiện tại
+    vector<pair<vector<int>, vector<int>>> childPairs;
+    vector<int> individual;           // cá thể đột biến khi thiếu con
+    vector<int> elites;               // chỉ số elite được giữ trong population hiện tại
+};
+
+// Tạo thế hệ mới từ population đã được đánh giá (fitnessIndex đã sắp xếp) vào newGen
+// (nội dung cũ bị xóa, capacity giữ lại). Elite và random parent được chép thẳng slot
+// kèm fitness cũ; chỉ con mới cần đánh giá lại.
+// repro == nullptr: sinh con tuần tự với RNG từ random_device như trước.
+void newGeneration(const Population& population, Population& newGen, GenerationBuffers& buffers,
+                   int depot, const DistMatrix& dist, int n, int vehicle, 
+                   const vector<int>& demand, int capacity,
+                   double maxDistance = 0.0, double serviceTime = 0.0,
+                   ReproductionContext* repro = nullptr) {
+    
+    const vector<pair<double, int>>& fitnessIndex = population.fitnessIndex;
+    
+    // Selection = chọn elite / random survivor / parent pool và ghép thế hệ mới;
+    // crossover, mutation, repair bên trong được tính vào phase riêng
+    ScopedPhase selectionPhase(PHASE_SELECTION);
     int popSize = population.size();
+    if (newGen.genes.maxNode() != population.genes.maxNode()) newGen = Population(population.genes.maxNode());
+    newGen.clear();
+    newGen.reserve(popSize, population.genes.stride());
     
     // Calculate number of individuals for each category
     int bestParentCount = max(1, (int)(popSize * 0.15)); // 15% best parents
     int randomParentCount = max(1, (int)(popSize * 0.15)); // 15% random parents
     int childrenCount = popSize - bestParentCount - randomParentCount; // ~70% children
     
+    unique_ptr<ReproductionContext> localRepro;
+    if (!repro) {
+        localRepro.reset(new ReproductionContext(1, random_device{}()));
+        repro = localRepro.get();
+    }
+    mt19937& gen = repro->rngs[0];
+    
+    // --diversity: chọn sống sót theo biased fitness thay vì fitness, và mỗi lời giải
+    // (solutionHash) chỉ vào thế hệ mới một lần
+    PopulationDiversity* diversity = repro->diversity;
+    const vector<pair<double, int>>& order = diversity ? diversity->rank(population, repro->pool) : fitnessIndex;
+    if (diversity) diversity->hashes().clear();
+    auto admit = [&](const vector<int>& seq) {
+        if (!diversity) return true;
+        uint64_t hash = solutionHash(seq, depot);
+        if (diversity->hashes().contains(hash)) {
+            diversity->countDuplicate();
+            return false;
+        }
+        diversity->hashes().add(hash);
+        return true;
+    };
+    auto admitIndex = [&](int index) {
+        if (!diversity) return true;
+        population.individual(index, buffers.individual);
+        return admit(buffers.individual);
+    };
+    
     // 1. Keep best parents (15%)
-    for (int i = 0; i < bestParentCount && i < (int)fitnessIndex.size(); ++i) {
-        newGen.push_back(population[fitnessIndex[i].second]);
+    vector<int>& elites = buffers.elites;
+    elites.clear();
+    size_t ranked = 0;
+    for (; (int)elites.size() < bestParentCount && ranked < order.size(); ++ranked) {
+        if (!admitIndex(order[ranked].second)) continue;
+        elites.push_back(order[ranked].second);
+        newGen.addEvaluated(population, order[ranked].second);
     }
     
     // 2. Add random parents (15%)
-    vector<int> remainingIndices;
-    for (size_t i = bestParentCount; i < fitnessIndex.size(); ++i) {
-        remainingIndices.push_back(fitnessIndex[i].second);
+    vector<int>& remainingIndices = buffers.remainingIndices;
+    remainingIndices.clear();
+    for (size_t i = ranked; i < order.size(); ++i) {
+        remainingIndices.push_back(order[i].second);
     }
-    shuffle(remainingIndices.begin(), remainingIndices.end(), mt19937(random_device{}()));
+    shuffle(remainingIndices.begin(), remainingIndices.end(), gen);
     
-    for (int i = 0; i < randomParentCount && i < (int)remainingIndices.size(); ++i) {
-        newGen.push_back(population[remainingIndices[i]]);
+    for (int i = 0, added = 0; added < randomParentCount && i < (int)remainingIndices.size(); ++i) {
+        if (!admitIndex(remainingIndices[i])) continue;
+        newGen.addEvaluated(population, remainingIndices[i]);
+        added++;
     }
     
-    // 3. Prepare parent pool for crossover (use both best and random parents)
-    vector<vector<int>> parentPool;
+    // 3. Prepare parent pool for crossover (use both best and random parents),
+    // lưu chỉ số trong population thay vì bản sao
+    vector<int>& parentPool = buffers.parentPool;
+    parentPool.clear();
     // Add all best parents to the pool
-    for (int i = 0; i < bestParentCount && i < (int)fitnessIndex.size(); ++i) {
-        parentPool.push_back(population[fitnessIndex[i].second]);
-    }
+    parentPool.insert(parentPool.end(), elites.begin(), elites.end());
     // Add some random parents to ensure diversity
     for (int i = 0; i < min(10, (int)remainingIndices.size()); ++i) {
-        parentPool.push_back(population[remainingIndices[i]]);
+        parentPool.push_back(remainingIndices[i]);
     }
     
-    // 4. Generate children through crossover
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> parentDis(0, max(0, (int)parentPool.size()-1));
-    uniform_real_distribution<> crossoverChoice(0.0, 1.0);
-    uniform_real_distribution<> mutProb(0.0, 1.0);
+    // 4. Generate children through crossover.
+    // Mỗi cặp con độc lập khi parentPool đã cố định: worker w xử lý các cặp
+    // w, w + T, w + 2T, ... với RNG riêng, kết quả ghi vào đúng vị trí của cặp.
+    int pairCount = parentPool.size() >= 2 ? (childrenCount + 1) / 2 : 0;
+    vector<pair<vector<int>, vector<int>>>& childPairs = buffers.childPairs;
+    if ((int)childPairs.size() < pairCount) childPairs.resize(pairCount);
+    int workers = repro->pool.size();
+    
+    {
+        ScopedPhase waitPhase(PHASE_SYNC_WAIT);
+        repro->pool.run([&](int worker) {
+            mt19937& workerGen = repro->rngs[worker];
+            for (int p = worker; p < pairCount; p += workers) {
+                // Con ghi thẳng vào bộ đệm của cặp p, dùng lại capacity từ generation trước
+                reproducePair(population, parentPool, childPairs[p].first, childPairs[p].second, n, vehicle,
+                              demand, capacity, depot, workerGen, dist, maxDistance, serviceTime, repro->decoder,
+                              repro->adaptive, worker, repro->localSearch);
+            }
+        });
+    }
     
     int childrenCreated = 0;
+    for (int p = 0; p < pairCount; ++p) {
+        const auto& childPair = childPairs[p];
+        // Add children to new population (mã hóa thẳng vào arena)
+        if (admit(childPair.first)) newGen.add(childPair.first);
+        childrenCreated++;
+        
+        if (childrenCreated < childrenCount) {
+            if (admit(childPair.second)) newGen.add(childPair.second);
+            childrenCreated++;
+        }
+    }
     
-    while (childrenCreated < childrenCount && parentPool.size() >= 2) {
-        // Select two different parents
-        int idx1 = parentDis(gen);
-        int idx2 = parentDis(gen);
-        
-        // Ensure parents are different
-        int attempts = 0;
-        while (idx2 == idx1 && parentPool.size() > 1 && attempts < 10) {
-            idx2 = parentDis(gen);
-            attempts++;
-        }
-        
-        // Choose crossover operator (3 operators with balanced probabilities)
-        pair<vector<int>, vector<int>> childPair;
-        double choice = crossoverChoice(gen);
-        
-        if (choice < 0.33) {
-            // 33% - One-Point Crossover
-            childPair = crossoverOnePoint(parentPool[idx1], parentPool[idx2], 
-                                         n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
-        } else if (choice < 0.67) {
-            // 34% - Order Crossover (OX)
-            childPair = crossoverOX(parentPool[idx1], parentPool[idx2], 
-                                   n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
-        } else {
-            // 33% - Partially Mapped Crossover (PMX)
-            childPair = crossoverPMX(parentPool[idx1], parentPool[idx2], 
-                                    n, vehicle, demand, capacity, depot, gen, dist, maxDistance, serviceTime);
+    // In case we couldn't create enough children
+    while ((int)newGen.size() < popSize) {
+        int randIdx = uniform_int_distribution<>(0, parentPool.size()-1)(gen);
+        vector<int>& individual = buffers.individual;
+        population.individual(parentPool[randIdx], individual);
+        
+        // Apply strong mutation to ensure diversity (--diversity: tới khi không trùng, tối đa 10 lần)
+        ScopedPhase mutationPhase(PHASE_MUTATION);
+        mutate(individual, n, vehicle, demand, capacity, gen, dist, depot);
+        for (int attempts = 1; diversity && attempts < 10 && !admit(individual); ++attempts) {
+            mutate(individual, n, vehicle, demand, capacity, gen, dist, depot);
         }
         
-        // Apply mutation with adaptive probability
-        double mutationProb = (n > 100) ? 0.30 : 0.20; // Higher for large problems
-        if (mutProb(gen) < mutationProb) {
-            mutate(childPair.first, n, vehicle, demand, capacity, gen, dist, depot, maxDistance, serviceTime);
+        newGen.add(individual);
+    }
+}
+
+// ======= STEADY-STATE REPLACEMENT =======
+
+// Cấu hình vòng tiến hóa (xem Replacement, Decoder trong cvrp_solver.h)
+struct EvolutionOptions {
+    Replacement replacement = Replacement::Generational; // Generational = newGeneration
+    int tournamentSize = 2;  // chọn cha mẹ, và chọn cá thể bị thay với TournamentLoser
+    Decoder decoder = Decoder::Separators;
+    bool adaptiveOperators = false; // AdaptiveOperators thay cho xác suất operator cố định
+    LocalSearchOptions localSearch;
+    DiversityOptions diversity;
+
+    bool steadyState() const { return replacement != Replacement::Generational; }
+};
+
+const char* replacementName(Replacement mode) {
+    switch (mode) {
+        case Replacement::Worst: return "steady-state, replace worst";
+        case Replacement::TournamentLoser: return "steady-state, replace tournament loser";
+        default: return "generational";
+    }
+}
+
+// Hash của giant tour theo từng gene (FNV-1a từng byte chậm gấp 4 trên tour dài);
+// mỗi bước là song ánh nên hai tour khác nhau đúng một vị trí không bao giờ trùng hash
+uint64_t tourHash(const vector<int>& seq) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (int gene : seq) hash = (hash ^ (uint32_t)gene) * 1099511628211ULL;
+    return hash;
+}
+
+// Steady-state GA thay cho newGeneration. Mỗi bước, mỗi worker chọn 2 cha mẹ bằng
+// tournament, sinh và đánh giá một cặp con với RNG riêng; sau đó các con được thay vào
+// population tuần tự theo thứ tự worker, nên run tái lập được với cùng seed và số thread.
+// Con có giant tour trùng một cá thể đang có bị loại; con chỉ thay cá thể bị chọn
+// (tệ nhất, hoặc thua tournament) khi tốt hơn nó, nên best không bao giờ mất.
+// order giữ (fitness, index) của mọi cá thể: cá thể tệ nhất lấy trong O(log n) và
+// fitnessIndex được chép lại từ order thay vì sort cả population.
+class SteadyStateEngine {
+public:
+    explicit SteadyStateEngine(const EvolutionOptions& options) : options_(options) {}
+
+    // Population vừa thay đổi ngoài engine (migrant): tính lại order và hash ở bước sau
+    void invalidate() { synced_ = false; }
+
+    // Chạy đủ số bước để sinh số con bằng một generation của newGeneration (~70% population).
+    // Population phải đã được đánh giá. Trả về số lần tính fitness.
+    int runGeneration(Population& population, int depot, const DistMatrix& dist, int n, int vehicle,
+                      const vector<pair<double,double>>& coords, const vector<int>& demand, int capacity,
+                      double maxDistance, double serviceTime, ReproductionContext& repro) {
+        int popSize = population.size();
+        if (popSize < 2) return 0;
+        if (!synced_ || (int)hashes_.size() != popSize) sync(population);
+        
+        int elites = max(1, (int)(popSize * 0.15));
+        int pairCount = (popSize - 2 * elites + 1) / 2;
+        int workers = repro.pool.size();
+        int steps = (max(1, pairCount) + workers - 1) / workers;
+        offspring_.resize(2 * workers);
+        
+        int evaluations = 0;
+        for (int step = 0; step < steps; ++step) {
+            {
+                ScopedPhase waitPhase(PHASE_SYNC_WAIT);
+                repro.pool.run([&](int worker) {
+                    mt19937& gen = repro.rngs[worker];
+                    int parent1 = tournament(population, gen, false);
+                    int parent2 = tournament(population, gen, false);
+                    for (int attempts = 0; parent2 == parent1 && attempts < 10; ++attempts) {
+                        parent2 = tournament(population, gen, false);
+                    }
+                    Offspring& first = offspring_[2 * worker];
+                    Offspring& second = offspring_[2 * worker + 1];
+                    reproduceParents(population, parent1, parent2, first.seq, second.seq, n, vehicle, demand,
+                                     capacity, depot, gen, dist, maxDistance, serviceTime, repro.decoder,
+                                     repro.adaptive, worker, repro.localSearch);
+                    
+                    ScopedPhase phase(PHASE_EVALUATION);
+                    for (Offspring* child : {&first, &second}) {
+                        if (dist.empty()) {
+                            child->fitness = calculateFitness(child->seq, coords, demand, capacity, depot, dist,
+                                                              maxDistance, serviceTime);
+                            child->feasible = validateCapacity(child->seq, demand, capacity, depot, dist,
+                                                               maxDistance, serviceTime);
+                        } else {
+                            // Hai con một lúc: kernel scalar một lượt (fitness + feasible), không cấp phát
+                            FitnessParams params(dist, demand, capacity, depot, maxDistance, serviceTime);
+                            child->fitness = fitnessOfGenes(child->seq.data(), child->seq.size(), params,
+                                                            child->feasible);
+                        }
+                        child->hash = tourHash(child->seq);
+                    }
+                });
+            }
+            
+            ScopedPhase selectionPhase(PHASE_SELECTION);
+            for (Offspring& child : offspring_) insert(population, child, repro.rngs[0]);
+            evaluations += offspring_.size();
         }
         
-        if (mutProb(gen) < mutationProb) {
-            mutate(childPair.second, n, vehicle, demand, capacity, gen, dist, depot, maxDistance, serviceTime);
+        population.fitnessIndex.assign(order_.begin(), order_.end());
+        return evaluations;
+    }
+
+    long long inserted() const { return inserted_; }
+    long long duplicates() const { return duplicates_; }
+    long long discarded() const { return discarded_; }
+
+private:
+    struct Offspring {
+        vector<int> seq;
+        double fitness = 0.0;
+        bool feasible = false;
+        uint64_t hash = 0;
+    };
+
+    void sync(const Population& population) {
+        order_.clear();
+        tours_.clear();
+        hashes_.resize(population.size());
+        vector<int>& seq = geneScratch().decoded;
+        for (size_t i = 0; i < population.size(); ++i) {
+            order_.insert({population.fitness[i], (int)i});
+            population.individual(i, seq);
+            hashes_[i] = tourHash(seq);
+            tours_[hashes_[i]]++;
+        }
+        synced_ = true;
+    }
+
+    // Tournament trên toàn population: cá thể tốt nhất (loser = false) hoặc tệ nhất
+    // trong tournamentSize cá thể chọn ngẫu nhiên
+    int tournament(const Population& population, mt19937& gen, bool loser) const {
+        uniform_int_distribution<> pick(0, population.size() - 1);
+        int chosen = pick(gen);
+        for (int k = 1; k < options_.tournamentSize; ++k) {
+            int candidate = pick(gen);
+            bool better = population.fitness[candidate] < population.fitness[chosen];
+            if (better != loser) chosen = candidate;
+        }
+        return chosen;
+    }
+
+    void insert(Population& population, Offspring& child, mt19937& gen) {
+        if (tours_.count(child.hash)) {
+            duplicates_++;
+            return;
+        }
+        int victim = options_.replacement == Replacement::Worst ? prev(order_.end())->second
+                                                         : tournament(population, gen, true);
+        if (!(child.fitness < population.fitness[victim])) {
+            discarded_++;
+            return;
         }
         
-        // Add children to new population
-        newGen.push_back(childPair.first);
-        childrenCreated++;
+        order_.erase({population.fitness[victim], victim});
+        auto old = tours_.find(hashes_[victim]);
+        if (--old->second == 0) tours_.erase(old);
         
-        if (childrenCreated < childrenCount) {
-            newGen.push_back(childPair.second);
-            childrenCreated++;
+        population.replace(victim, child.seq);
+        population.fitness[victim] = child.fitness;
+        population.feasible[victim] = child.feasible;
+        population.evaluated[victim] = 1;
+        order_.insert({child.fitness, victim});
+        hashes_[victim] = child.hash;
+        tours_[child.hash]++;
+        inserted_++;
+    }
+
+    EvolutionOptions options_;
+    set<pair<double, int>> order_;         // (fitness, index) tăng dần
+    unordered_map<uint64_t, int> tours_;   // tourHash -> số cá thể có giant tour đó
+    vector<uint64_t> hashes_;              // tourHash của từng cá thể
+    vector<Offspring> offspring_;          // 2 con mỗi worker, dùng lại qua các bước
+    bool synced_ = false;
+    long long inserted_ = 0, duplicates_ = 0, discarded_ = 0;
+};
+
+// ======= STOPPING CRITERIA =======
+
+// StopReason, StoppingCriteria, GAResult: xem cvrp_solver.h
+
+const char* stopReasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::TimeLimit: return "time-limit";
+        case StopReason::Stagnation: return "stagnation";
+        case StopReason::TargetGap: return "target-gap";
+        case StopReason::MaxEvaluations: return "max-evaluations";
+        case StopReason::Cancelled: return "cancelled";
+        default: return "max-generations";
+    }
+}
+
+// Điểm nối của API với vòng lặp GA (xem AnytimeSolver): onImprovement được gọi mỗi khi
+// global best feasible của run (island) cải thiện, cancel được kiểm tra cuối mỗi generation.
+struct SolveObserver {
+    function<void(const FeasibleSolution&)> onImprovement;
+    const atomic<bool>* cancel = nullptr;
+};
+
+// Trả về true và gán reason nếu một tiêu chí thỏa; thứ tự ưu tiên khi nhiều tiêu chí
+// cùng thỏa: target gap, time limit, evaluations, stagnation.
+bool shouldStop(const StoppingCriteria& criteria, double elapsedSeconds, int stagnationCount,
+                long long evaluations, const FeasibleSolution& bestFeasible, StopReason& reason) {
+    if (criteria.hasTargetGap() && bestFeasible.isFeasible
+        && bestFeasible.cost <= criteria.optimalCost * (1.0 + criteria.targetGap / 100.0)) {
+        reason = StopReason::TargetGap;
+    } else if (criteria.timeLimitSeconds > 0 && elapsedSeconds >= criteria.timeLimitSeconds) {
+        reason = StopReason::TimeLimit;
+    } else if (criteria.maxEvaluations > 0 && evaluations >= criteria.maxEvaluations) {
+        reason = StopReason::MaxEvaluations;
+    } else if (criteria.maxStagnation > 0 && stagnationCount >= criteria.maxStagnation) {
+        reason = StopReason::Stagnation;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ======= GENERATION TRACE =======
+
+// Một bản ghi cho mỗi generation, ghi ra --trace FILE (JSONL nếu đuôi .jsonl, ngược lại CSV)
+struct GenerationTrace {
+    int run = 0;
+    int island = 0;
+    int generation = 0;
+    double elapsedMs = 0.0;       // từ lúc bắt đầu run
+    double generationMs = 0.0;    // wall time của generation
+    PhaseTimes phases;            // exclusive time mỗi phase, cộng trên mọi worker thread
+    int evaluations = 0;
+    int feasibleCount = 0;
+    int populationSize = 0;
+    double bestCost = 0.0;        // best của generation (có thể infeasible)
+    double bestFeasibleCost = -1.0; // global best feasible, < 0 = chưa có
+    double gapPercent = -1.0;     // gap của best feasible so với optimal, < 0 = không biết
+    double diversity = 0.0;       // tỉ lệ giá trị fitness phân biệt trong population
+    const AdaptiveOperators* operators = nullptr; // --adaptive-operators: thống kê của generation
+};
+
+// Ghi trace dùng chung cho mọi run / island; mỗi bản ghi được format trước rồi ghi dưới lock
+class TraceWriter {
+public:
+    // operators: thêm xác suất, số lần dùng và gain / µs của từng operator mỗi generation
+    bool open(const string& path, bool operators = false) {
+        jsonl_ = path.size() >= 6 && path.compare(path.size() - 6, 6, ".jsonl") == 0;
+        operators_ = operators;
+        out_.open(path);
+        if (!out_) return false;
+        if (!jsonl_) {
+            out_ << "run,island,generation,elapsed_ms,generation_ms";
+            for (const char* name : PHASE_NAMES) out_ << "," << name << "_ms";
+            out_ << ",evaluations,feasible,population,best_cost,best_feasible_cost,gap_percent,diversity";
+            if (operators_) {
+                forEachOperator([&](const char* name, double, const OperatorUsage&) {
+                    out_ << "," << name << "_prob," << name << "_uses," << name << "_gain_per_us";
+                }, nullptr);
+            }
+            out_ << "\n";
+        }
+        return true;
+    }
+    
+    void write(const GenerationTrace& t) {
+        ostringstream line;
+        line << fixed << setprecision(3);
+        auto optional = [&](double value, const char* missing) {
+            if (value < 0) line << missing; else line << value;
+        };
+        if (jsonl_) {
+            line << "{\"run\":" << t.run << ",\"island\":" << t.island << ",\"generation\":" << t.generation
+                 << ",\"elapsed_ms\":" << t.elapsedMs << ",\"generation_ms\":" << t.generationMs;
+            for (int p = 0; p < PHASE_COUNT; ++p) line << ",\"" << PHASE_NAMES[p] << "_ms\":" << t.phases.ns[p] / 1e6;
+            line << ",\"evaluations\":" << t.evaluations << ",\"feasible\":" << t.feasibleCount
+                 << ",\"population\":" << t.populationSize << ",\"best_cost\":" << t.bestCost
+                 << ",\"best_feasible_cost\":";
+            optional(t.bestFeasibleCost, "null");
+            line << ",\"gap_percent\":";
+            optional(t.gapPercent, "null");
+            line << ",\"diversity\":" << t.diversity;
+            if (operators_) {
+                line << ",\"operators\":{";
+                bool first = true;
+                forEachOperator([&](const char* name, double probability, const OperatorUsage& usage) {
+                    line << (first ? "" : ",") << "\"" << name << "\":{\"prob\":" << probability
+                         << ",\"uses\":" << usage.uses << ",\"gain_per_us\":" << setprecision(6) << usage.gainPerUs()
+                         << setprecision(3) << "}";
+                    first = false;
+                }, t.operators);
+                line << "}";
+            }
+            line << "}\n";
+        } else {
+            line << t.run << "," << t.island << "," << t.generation << "," << t.elapsedMs << "," << t.generationMs;
+            for (int p = 0; p < PHASE_COUNT; ++p) line << "," << t.phases.ns[p] / 1e6;
+            line << "," << t.evaluations << "," << t.feasibleCount << "," << t.populationSize << "," << t.bestCost << ",";
+            optional(t.bestFeasibleCost, "");
+            line << ",";
+            optional(t.gapPercent, "");
+            line << "," << t.diversity;
+            if (operators_) {
+                forEachOperator([&](const char*, double probability, const OperatorUsage& usage) {
+                    line << "," << probability << "," << usage.uses << "," << setprecision(6) << usage.gainPerUs()
+                         << setprecision(3);
+                }, t.operators);
+            }
+            line << "\n";
+        }
+        lock_guard<mutex> lock(mtx_);
+        out_ << line.str();
+    }
+    
+private:
+    // f(tên, xác suất, thống kê) cho mọi crossover rồi mọi mutation (operators == nullptr: giá trị 0)
+    template <typename F>
+    static void forEachOperator(F&& f, const AdaptiveOperators* operators) {
+        static const OperatorStats empty;
+        const OperatorStats& stats = operators ? operators->last() : empty;
+        auto probability = [&](int k) { return operators ? operators->lastProbabilities()[k] : 0.0; };
+        for (int k = 0; k < CROSSOVER_COUNT; ++k) f(CROSSOVER_NAMES[k], probability(k), stats.crossover[k]);
+        for (int k = 0; k < MUTATION_COUNT; ++k) {
+            f(MUTATION_NAMES[k], probability(CROSSOVER_COUNT + k), stats.mutation[k]);
+        }
+    }
+    
+    mutex mtx_;
+    ofstream out_;
+    bool jsonl_ = false;
+    bool operators_ = false;
+};
+
+// Đo đạc của một run: trace (writer == nullptr thì không ghi, không đo phase)
+// và time-to-target so với optimal cost của instance (extractOptimalCost).
+struct TraceOptions {
+    TraceWriter* writer = nullptr;
+    double optimalCost = 0.0; // <= 0: không tính gap / time-to-target
+    double targetGap = 1.0;   // % trên optimal
+};
+
+// Tỉ lệ giá trị fitness phân biệt (fitnessIndex đã sắp xếp): 1 = đa dạng, 1/N = hội tụ
+double fitnessDiversity(const Population& population) {
+    const auto& index = population.fitnessIndex;
+    if (index.empty()) return 0.0;
+    int distinct = 1;
+    for (size_t i = 1; i < index.size(); ++i) {
+        if (index[i].first - index[i - 1].first > 1e-9) distinct++;
+    }
+    return (double)distinct / index.size();
+}
+
+// ======= CHECKPOINT & WARM START =======
+
+// Checkpoint nhị phân (little-endian, kiểu native):
+//   "CVRPCKP1" | u32 version | u32 n | u64 instance fingerprint | i32 generation | i64 evaluations
+//   | u32 width (2 hoặc 4 byte mỗi node id)
+//   | best: u8 feasible, f64 cost, i32 generation, u32 len, len x id
+//   | u32 count | count x (u32 len, len x id)
+// Fitness không được lưu: population được đánh giá lại khi nạp (rẻ so với khởi tạo).
+const char CHECKPOINT_MAGIC[8] = {'C', 'V', 'R', 'P', 'C', 'K', 'P', '1'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+struct Checkpoint {
+    int n = 0;
+    uint64_t fingerprint = 0;
+    int generation = 0;
+    long long evaluations = 0;
+    FeasibleSolution best;
+    vector<vector<int>> population;
+};
+
+// FNV-1a trên capacity, demand và toạ độ: phát hiện checkpoint của instance đã thay đổi
+uint64_t instanceFingerprint(int n, int capacity, const vector<int>& demand,
+                             const vector<pair<double,double>>& coords) {
+    uint64_t hash = fnv1a(nullptr, 0);
+    auto mix = [&hash](const void* data, size_t size) { hash = fnv1a(data, size, hash); };
+    mix(&n, sizeof(n));
+    mix(&capacity, sizeof(capacity));
+    if (!demand.empty()) mix(demand.data(), demand.size() * sizeof(int));
+    if (!coords.empty()) mix(coords.data(), coords.size() * sizeof(coords[0]));
+    return hash;
+}
+
+// File của run / island: base cho run 1 island 0, ngược lại thêm hậu tố .r<run> / .i<island>
+string runFilePath(const string& base, int runNumber, int islandId) {
+    if (runNumber <= 1 && islandId == 0) return base;
+    string path = base + ".r" + to_string(runNumber);
+    if (islandId > 0) path += ".i" + to_string(islandId);
+    return path;
+}
+
+void writeSequence(ostream& out, const vector<int>& seq, uint32_t width) {
+    writePod(out, (uint32_t)seq.size());
+    for (int v : seq) {
+        if (width == 2) writePod(out, (uint16_t)v);
+        else writePod(out, (int32_t)v);
+    }
+}
+
+bool readSequence(istream& in, vector<int>& seq, uint32_t width, int n) {
+    uint32_t length;
+    if (!readPod(in, length) || length > 4u * (uint32_t)(n + 1)) return false;
+    seq.resize(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        if (width == 2) {
+            uint16_t v;
+            if (!readPod(in, v)) return false;
+            seq[i] = v;
+        } else {
+            int32_t v;
+            if (!readPod(in, v)) return false;
+            seq[i] = v;
+        }
+    }
+    return true;
+}
+
+// Gene hợp lệ: 0 (separator) hoặc customer trong 1..n khác depot, mỗi customer tối đa một
+// lần. Population nạp từ checkpoint đi thẳng vào arena và kernel đánh giá, không qua repair.
+bool isValidSequence(const vector<int>& seq, int n, int depot, vector<char>& seen) {
+    seen.assign(n + 1, 0);
+    for (int v : seq) {
+        if (v == 0) continue;
+        if (v < 0 || v > n || v == depot || seen[v]) return false;
+        seen[v] = 1;
+    }
+    return true;
+}
+
+// Ghi vào path.tmp rồi rename: checkpoint cũ vẫn dùng được nếu tiến trình bị dừng giữa chừng
+bool saveCheckpoint(const string& path, const Checkpoint& checkpoint) {
+    string tmpPath = path + ".tmp";
+    {
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if (!out) return false;
+        uint32_t width = checkpoint.n < 65536 ? 2 : 4;
+        out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        writePod(out, CHECKPOINT_VERSION);
+        writePod(out, (uint32_t)checkpoint.n);
+        writePod(out, checkpoint.fingerprint);
+        writePod(out, (int32_t)checkpoint.generation);
+        writePod(out, (int64_t)checkpoint.evaluations);
+        writePod(out, width);
+        writePod(out, (uint8_t)checkpoint.best.isFeasible);
+        writePod(out, checkpoint.best.cost);
+        writePod(out, (int32_t)checkpoint.best.generation);
+        writeSequence(out, checkpoint.best.sequence, width);
+        writePod(out, (uint32_t)checkpoint.population.size());
+        for (const auto& seq : checkpoint.population) writeSequence(out, seq, width);
+        if (!out.flush()) return false;
+    }
+    return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool isCheckpointFile(const string& path) {
+    ifstream in(path, ios::binary);
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    return in.read(magic, sizeof(magic)) && equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC);
+}
+
+// Checkpoint phải cùng số node n và mọi sequence hợp lệ (isValidSequence); fingerprint khác
+// (demand / toạ độ đổi) vẫn được nạp
+bool loadCheckpoint(const string& path, int n, int depot, Checkpoint& checkpoint) {
+    ifstream in(path, ios::binary);
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version, fileN, width, count;
+    int32_t generation, bestGeneration;
+    int64_t evaluations;
+    uint8_t feasible;
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC)
+        || !readPod(in, version) || version != CHECKPOINT_VERSION
+        || !readPod(in, fileN) || (int)fileN != n
+        || !readPod(in, checkpoint.fingerprint) || !readPod(in, generation) || !readPod(in, evaluations)
+        || !readPod(in, width) || (width != 2 && width != 4)
+        || !readPod(in, feasible) || !readPod(in, checkpoint.best.cost) || !readPod(in, bestGeneration)
+        || !readSequence(in, checkpoint.best.sequence, width, n) || !readPod(in, count)) {
+        return false;
+    }
+    vector<char> seen;
+    if (!isValidSequence(checkpoint.best.sequence, n, depot, seen)) return false;
+    checkpoint.n = n;
+    checkpoint.generation = generation;
+    checkpoint.evaluations = evaluations;
+    checkpoint.best.isFeasible = feasible != 0;
+    checkpoint.best.generation = bestGeneration;
+    checkpoint.population.assign(count, vector<int>());
+    for (auto& seq : checkpoint.population) {
+        if (!readSequence(in, seq, width, n) || !isValidSequence(seq, n, depot, seen)) return false;
+    }
+    return true;
+}
+
+// File lời giải dạng text, node id như trong file .vrp (depot không ghi):
+//   Route #1: 12 5 7
+//   Route #2: 3 9
+//   Cost 524.61
+bool saveSolution(const string& path, const vector<int>& seq, double cost, int depot) {
+    ofstream out(path);
+    if (!out) return false;
+    int route = 0;
+    for (const auto& r : decodeSeq(seq, depot)) {
+        out << "Route #" << ++route << ":";
+        for (size_t i = 1; i + 1 < r.size(); ++i) out << " " << r[i];
+        out << "\n";
+    }
+    out << "Cost " << fixed << setprecision(2) << cost << "\n";
+    return (bool)out;
+}
+
+// Đọc lời giải mồi thành giant tour (tuyến nối bằng 0). Nhận file "Route #k:" ở trên hoặc
+// checkpoint (lấy best, nếu không có thì cá thể đầu). Trả về rỗng nếu không đọc được.
+vector<int> loadSolution(const string& path, int n, int depot) {
+    vector<int> seq;
+    if (isCheckpointFile(path)) {
+        Checkpoint checkpoint;
+        if (loadCheckpoint(path, n, depot, checkpoint)) {
+            if (!checkpoint.best.sequence.empty()) seq = checkpoint.best.sequence;
+            else if (!checkpoint.population.empty()) seq = checkpoint.population[0];
+        }
+        return seq;
+    }
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        size_t colon = line.find(':');
+        if (line.compare(0, 5, "Route") != 0 || colon == string::npos) continue;
+        istringstream tokens(line.substr(colon + 1));
+        if (!seq.empty()) seq.push_back(0);
+        int v;
+        while (tokens >> v) seq.push_back(v);
+    }
+    return seq;
+}
+
+// Population ban đầu từ lời giải mồi: các seed nguyên bản rồi bản đột biến của chúng cho
+// tới count cá thể. Node không còn trong instance bị loại; customer thiếu, số tuyến và
+// 2-opt do vòng repair của runGA xử lý như mọi cá thể khởi tạo.
+vector<vector<int>> seedPopulation(const vector<vector<int>>& seeds, int count, int n, int vehicle,
+                                   const vector<int>& demand, int capacity, int depot,
+                                   const DistMatrix& dist, double maxDistance, double serviceTime,
+                                   mt19937& gen) {
+    vector<vector<int>> population;
+    if (seeds.empty() || count <= 0) return population;
+    vector<vector<int>> cleaned;
+    for (const auto& seed : seeds) {
+        vector<int> seq;
+        for (int v : seed) {
+            if (v == 0 || (v >= 2 && v <= n && v != depot)) seq.push_back(v);
+        }
+        repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
+        repairZero(seq, vehicle, gen);
+        cleaned.push_back(seq);
+    }
+    for (int i = 0; i < count; ++i) {
+        vector<int> seq = cleaned[i % cleaned.size()];
+        if (i >= (int)cleaned.size()) {
+            int strength = 1 + i % 3; // đa dạng dần quanh seed
+            for (int k = 0; k < strength; ++k) {
+                mutate(seq, n, vehicle, demand, capacity, gen, dist, depot, maxDistance, serviceTime);
+            }
+        }
+        population.push_back(seq);
+    }
+    return population;
+}
+
+// Warm start / checkpoint của một run (xem --checkpoint, --resume, --warm-start)
+struct WarmStartOptions {
+    string checkpointPath;       // ghi checkpoint (rỗng = tắt), tên theo runFilePath
+    int checkpointInterval = 100; // generation giữa hai lần ghi; luôn ghi ở generation cuối
+    string resumePath;           // tiếp tục từ checkpoint (thiếu file = khởi tạo bình thường)
+    vector<vector<int>> seeds;   // lời giải mồi (giant tour)
+    double seedFraction = 0.5;   // tỉ lệ population lấy từ seed, phần còn lại khởi tạo mới
+    int lazyInitBatch = 0;       // > 0: bắt đầu GA với lô này, mỗi generation thêm một lô (0 = khởi tạo hết trước)
+};
+
+// ======= ISLAND MODEL =======
+
+enum class MigrationTopology { Ring, FullyConnected };
+
+struct IslandConfig {
+    int islands = 1;        // số sub-population chạy song song
+    int interval = 50;      // số generation giữa hai lần migration
+    int migrants = 2;       // số elite mỗi island gửi đi mỗi lần
+    MigrationTopology topology = MigrationTopology::Ring;
+};
+
+// Bộ đệm migration: mỗi island có một slot chứa các elite mới nhất nó công bố.
+// Island chỉ khóa slot của chính nó khi ghi và slot của island nguồn khi đọc,
+// không island nào phải chờ island khác tới cùng generation.
+class MigrationHub {
+public:
+    explicit MigrationHub(const IslandConfig& cfg) : config(cfg), slots(max(1, cfg.islands)) {}
+
+    const IslandConfig& settings() const { return config; }
+
+    void publish(int island, vector<FeasibleSolution> elites) {
+        lock_guard<mutex> lock(slots[island].mtx);
+        slots[island].elites = move(elites);
+    }
+
+    // Lấy tối đa config.migrants elite tốt nhất từ các island nguồn theo topology
+    vector<FeasibleSolution> collect(int island) {
+        vector<FeasibleSolution> incoming;
+        int count = slots.size();
+        for (int src = 0; src < count; ++src) {
+            if (src == island) continue;
+            if (config.topology == MigrationTopology::Ring && src != (island - 1 + count) % count) continue;
+            lock_guard<mutex> lock(slots[src].mtx);
+            incoming.insert(incoming.end(), slots[src].elites.begin(), slots[src].elites.end());
         }
+        sort(incoming.begin(), incoming.end(), [](const FeasibleSolution& a, const FeasibleSolution& b) {
+            if (a.isFeasible != b.isFeasible) return a.isFeasible;
+            return a.cost < b.cost;
+        });
+        if ((int)incoming.size() > config.migrants) incoming.resize(config.migrants);
+        return incoming;
     }
-    
-    // In case we couldn't create enough children
-    while (newGen.size() < popSize) {
-        int randIdx = uniform_int_distribution<>(0, parentPool.size()-1)(gen);
-        vector<int> individual = parentPool[randIdx];
-        
-        // Apply strong mutation to ensure diversity
-        mutate(individual, n, vehicle, demand, capacity, gen, dist, depot);
-        
-        newGen.push_back(individual);
+
+    // Island đạt target gap báo cho các island còn lại dừng theo
+    void requestStop() { stopRequested.store(true, memory_order_relaxed); }
+    bool stopping() const { return stopRequested.load(memory_order_relaxed); }
+
+private:
+    struct Slot {
+        mutex mtx;
+        vector<FeasibleSolution> elites;
+    };
+
+    IslandConfig config;
+    vector<Slot> slots;
+    atomic<bool> stopRequested{false};
+};
+
+// Công bố elite của island và thay các cá thể tệ nhất bằng migrant nhận được.
+// Trả về số migrant đã nhận; population được đánh giá và sắp xếp lại.
+int migrate(Population& population, MigrationHub& hub, int island, int generation,
+            const vector<pair<double,double>>& coords, const vector<int>& demand, int capacity, int depot,
+            const DistMatrix& dist, double maxDistance, double serviceTime) {
+    int migrants = min(hub.settings().migrants, (int)population.size() / 2);
+    if (migrants <= 0) return 0;
+    
+    vector<FeasibleSolution> elites;
+    for (int i = 0; i < migrants; ++i) {
+        int idx = population.fitnessIndex[i].second;
+        elites.emplace_back(population.individual(idx), population.fitness[idx], generation,
+                            population.feasible[idx] != 0);
     }
-    
-    return newGen;
+    hub.publish(island, move(elites));
+    
+    vector<FeasibleSolution> incoming = hub.collect(island);
+    int worst = population.size() - 1;
+    for (const FeasibleSolution& migrant : incoming) {
+        int idx = population.fitnessIndex[worst--].second;
+        population.replace(idx, migrant.sequence);
+        population.evaluated[idx] = 0;
+    }
+    if (!incoming.empty()) {
+        evaluatePopulation(population, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+    }
+    return incoming.size();
 }
-double globalBestCost;
-FeasibleSolution globalBestFeasible;
-struct GAResult {
-    int vehiclesUsed;
-    double bestCost;
-    bool isFeasible;
-    vector<int> bestSequence;
-};
 
+// dist là dữ liệu chỉ đọc, có thể dùng chung giữa nhiều run chạy đồng thời.
+// hub != nullptr: chạy như island islandId trong island model (xem runIslandGA).
+// stopping != nullptr: dừng sớm theo các tiêu chí, lý do ghi vào GAResult::stopReason.
+// observer != nullptr: báo mỗi best feasible mới và dừng khi observer->cancel được bật.
+// warm != nullptr: khởi tạo từ checkpoint / lời giải mồi và ghi checkpoint định kỳ.
+// evolution != nullptr: replacement steady-state (SteadyStateEngine thay cho newGeneration)
+// và decoder của con (Split).
 GAResult runGA(int maxGenerations, int vehicle, int n, int capacity, int depot, 
-          const vector<pair<double,double>>& coords, const vector<int>& demand, int populationSize, 
-          double maxDistance = 0.0, double serviceTime = 0.0, int runNumber = 1) {
-    
-    cout << "\n STARTING GENETIC ALGORITHM..." << endl;
-    cout << "   Problem: " << n-1 << " customers, " << vehicle << " vehicles, capacity " << capacity << endl;
-    cout << "   Running for " << maxGenerations << " generations" << endl;
-    cout << "   Population size: " << populationSize << endl;
+          const vector<pair<double,double>>& coords, const vector<int>& demand,
+          const DistMatrix& dist, int populationSize, 
+          double maxDistance = 0.0, double serviceTime = 0.0, int runNumber = 1,
+          int numThreads = 1, long long baseSeed = -1,
+          MigrationHub* hub = nullptr, int islandId = 0,
+          const TraceOptions* trace = nullptr, const StoppingCriteria* stopping = nullptr,
+          const SolveObserver* observer = nullptr, const WarmStartOptions* warm = nullptr,
+          const EvolutionOptions* evolution = nullptr) {
+    
+    auto startTime = chrono::steady_clock::now();
+    
+    GA_LOG(LOG_INFO) << "\n STARTING GENETIC ALGORITHM..." << endl;
+    GA_LOG(LOG_INFO) << "   Problem: " << n-1 << " customers, " << vehicle << " vehicles, capacity " << capacity << endl;
+    GA_LOG(LOG_INFO) << "   Running for " << maxGenerations << " generations" << endl;
+    GA_LOG(LOG_INFO) << "   Population size: " << populationSize << endl;
+    bool steadyState = evolution && evolution->steadyState();
+    if (steadyState) {
+        GA_LOG(LOG_INFO) << "   Replacement: " << replacementName(evolution->replacement) << " (tournament size "
+                         << evolution->tournamentSize << ")" << endl;
+    }
+    Decoder decoder = evolution ? evolution->decoder : Decoder::Separators;
+    if (decoder == Decoder::Split) {
+        GA_LOG(LOG_INFO) << "   Decoder: split (optimal route cuts of the giant tour)" << endl;
+    }
+    bool adaptiveOperators = evolution && evolution->adaptiveOperators;
+    if (adaptiveOperators) {
+        GA_LOG(LOG_INFO) << "   Operator selection: adaptive pursuit on fitness gain per microsecond" << endl;
+    }
+    if (evolution && evolution->localSearch.enabled()) {
+        const LocalSearchOptions& ls = evolution->localSearch;
+        GA_LOG(LOG_INFO) << "   Local search: " << ls.rate * 100 << "% of children, up to " << ls.maxMoves << " moves"
+                         << (ls.maxMicros > 0 ? " or " + to_string((long long)ls.maxMicros) + " us" : string())
+                         << " each" << endl;
+    }
+    DiversityOptions diversityOptions = evolution ? evolution->diversity : DiversityOptions();
+    if (diversityOptions.enabled) {
+        GA_LOG(LOG_INFO) << "   Diversity: duplicate rejection, biased fitness over " << diversityOptions.closest
+                         << " closest (broken-pairs distance)" << endl;
+    }
+    if (diversityOptions.restartAfter > 0) {
+        GA_LOG(LOG_INFO) << "   Restart: after every " << diversityOptions.restartAfter
+                         << " generations without improvement" << endl;
+    }
     
-    vector<vector<double>> dist = buildDist(coords);
+    // Resume: population và best lấy từ checkpoint, bỏ qua khởi tạo + repair
+    uint64_t fingerprint = instanceFingerprint(n, capacity, demand, coords);
+    Checkpoint resumed;
+    bool resuming = false;
+    if (warm && !warm->resumePath.empty()) {
+        string path = runFilePath(warm->resumePath, runNumber, islandId);
+        resuming = loadCheckpoint(path, n, depot, resumed) && !resumed.population.empty();
+        if (resuming) {
+            GA_LOG(LOG_INFO) << "   Resuming from " << path << " (generation " << resumed.generation << ", "
+                             << resumed.population.size() << " individuals)" << endl;
+            if (resumed.fingerprint != fingerprint) {
+                GA_LOG(LOG_WARN) << "Warning: " << path << " was written for a different instance, best solution discarded" << endl;
+                resumed.best = FeasibleSolution();
+            }
+        } else {
+            GA_LOG(LOG_WARN) << "Warning: cannot resume from " << path << ", starting from scratch" << endl;
+        }
+    }
     
-    // Use the enhanced structured initialization
-    vector<vector<int>> population = initStructuredPopulation(populationSize, vehicle, n, capacity, demand, coords, dist, depot, runNumber);
+    // Use the enhanced structured initialization (phần không lấy từ lời giải mồi)
+    int seededCount = 0;
+    if (!resuming && warm && !warm->seeds.empty()) {
+        seededCount = max((int)warm->seeds.size(), (int)llround(populationSize * warm->seedFraction));
+        seededCount = min(seededCount, populationSize);
+    }
+    StructuredInitializer initializer(resuming ? 0 : populationSize - seededCount, vehicle, n, capacity, demand,
+                                      coords, dist, depot, runNumber, baseSeed, maxDistance, serviceTime);
+    if (initializer.size() > 0) initializer.logDistribution();
     
     // Repair initial population with run-specific seed
-    random_device rd;
-    unsigned int seed = rd() + runNumber * 12345;  // Different seed for each run
+    unsigned int base = baseSeed >= 0 ? (unsigned int)baseSeed : random_device{}();
+    unsigned int seed = base + runNumber * 12345;  // Different seed for each run
+    if (resuming) seed += 7919u * resumed.generation; // không lặp lại chuỗi ngẫu nhiên của đoạn đã chạy
     mt19937 gen(seed);
     
-    cout << "   Run seed: " << seed << " (run #" << runNumber << ")" << endl;
-    
-    for (auto& seq : population) {
-        repairCustomerWithLocalSearch(seq, n, gen, dist, demand, capacity, depot, maxDistance, serviceTime, vehicle);
-        repairZero(seq, vehicle, gen);
+    // Worker pool + RNG riêng cho từng worker, seed suy ra từ run seed
+    ReproductionContext repro(resolveThreadCount(numThreads), seed);
+    repro.decoder = decoder;
+    unique_ptr<AdaptiveOperators> adaptive;
+    if (adaptiveOperators) {
+        adaptive.reset(new AdaptiveOperators(repro.pool.size()));
+        repro.adaptive = adaptive.get();
+    }
+    unique_ptr<LocalSearch> localSearch;
+    if (evolution && evolution->localSearch.enabled()) {
+        localSearch.reset(new LocalSearch(evolution->localSearch, repro.pool.size()));
+        repro.localSearch = localSearch.get();
+    }
+    unique_ptr<PopulationDiversity> diversity;
+    if (diversityOptions.enabled) {
+        diversity.reset(new PopulationDiversity(diversityOptions, depot));
+        repro.diversity = diversity.get();
+    }
+    int restarts = 0;
+    // Cấp phát trước bộ đệm repair của mọi worker, vòng lặp thế hệ chỉ dùng lại
+    repro.pool.run([&](int) { repairScratch().prepare(n, vehicle); });
+    
+    GA_LOG(LOG_INFO) << "   Run seed: " << seed << " (run #" << runNumber << ")" << endl;
+    GA_LOG(LOG_INFO) << "   Reproduction threads: " << repro.pool.size() << endl;
+    
+    // Cá thể khởi tạo sinh song song trên pool; lazy init: chỉ lô đầu, mỗi generation
+    // thêm một lô tới khi đủ population
+    int lazyBatch = warm ? warm->lazyInitBatch : 0;
+    int initialized = lazyBatch > 0 ? min(initializer.size(), lazyBatch) : initializer.size();
+    // Split decoder: cá thể khởi tạo cũng được chia lại tuyến tối ưu
+    auto splitIndividuals = [&](vector<vector<int>>& individuals) {
+        if (decoder != Decoder::Split) return;
+        for (auto& seq : individuals) splitTour(seq, vehicle, demand, capacity, depot, dist, maxDistance, serviceTime);
+    };
+    vector<vector<int>> initialPopulation;
+    buildInitialIndividuals(initializer, 0, initialized, repro.pool, initialPopulation);
+    splitIndividuals(initialPopulation);
+    if (initializer.size() > 0) {
+        GA_LOG(LOG_INFO) << "Generated " << initialPopulation.size() << " individuals with improved methods" << endl;
+        if (initialized < initializer.size()) {
+            GA_LOG(LOG_INFO) << "   Lazy init: " << initializer.size() - initialized << " more individuals, "
+                             << lazyBatch << " per generation" << endl;
+        }
+    }
+    if (seededCount > 0) {
+        vector<vector<int>> seeded = seedPopulation(warm->seeds, seededCount, n, vehicle, demand, capacity, depot,
+                                                    dist, maxDistance, serviceTime, gen);
+        GA_LOG(LOG_INFO) << "   Warm start: " << seeded.size() << " individuals from " << warm->seeds.size()
+                         << " seed solution" << (warm->seeds.size() > 1 ? "s" : "") << endl;
+        initialPopulation.insert(initialPopulation.begin(), seeded.begin(), seeded.end());
     }
+    Population population = makePopulation(resuming ? resumed.population : initialPopulation, n);
+    initialPopulation.clear();
+    GenerationBuffers generationBuffers; // double buffer: thế hệ mới ghi vào spare rồi hoán đổi
+    SteadyStateEngine steadyEngine(evolution ? *evolution : EvolutionOptions());
     
     // Initialize tracking variables
     double globalBestCost = numeric_limits<double>::max();
     vector<int> globalBestCostIndividual;
-    FeasibleSolution globalBestFeasible;
+    bool globalBestIsFeasible = false;
+    FeasibleSolution globalBestFeasible = resuming ? resumed.best : FeasibleSolution();
+    bool checkpointing = warm && !warm->checkpointPath.empty();
+    string checkpointFile = checkpointing ? runFilePath(warm->checkpointPath, runNumber, islandId) : "";
     int stagnationCount = 0;
     
-    cout << "\n🏁 EVOLUTION PROGRESS:" << endl;
+    // Đo đạc: phase timing chỉ thu khi có trace writer; time-to-target khi biết optimal
+    bool tracing = trace && trace->writer;
+    double optimalCost = trace ? trace->optimalCost : 0.0;
+    double targetCost = optimalCost > 0 ? optimalCost * (1.0 + trace->targetGap / 100.0) : -1.0;
+    double timeToTarget = -1.0;
+    int generationToTarget = -1;
+    vector<PhaseTimes> workerPhases(repro.pool.size());
+    StopReason stopReason = StopReason::MaxGenerations;
+    long long totalEvaluations = resuming ? resumed.evaluations : 0;
+    int firstGeneration = resuming ? min(resumed.generation + 1, max(1, maxGenerations)) : 1;
+    int generationsRun = firstGeneration - 1;
+    if (tracing) {
+        repro.pool.run([](int) { takePhaseTimes(); }); // bỏ thời gian khởi tạo
+    }
     
-    for (int generation = 1; generation <= maxGenerations; generation++) {
-        // Calculate fitness
-        vector<pair<double, int>> fitnessIndex;
-        for (size_t i = 0; i < population.size(); ++i) {
-            double fitness = calculateFitness(population[i], coords, demand, capacity, depot, dist, maxDistance, serviceTime);
-            fitnessIndex.push_back({fitness, (int)i});
+    GA_LOG(LOG_INFO) << "\n🏁 EVOLUTION PROGRESS:" << '\n';
+    
+    for (int generation = firstGeneration; generation <= maxGenerations; generation++) {
+        auto generationStart = chrono::steady_clock::now();
+        
+        if (generation > firstGeneration && initialized < initializer.size()) {
+            int end = min(initializer.size(), initialized + lazyBatch);
+            vector<vector<int>> batch;
+            buildInitialIndividuals(initializer, initialized, end, repro.pool, batch);
+            splitIndividuals(batch);
+            for (const auto& seq : batch) population.add(seq);
+            initialized = end;
+            if (initialized == initializer.size()) {
+                GA_LOG(LOG_INFO) << "   Population complete (" << population.size() << " individuals) at generation "
+                                 << generation << '\n';
+            }
         }
-        sort(fitnessIndex.begin(), fitnessIndex.end());
+        
+        // Calculate fitness (chỉ cho cá thể mới, elite dùng lại cache)
+        int evaluations = evaluatePopulation(population, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
+        totalEvaluations += evaluations;
+        generationsRun = generation;
         
         // Get best solution in this generation
-        double bestCostInGen = fitnessIndex[0].first;
-        int bestIdxInGen = fitnessIndex[0].second;
+        double bestCostInGen = population.fitnessIndex[0].first;
+        int bestIdxInGen = population.fitnessIndex[0].second;
+        GA_LOG(LOG_DEBUG) << "   Generation " << generation << ": evaluated " << evaluations
+                          << ", best " << bestCostInGen << '\n';
         
         // Update global best (may be infeasible)
         if (bestCostInGen < globalBestCost) {
             globalBestCost = bestCostInGen;
-            globalBestCostIndividual = population[bestIdxInGen];
+            globalBestCostIndividual = population.individual(bestIdxInGen);
+            globalBestIsFeasible = population.feasible[bestIdxInGen];
             stagnationCount = 0;
             
-            cout << "Generation " << generation << ": New global best cost = " << bestCostInGen;
-            if (validateCapacity(globalBestCostIndividual, demand, capacity, depot, dist, maxDistance, serviceTime)) {
-                cout << " FEASIBLE";
-            } else {
-                cout << " INFEASIBLE";
-            }
-            cout << endl;
+            GA_LOG(LOG_INFO) << "Generation " << generation << ": New global best cost = " << bestCostInGen
+                             << (globalBestIsFeasible ? " FEASIBLE" : " INFEASIBLE") << '\n';
         } else {
             ++stagnationCount;
             if (generation % 10 == 0) {
-                cout << "Generation " << generation << ": Best = " << bestCostInGen 
+                GA_LOG(LOG_INFO) << "Generation " << generation << ": Best = " << bestCostInGen 
                      << ", Global = " << globalBestCost << ", No improvement for " 
-                     << stagnationCount << " generations" << endl;
+                     << stagnationCount << " generations" << '\n';
             }
         }
         
         // Update best feasible solution
-        FeasibleSolution bestFeasibleInGen = getBestFeasibleFromGeneration(
-            population, fitnessIndex, demand, capacity, depot, generation, dist, maxDistance, serviceTime);
-        updateGlobalBestFeasible(globalBestFeasible, bestFeasibleInGen);
+        FeasibleSolution bestFeasibleInGen = getBestFeasibleFromGeneration(population, generation);
+        if (updateGlobalBestFeasible(globalBestFeasible, bestFeasibleInGen) && observer && observer->onImprovement) {
+            observer->onImprovement(globalBestFeasible);
+        }
+        
+        if (targetCost > 0 && generationToTarget < 0 && globalBestFeasible.isFeasible
+            && globalBestFeasible.cost <= targetCost) {
+            timeToTarget = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+            generationToTarget = generation;
+            GA_LOG(LOG_INFO) << "   Within " << trace->targetGap << "% of optimal at generation " << generation
+                    << " (" << fixed << setprecision(2) << timeToTarget << "s)" << '\n';
+        }
+        
+        GenerationTrace record;
+        if (tracing) {
+            record.run = runNumber;
+            record.island = islandId;
+            record.generation = generation;
+            record.evaluations = evaluations;
+            record.populationSize = population.size();
+            record.feasibleCount = count(population.feasible.begin(), population.feasible.end(), 1);
+            record.bestCost = bestCostInGen;
+            record.diversity = fitnessDiversity(population);
+            if (globalBestFeasible.isFeasible) {
+                record.bestFeasibleCost = globalBestFeasible.cost;
+                if (optimalCost > 0) record.gapPercent = (globalBestFeasible.cost - optimalCost) / optimalCost * 100.0;
+            }
+        }
+        
+        // Tiêu chí dừng sớm; island model: dừng theo island khác đã đạt target gap
+        bool stop = false;
+        if (stopping) {
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+            stop = shouldStop(*stopping, elapsed, stagnationCount, totalEvaluations, globalBestFeasible, stopReason);
+            if (stop && hub && stopReason == StopReason::TargetGap) hub->requestStop();
+        }
+        if (!stop && hub && hub->stopping()) {
+            stop = true;
+            stopReason = StopReason::TargetGap;
+        }
+        if (!stop && observer && observer->cancel && observer->cancel->load(memory_order_relaxed)) {
+            stop = true;
+            stopReason = StopReason::Cancelled;
+        }
+        if (stop) {
+            GA_LOG(LOG_INFO) << "   Stopping at generation " << generation << ": " << stopReasonName(stopReason)
+                             << " (" << totalEvaluations << " evaluations)" << '\n';
+        }
+        bool lastGeneration = stop || generation == maxGenerations;
+        
+        if (checkpointing && (generation % max(1, warm->checkpointInterval) == 0 || lastGeneration)) {
+            Checkpoint snapshot;
+            snapshot.n = n;
+            snapshot.fingerprint = fingerprint;
+            snapshot.generation = generation;
+            snapshot.evaluations = totalEvaluations;
+            snapshot.best = globalBestFeasible;
+            snapshot.population = population.individuals();
+            if (!saveCheckpoint(checkpointFile, snapshot)) {
+                GA_LOG(LOG_WARN) << "Warning: cannot write checkpoint " << checkpointFile << endl;
+            }
+        }
+        
+        // Island model: trao đổi elite với các island khác
+        if (hub && generation % hub->settings().interval == 0 && !lastGeneration) {
+            int received = migrate(population, *hub, islandId, generation, coords, demand, capacity, depot,
+                                   dist, maxDistance, serviceTime);
+            totalEvaluations += received;
+            if (received > 0) {
+                steadyEngine.invalidate();
+                GA_LOG(LOG_INFO) << "   Island " << islandId << ": received " << received
+                        << " migrants at generation " << generation << '\n';
+            }
+        }
+        
+        // Restart: giữ vài cá thể tốt nhất, phần còn lại khởi tạo lại với seed mới
+        bool restart = !lastGeneration && diversityOptions.restartAfter > 0 && stagnationCount > 0
+                       && stagnationCount % diversityOptions.restartAfter == 0;
+        if (restart) {
+            int keep = min((int)population.size(), max(1, (int)(population.size() * diversityOptions.restartKeep)));
+            restarts++;
+            StructuredInitializer fresh(population.size() - keep, vehicle, n, capacity, demand, coords, dist, depot,
+                                        runNumber, (long long)seed + 7919LL * restarts, maxDistance, serviceTime);
+            vector<vector<int>> individuals;
+            buildInitialIndividuals(fresh, 0, fresh.size(), repro.pool, individuals);
+            splitIndividuals(individuals);
+            Population& next = generationBuffers.spare;
+            if (next.genes.maxNode() != population.genes.maxNode()) next = Population(population.genes.maxNode());
+            next.clear();
+            next.reserve(population.size(), population.genes.stride());
+            for (int i = 0; i < keep; ++i) next.addEvaluated(population, population.fitnessIndex[i].second);
+            for (const auto& seq : individuals) next.add(seq);
+            swap(population, next);
+            steadyEngine.invalidate();
+            GA_LOG(LOG_INFO) << "Generation " << generation << ": restart #" << restarts << " after " << stagnationCount
+                             << " generations without improvement (kept " << keep << " best)" << '\n';
+        }
         
-        // Create next generation
-        if (generation < maxGenerations) {
-            population = newGeneration(population, depot, dist, n, vehicle, demand, capacity, coords, maxDistance, serviceTime);
+        // Create next generation (steady-state: con được đánh giá và thay vào population ngay)
+        if (restart) {
+            // population mới được đánh giá ở đầu generation sau
+        } else if (!lastGeneration && steadyState) {
+            int childEvaluations = steadyEngine.runGeneration(population, depot, dist, n, vehicle, coords, demand,
+                                                              capacity, maxDistance, serviceTime, repro);
+            totalEvaluations += childEvaluations;
+            record.evaluations += childEvaluations;
+        } else if (!lastGeneration) {
+            newGeneration(population, generationBuffers.spare, generationBuffers, depot, dist, n, vehicle,
+                          demand, capacity, maxDistance, serviceTime, &repro);
+            swap(population, generationBuffers.spare);
         }
+        if (adaptive && !lastGeneration) {
+            adaptive->endGeneration();
+            record.operators = adaptive.get();
+        }
+        
+        if (tracing) {
+            auto now = chrono::steady_clock::now();
+            record.elapsedMs = chrono::duration<double, milli>(now - startTime).count();
+            record.generationMs = chrono::duration<double, milli>(now - generationStart).count();
+            repro.pool.run([&](int worker) { workerPhases[worker] = takePhaseTimes(); });
+            for (const PhaseTimes& times : workerPhases) record.phases += times;
+            trace->writer->write(record);
+        }
+        if (stop) break;
+    }
+    
+    if (adaptive && logEnabled(LOG_INFO)) {
+        const OperatorStats& total = adaptive->total();
+        auto report = [&](const char* label, const OperatorPursuit& pursuit, const char* const* names,
+                          const OperatorUsage* usage) {
+            ostringstream line;
+            line << "   " << label << ":" << fixed;
+            for (int k = 0; k < pursuit.size(); ++k) {
+                line << " " << names[k] << " " << setprecision(2) << pursuit.probability(k)
+                     << " (" << usage[k].uses << "x, " << setprecision(4) << usage[k].gainPerUs() << "/us)";
+            }
+            GA_LOG(LOG_INFO) << line.str() << endl;
+        };
+        report("Crossover probabilities", adaptive->crossover(), CROSSOVER_NAMES, total.crossover);
+        report("Mutation probabilities", adaptive->mutation(), MUTATION_NAMES, total.mutation);
+    }
+    if (localSearch && logEnabled(LOG_INFO)) {
+        LocalSearchStats total = localSearch->total();
+        ostringstream line;
+        line << "   Local search: " << total.children << " children, " << fixed << setprecision(1)
+             << (total.children > 0 ? total.micros / total.children : 0.0) << " us each, moves";
+        for (int k = 0; k < LS_MOVE_COUNT; ++k) line << " " << LS_MOVE_NAMES[k] << " " << total.moves[k];
+        GA_LOG(LOG_INFO) << line.str() << endl;
+    }
+    if (diversity) {
+        GA_LOG(LOG_INFO) << "   Diversity: " << diversity->duplicates() << " duplicates rejected, mean broken-pairs distance "
+                         << diversity->meanDistance() << " in the last generation" << endl;
+    }
+    if (restarts > 0) {
+        GA_LOG(LOG_INFO) << "   Restarts: " << restarts << endl;
+    }
+    if (steadyState) {
+        GA_LOG(LOG_INFO) << "   Steady-state: " << steadyEngine.inserted() << " children inserted, "
+                         << steadyEngine.duplicates() << " duplicates rejected, "
+                         << steadyEngine.discarded() << " not better than the replaced individual" << endl;
     }
     
     // Final results
-    cout << "\n==== FINAL RESULTS ====" << endl;
-    cout << "Best solution cost: " << globalBestCost;
-    bool globalBestIsFeasible = validateCapacity(globalBestCostIndividual, demand, capacity, depot, dist, maxDistance, serviceTime);
-    cout << (globalBestIsFeasible ? " FEASIBLE" : "  INFEASIBLE") << endl;
+    GA_LOG(LOG_INFO) << "\n==== FINAL RESULTS ====" << endl;
+    GA_LOG(LOG_INFO) << "Best solution cost: " << globalBestCost;
+    GA_LOG(LOG_INFO) << (globalBestIsFeasible ? " FEASIBLE" : "  INFEASIBLE") << endl;
     
     GAResult result;
     
@@ -2236,9 +5216,9 @@ GAResult runGA(int maxGenerations, int vehicle, int n, int capacity, int depot,
         result.isFeasible = true;
         result.bestSequence = globalBestFeasible.sequence;
         
-        cout << "\n BEST FEASIBLE SOLUTION:" << endl;
-        cout << "Cost: " << globalBestFeasible.cost << endl;
-        cout << "Found in generation: " << globalBestFeasible.generation << endl;
+        GA_LOG(LOG_INFO) << "\n BEST FEASIBLE SOLUTION:" << endl;
+        GA_LOG(LOG_INFO) << "Cost: " << globalBestFeasible.cost << endl;
+        GA_LOG(LOG_INFO) << "Found in generation: " << globalBestFeasible.generation << endl;
         
         // Display the routes
         displaySolution(globalBestFeasible.sequence, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
@@ -2249,17 +5229,173 @@ GAResult runGA(int maxGenerations, int vehicle, int n, int capacity, int depot,
         result.isFeasible = false;
         result.bestSequence = globalBestCostIndividual;
         
-        cout << "\n NO FEASIBLE SOLUTION FOUND!" << endl;
-        cout << "All solutions violated capacity constraints." << endl;
+        GA_LOG(LOG_INFO) << "\n NO FEASIBLE SOLUTION FOUND!" << endl;
+        GA_LOG(LOG_INFO) << "All solutions violated capacity constraints." << endl;
         
         // Display best infeasible solution as fallback
-        cout << "\n Best infeasible solution:" << endl;
+        GA_LOG(LOG_INFO) << "\n Best infeasible solution:" << endl;
         displaySolution(globalBestCostIndividual, coords, demand, capacity, depot, dist, maxDistance, serviceTime);
     }
     
+    result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    result.timeToTarget = timeToTarget;
+    result.generationToTarget = generationToTarget;
+    result.stopReason = stopReason;
+    result.generations = generationsRun;
+    result.evaluations = totalEvaluations;
+    return result;
+}
+
+GAResult runGA(int maxGenerations, int vehicle, int n, int capacity, int depot, 
+          const vector<pair<double,double>>& coords, const vector<int>& demand, int populationSize, 
+          double maxDistance = 0.0, double serviceTime = 0.0, int runNumber = 1,
+          int numThreads = 1, long long baseSeed = -1) {
+    DistMatrix dist = buildDist(coords);
+    return runGA(maxGenerations, vehicle, n, capacity, depot, coords, demand, dist, populationSize,
+                 maxDistance, serviceTime, runNumber, numThreads, baseSeed);
+}
+
+// Island model: islands.islands sub-population, mỗi cái là một runGA trên thread riêng,
+// trao đổi elite qua MigrationHub mỗi islands.interval generation. Trả về kết quả
+// của island tốt nhất (ưu tiên feasible). Island i dùng seed riêng suy ra từ baseSeed.
+GAResult runIslandGA(const IslandConfig& islands, int maxGenerations, int vehicle, int n, int capacity, int depot,
+                     const vector<pair<double,double>>& coords, const vector<int>& demand,
+                     const DistMatrix& dist, int populationSize, double maxDistance, double serviceTime,
+                     int runNumber, int numThreads, long long baseSeed,
+                     const TraceOptions* trace = nullptr, const StoppingCriteria* stopping = nullptr,
+                     const SolveObserver* observer = nullptr, const WarmStartOptions* warm = nullptr,
+                     const EvolutionOptions* evolution = nullptr) {
+    auto startTime = chrono::steady_clock::now();
+    int islandCount = max(1, islands.islands);
+    
+    GA_LOG(LOG_INFO) << "\n ISLAND MODEL: " << islandCount << " islands x " << populationSize << " individuals, "
+            << (islands.topology == MigrationTopology::Ring ? "ring" : "fully connected")
+            << " topology, " << islands.migrants << " migrants every " << islands.interval << " generations" << endl;
+    
+    MigrationHub hub(islands);
+    vector<GAResult> results(islandCount);
+    vector<string> logs(islandCount);
+    ThreadPool pool(islandCount);
+    
+    pool.run([&](int island) {
+        ostringstream buffer;
+        ostream* previous = gaOutStream;
+        gaOutStream = &buffer;
+        long long islandSeed = baseSeed >= 0 ? baseSeed + 7919LL * island : -1;
+        results[island] = runGA(maxGenerations, vehicle, n, capacity, depot, coords, demand, dist, populationSize,
+                                maxDistance, serviceTime, runNumber, numThreads, islandSeed, &hub, island, trace,
+                                stopping, observer, warm, evolution);
+        gaOutStream = previous;
+        logs[island] = buffer.str();
+    });
+    
+    int best = 0;
+    for (int island = 0; island < islandCount; ++island) {
+        GA_LOG(LOG_INFO) << "\n--- Island " << island << " ---" << logs[island];
+        const GAResult& r = results[island];
+        const GAResult& b = results[best];
+        if ((r.isFeasible && !b.isFeasible) || (r.isFeasible == b.isFeasible && r.bestCost < b.bestCost)) {
+            best = island;
+        }
+    }
+    
+    GA_LOG(LOG_INFO) << "\n Best island: " << best << " (cost " << fixed << setprecision(2) << results[best].bestCost << ")" << endl;
+    GAResult result = results[best];
+    result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    // Time-to-target của cả model = island đạt target sớm nhất; evaluation cộng mọi island
+    result.evaluations = 0;
+    for (const GAResult& r : results) {
+        result.evaluations += r.evaluations;
+        if (r.timeToTarget >= 0 && (result.timeToTarget < 0 || r.timeToTarget < result.timeToTarget)) {
+            result.timeToTarget = r.timeToTarget;
+            result.generationToTarget = r.generationToTarget;
+        }
+    }
     return result;
 }
 
+// ======= MULTI-RUN EXECUTOR =======
+
+void printRunSummary(ostream& out, int run, const GAResult& result) {
+    out << "✅ Run " << run << " completed in " << (long long)result.elapsedSeconds << "s" << endl;
+    out << "   Stopped by: " << stopReasonName(result.stopReason) << " after " << result.generations
+        << " generations, " << result.evaluations << " evaluations (" << fixed << setprecision(2)
+        << result.elapsedSeconds << "s)" << endl;
+    out << "   Cost: " << fixed << setprecision(2) << result.bestCost << endl;
+    out << "   Vehicles: " << result.vehiclesUsed << endl;
+    out << "   Status: " << (result.isFeasible ? "✅ FEASIBLE" : "❌ INFEASIBLE") << endl;
+    if (result.timeToTarget >= 0) {
+        out << "   Time to target: " << fixed << setprecision(2) << result.timeToTarget
+            << "s (generation " << result.generationToTarget << ")" << endl;
+    }
+}
+
+// Chạy numRuns run độc lập, tối đa parallelRuns run cùng lúc. Các run không chia sẻ
+// trạng thái ghi (population, RNG, thread pool riêng); chỉ đọc chung coords, demand
+// và dist. Output từng run được gom vào buffer và in trọn vẹn khi run kết thúc.
+// Kết quả trả về theo thứ tự run (run 1 ở vị trí 0) để thống kê không phụ thuộc lịch chạy.
+vector<GAResult> runMultipleGA(int numRuns, int parallelRuns, int maxGenerations, int vehicle, int n,
+                               int capacity, int depot, const vector<pair<double,double>>& coords,
+                               const vector<int>& demand, const DistMatrix& dist, int populationSize,
+                               double maxDistance, double serviceTime, int numThreads, long long baseSeed,
+                               const IslandConfig& islands = IslandConfig(),
+                               const TraceOptions* trace = nullptr, const StoppingCriteria* stopping = nullptr,
+                               const WarmStartOptions* warm = nullptr,
+                               const EvolutionOptions* evolution = nullptr) {
+    auto executeRun = [&](int run) {
+        if (islands.islands > 1) {
+            return runIslandGA(islands, maxGenerations, vehicle, n, capacity, depot, coords, demand, dist,
+                               populationSize, maxDistance, serviceTime, run, numThreads, baseSeed, trace, stopping,
+                               nullptr, warm, evolution);
+        }
+        return runGA(maxGenerations, vehicle, n, capacity, depot, coords, demand, dist, populationSize,
+                     maxDistance, serviceTime, run, numThreads, baseSeed, nullptr, 0, trace, stopping,
+                     nullptr, warm, evolution);
+    };
+    
+    vector<GAResult> results(numRuns);
+    int workers = min(max(1, parallelRuns), max(1, numRuns));
+    
+    if (workers == 1) {
+        for (int run = 1; run <= numRuns; ++run) {
+            cout << "\n📊 RUN " << run << "/" << numRuns;
+            if (numRuns > 1) {
+                cout << " (" << fixed << setprecision(1) << (100.0 * run / numRuns) << "% completed)";
+            }
+            cout << endl;
+            cout << string(40, '-') << endl;
+            
+            results[run - 1] = executeRun(run);
+            printRunSummary(cout, run, results[run - 1]);
+        }
+        return results;
+    }
+    
+    ThreadPool pool(workers);
+    atomic<int> nextRun(1);
+    int finishedRuns = 0;
+    mutex outputMutex;
+    
+    pool.run([&](int) {
+        for (int run = nextRun++; run <= numRuns; run = nextRun++) {
+            ostringstream buffer;
+            gaOutStream = &buffer;
+            GAResult result = executeRun(run);
+            gaOutStream = &cout;
+            
+            lock_guard<mutex> lock(outputMutex);
+            ++finishedRuns;
+            cout << "\n📊 RUN " << run << "/" << numRuns
+                 << " (" << fixed << setprecision(1) << (100.0 * finishedRuns / numRuns) << "% completed)" << endl;
+            cout << string(40, '-') << endl;
+            cout << buffer.str();
+            printRunSummary(cout, run, result);
+            results[run - 1] = move(result);
+        }
+    });
+    return results;
+}
+
 // Add this include at the top with other includes
 #include <fstream>
 
@@ -2268,7 +5404,7 @@ GAResult runGA(int maxGenerations, int vehicle, int n, int capacity, int depot,
 double extractOptimalCost(const string& filename) {
     ifstream file(filename);
     if (!file.is_open()) {
-        cout << "Warning: Cannot open " << filename << " to read optimal cost" << endl;
+        GA_LOG(LOG_WARN) << "Warning: Cannot open " << filename << " to read optimal cost" << endl;
         return -1.0;  // Indicate error
     }
     
@@ -2286,7 +5422,7 @@ double extractOptimalCost(const string& filename) {
                 try {
                     return stod(costStr);
                 } catch (const exception& e) {
-                    cout << "Warning: Cannot parse optimal cost from: " << costStr << endl;
+                    GA_LOG(LOG_WARN) << "Warning: Cannot parse optimal cost from: " << costStr << endl;
                     return -1.0;
                 }
             }
@@ -2297,7 +5433,7 @@ double extractOptimalCost(const string& filename) {
         }
     }
     
-    cout << "Warning: Optimal cost not found in " << filename << endl;
+    GA_LOG(LOG_WARN) << "Warning: Optimal cost not found in " << filename << endl;
     return -1.0;
 }
 
@@ -2341,10 +5477,460 @@ void exportToCSV(const string& instanceName, int totalVehicles, int populationSi
     }
 }
 
+// Tên instance từ đường dẫn: bỏ thư mục và đuôi file ("data/CMT1.vrp" -> "CMT1")
+string instanceNameOf(const string& filename) {
+    string name = filename;
+    size_t lastSlash = name.find_last_of("/\\");
+    if (lastSlash != string::npos) {
+        name = name.substr(lastSlash + 1);
+    }
+    size_t dotPos = name.find_last_of('.');
+    if (dotPos != string::npos) {
+        name = name.substr(0, dotPos);
+    }
+    return name;
+}
+
+// ======= BATCH DRIVER (--batch) =======
+
+// Cấu hình chung của batch, lấy từ dòng lệnh; runs / seed / generations / population
+// là giá trị mặc định cho các dòng của file job không ghi rõ.
+struct BatchOptions {
+    string csvPath = "batch_results.csv";
+    string jsonlPath;              // rỗng = không ghi JSONL
+    int runs = 10;
+    long long seed = -1;           // -1: mỗi dòng rút một seed từ random_device và ghi lại
+    int generations = 1000;
+    int population = 800;
+    int workers = 0;               // job chạy cùng lúc, 0 = mọi core / numThreads
+    int numThreads = 1;
+    int neighborK = DEFAULT_NEIGHBOR_K;
+    size_t denseLimit = DEFAULT_DENSE_LIMIT;
+    string cacheDir;
+    double targetGap = 1.0;
+    IslandConfig islands;
+    StoppingCriteria stopping;
+    EvolutionOptions evolution;
+};
+
+// Instance đọc một lần cho cả batch; mọi job của nó đọc chung coords, demand và dist
+struct BatchInstance {
+    string file;
+    string name;
+    int n = 0, capacity = 0, depot = 1, vehicles = 0;
+    double maxDistance = 0.0, serviceTime = 0.0, optimalCost = -1.0;
+    vector<pair<double,double>> coords;
+    vector<int> demand;
+    DistMatrix dist;
+};
+
+struct BatchJob {
+    int instance = 0;      // chỉ số trong danh sách BatchInstance
+    int run = 1;
+    long long seed = -1;
+    int generations = 0;
+    int population = 0;
+    double work = 0.0;     // ước lượng: customers × generations × population
+};
+
+// File job: mỗi dòng "FILE [RUNS] [SEED] [GENERATIONS] [POPULATION]", "-" hoặc bỏ trống
+// = giá trị của BatchOptions. Dòng trống và dòng bắt đầu bằng '#' bị bỏ qua. Một dòng
+// sinh RUNS job (run 1..RUNS) cùng seed gốc, như RUNS run của một lần gọi cvrp_solver.
+// File instance đọc một lần dù xuất hiện ở nhiều dòng; file không mở được bị bỏ qua.
+bool readBatchJobs(const string& path, const BatchOptions& options, vector<BatchInstance>& instances,
+                   vector<BatchJob>& jobs) {
+    ifstream in(path);
+    if (!in) return false;
+    map<string, int> instanceIndex;
+    random_device device;
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        istringstream fields(line);
+        string file, token;
+        if (!(fields >> file) || file[0] == '#') continue;
+        
+        int runs = options.runs;
+        long long seed = options.seed;
+        int generations = options.generations;
+        int population = options.population;
+        if (fields >> token && token != "-") runs = max(1, atoi(token.c_str()));
+        if (fields >> token && token != "-") seed = max(0LL, atoll(token.c_str()));
+        if (fields >> token && token != "-") generations = max(1, atoi(token.c_str()));
+        if (fields >> token && token != "-") population = max(2, atoi(token.c_str()));
+        if (seed < 0) seed = device();
+        
+        auto found = instanceIndex.find(file);
+        if (found == instanceIndex.end()) {
+            if (!ifstream(file)) {
+                GA_LOG(LOG_WARN) << "Warning: " << path << ":" << lineNumber << ": cannot open " << file
+                                 << ", skipping" << endl;
+                continue;
+            }
+            BatchInstance instance;
+            instance.file = file;
+            instance.name = instanceNameOf(file);
+            if (!loadCVRPWithDist(file, options.cacheDir, options.neighborK, options.denseLimit, instance.n,
+                                  instance.capacity, instance.coords, instance.demand, instance.depot,
+                                  instance.vehicles, instance.maxDistance, instance.serviceTime, instance.dist)) {
+                GA_LOG(LOG_WARN) << "Warning: " << path << ":" << lineNumber << ": cannot read " << file
+                                 << ", skipping" << endl;
+                continue;
+            }
+            instance.optimalCost = extractOptimalCost(file);
+            found = instanceIndex.emplace(file, (int)instances.size()).first;
+            instances.push_back(move(instance));
+        }
+        
+        for (int run = 1; run <= runs; ++run) {
+            BatchJob job;
+            job.instance = found->second;
+            job.run = run;
+            job.seed = seed;
+            job.generations = generations;
+            job.population = population;
+            job.work = (double)(instances[job.instance].n - 1) * generations * population;
+            jobs.push_back(job);
+        }
+    }
+    return true;
+}
+
+// Kết quả batch: file CSV và JSONL (tùy chọn) mở một lần cho cả batch, ghi qua bộ đệm
+// 1 MB dưới một mutex theo thứ tự job hoàn thành; chỉ flush khi close().
+class BatchResultWriter {
+public:
+    bool open(const string& csvPath, const string& jsonlPath) {
+        csvBuffer_.resize(1 << 20);
+        csv_.rdbuf()->pubsetbuf(csvBuffer_.data(), csvBuffer_.size());
+        csv_.open(csvPath);
+        if (!csv_) return false;
+        csv_ << "Instance,Run,Seed,Customers,Population_Size,Max_Generations,Total_Vehicles,Best_Cost,"
+                "Optimal_Cost,GAP_Percent,Feasible,Generations,Evaluations,Execution_Time_Seconds,"
+                "Time_To_Target_Seconds,Stop_Reason\n";
+        if (!jsonlPath.empty()) {
+            jsonlBuffer_.resize(1 << 20);
+            jsonl_.rdbuf()->pubsetbuf(jsonlBuffer_.data(), jsonlBuffer_.size());
+            jsonl_.open(jsonlPath);
+            if (!jsonl_) return false;
+        }
+        return true;
+    }
+    
+    void write(const BatchInstance& instance, const BatchJob& job, const GAResult& result) {
+        double gap = instance.optimalCost > 0 ? (result.bestCost - instance.optimalCost) / instance.optimalCost * 100.0
+                                              : -1.0;
+        lock_guard<mutex> lock(mtx_);
+        csv_ << fixed << setprecision(2)
+             << instance.name << "," << job.run << "," << job.seed << "," << instance.n - 1 << ","
+             << job.population << "," << job.generations << "," << result.vehiclesUsed << ","
+             << result.bestCost << "," << instance.optimalCost << "," << gap << ","
+             << (result.isFeasible ? 1 : 0) << "," << result.generations << "," << result.evaluations << ","
+             << setprecision(3) << result.elapsedSeconds << "," << result.timeToTarget << ","
+             << stopReasonName(result.stopReason) << "\n";
+        if (jsonl_.is_open()) {
+            // Tên instance lấy từ tên file: không chứa ký tự cần escape trong JSON trừ '"' và '\'
+            string name;
+            for (char c : instance.name) {
+                if (c == '"' || c == '\\') name += '\\';
+                name += c;
+            }
+            jsonl_ << fixed << setprecision(2)
+                   << "{\"instance\":\"" << name << "\",\"run\":" << job.run << ",\"seed\":" << job.seed
+                   << ",\"customers\":" << instance.n - 1 << ",\"population\":" << job.population
+                   << ",\"max_generations\":" << job.generations << ",\"vehicles\":" << result.vehiclesUsed
+                   << ",\"best_cost\":" << result.bestCost << ",\"optimal_cost\":";
+            if (instance.optimalCost > 0) jsonl_ << instance.optimalCost; else jsonl_ << "null";
+            jsonl_ << ",\"gap_percent\":";
+            if (instance.optimalCost > 0) jsonl_ << gap; else jsonl_ << "null";
+            jsonl_ << ",\"feasible\":" << (result.isFeasible ? "true" : "false")
+                   << ",\"generations\":" << result.generations << ",\"evaluations\":" << result.evaluations
+                   << setprecision(3) << ",\"seconds\":" << result.elapsedSeconds << ",\"time_to_target\":";
+            if (result.timeToTarget >= 0) jsonl_ << result.timeToTarget; else jsonl_ << "null";
+            jsonl_ << ",\"stop_reason\":\"" << stopReasonName(result.stopReason) << "\"}\n";
+        }
+    }
+    
+    void close() {
+        lock_guard<mutex> lock(mtx_);
+        csv_.close();
+        if (jsonl_.is_open()) jsonl_.close();
+    }
+    
+private:
+    mutex mtx_;
+    ofstream csv_, jsonl_;
+    vector<char> csvBuffer_, jsonlBuffer_;
+};
+
+// Chạy mọi job của file jobsPath trên một pool gồm options.workers worker. Job được
+// xếp longest-job-first theo ước lượng work (cùng work giữ thứ tự trong file) để job
+// lớn không bị dồn về cuối; mỗi worker lấy job kế tiếp khi xong job trước. Log chi tiết
+// của từng run chỉ in ở --log-level debug; mỗi job xong in một dòng tóm tắt.
+int runBatch(const string& jobsPath, const BatchOptions& options) {
+    vector<BatchInstance> instances;
+    vector<BatchJob> jobs;
+    if (!readBatchJobs(jobsPath, options, instances, jobs)) {
+        cerr << "Cannot open batch file " << jobsPath << endl;
+        return 1;
+    }
+    if (jobs.empty()) {
+        cerr << "No jobs in batch file " << jobsPath << endl;
+        return 1;
+    }
+    stable_sort(jobs.begin(), jobs.end(), [](const BatchJob& a, const BatchJob& b) { return a.work > b.work; });
+    
+    BatchResultWriter writer;
+    if (!writer.open(options.csvPath, options.jsonlPath)) {
+        cerr << "Cannot open batch output " << options.csvPath
+             << (options.jsonlPath.empty() ? "" : " / " + options.jsonlPath) << endl;
+        return 1;
+    }
+    
+    int workers = options.workers > 0 ? options.workers
+                                      : max(1, resolveThreadCount(0) / resolveThreadCount(options.numThreads));
+    workers = min(workers, (int)jobs.size());
+    GA_LOG(LOG_INFO) << "\nBatch: " << jobs.size() << " jobs on " << instances.size() << " instance"
+                     << (instances.size() > 1 ? "s" : "") << ", " << workers << " worker"
+                     << (workers > 1 ? "s" : "") << ", " << resolveThreadCount(options.numThreads)
+                     << " thread" << (resolveThreadCount(options.numThreads) > 1 ? "s" : "") << " per job" << endl;
+    GA_LOG(LOG_INFO) << "   Results: " << options.csvPath
+                     << (options.jsonlPath.empty() ? "" : ", " + options.jsonlPath) << endl;
+    
+    vector<GAResult> results(jobs.size());
+    atomic<size_t> nextJob(0);
+    size_t finishedJobs = 0;
+    mutex outputMutex;
+    ThreadPool pool(workers);
+    pool.run([&](int) {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++) {
+            const BatchJob& job = jobs[j];
+            const BatchInstance& instance = instances[job.instance];
+            StoppingCriteria stopping = options.stopping;
+            stopping.optimalCost = instance.optimalCost;
+            TraceOptions trace;
+            trace.optimalCost = instance.optimalCost;
+            trace.targetGap = options.targetGap;
+            
+            ostringstream buffer;
+            gaOutStream = &buffer;
+            GAResult result;
+            if (options.islands.islands > 1) {
+                result = runIslandGA(options.islands, job.generations, instance.vehicles, instance.n,
+                                     instance.capacity, instance.depot, instance.coords, instance.demand,
+                                     instance.dist, job.population, instance.maxDistance, instance.serviceTime,
+                                     job.run, options.numThreads, job.seed, &trace, &stopping, nullptr, nullptr,
+                                     &options.evolution);
+            } else {
+                result = runGA(job.generations, instance.vehicles, instance.n, instance.capacity, instance.depot,
+                               instance.coords, instance.demand, instance.dist, job.population,
+                               instance.maxDistance, instance.serviceTime, job.run, options.numThreads, job.seed,
+                               nullptr, 0, &trace, &stopping, nullptr, nullptr, &options.evolution);
+            }
+            gaOutStream = &cout;
+            writer.write(instance, job, result);
+            
+            lock_guard<mutex> lock(outputMutex);
+            ++finishedJobs;
+            if (logEnabled(LOG_DEBUG)) cout << buffer.str();
+            GA_LOG(LOG_INFO) << "[" << finishedJobs << "/" << jobs.size() << "] " << instance.name
+                             << " run " << job.run << " (seed " << job.seed << "): cost " << fixed
+                             << setprecision(2) << result.bestCost << ", " << result.vehiclesUsed << " vehicles, "
+                             << (result.isFeasible ? "FEASIBLE" : "INFEASIBLE") << ", " << result.elapsedSeconds
+                             << "s" << endl;
+            results[j] = move(result);
+        }
+    });
+    writer.close();
+    
+    // Tóm tắt theo instance, theo thứ tự xuất hiện trong file job
+    cout << "\n" << string(70, '=') << endl;
+    cout << "📈 BATCH SUMMARY (" << jobs.size() << " jobs)" << endl;
+    cout << string(70, '=') << endl;
+    cout << left << setw(12) << "Instance" << right << setw(6) << "Runs" << setw(10) << "Feasible"
+         << setw(12) << "Best" << setw(12) << "Mean" << setw(12) << "Worst" << setw(10) << "GAP %" << endl;
+    for (size_t i = 0; i < instances.size(); ++i) {
+        vector<double> costs;
+        int feasible = 0;
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            if (jobs[j].instance != (int)i) continue;
+            costs.push_back(results[j].bestCost);
+            if (results[j].isFeasible) feasible++;
+        }
+        double best = *min_element(costs.begin(), costs.end());
+        double worst = *max_element(costs.begin(), costs.end());
+        double mean = accumulate(costs.begin(), costs.end(), 0.0) / costs.size();
+        cout << left << setw(12) << instances[i].name << right << setw(6) << costs.size()
+             << setw(10) << feasible << fixed << setprecision(2) << setw(12) << best << setw(12) << mean
+             << setw(12) << worst;
+        if (instances[i].optimalCost > 0) {
+            cout << setw(10) << (best - instances[i].optimalCost) / instances[i].optimalCost * 100.0;
+        } else {
+            cout << setw(10) << "N/A";
+        }
+        cout << endl;
+    }
+    cout << "\n=== RESULTS EXPORTED TO " << options.csvPath
+         << (options.jsonlPath.empty() ? "" : " and " + options.jsonlPath) << " ===" << endl;
+    return 0;
+}
+
+// ======= ANYTIME SOLVER API (cvrp_solver.h) =======
+
+bool loadCVRPInstance(const string& filename, CVRPInstance& instance) {
+    CVRPInstance loaded;
+    if (!readCVRP(filename, loaded.n, loaded.capacity, loaded.coords, loaded.demand, loaded.depot,
+                  loaded.vehicles, loaded.maxDistance, loaded.serviceTime)) {
+        return false;
+    }
+    loaded.optimalCost = extractOptimalCost(filename);
+    instance = move(loaded);
+    return true;
+}
+
+GAResult solveCVRP(const CVRPInstance& instance, const SolverParams& params,
+                   ImprovementCallback onImprovement, const atomic<bool>* cancel) {
+    DistMatrix dist = buildDist(instance.coords, params.neighborK, params.denseLimit);
+    StoppingCriteria stopping = params.stopping;
+    if (stopping.optimalCost <= 0) stopping.optimalCost = instance.optimalCost;
+    WarmStartOptions warm;
+    warm.seeds = params.initialSolutions;
+    warm.seedFraction = params.seedFraction;
+    warm.checkpointPath = params.checkpointPath;
+    warm.checkpointInterval = params.checkpointInterval;
+    warm.resumePath = params.resumePath;
+    warm.lazyInitBatch = params.lazyInitBatch;
+    EvolutionOptions evolution;
+    evolution.replacement = params.replacement;
+    evolution.tournamentSize = max(1, params.tournamentSize);
+    evolution.decoder = params.decoder;
+    evolution.adaptiveOperators = params.adaptiveOperators;
+    evolution.localSearch.rate = params.localSearchRate;
+    evolution.localSearch.maxMoves = params.localSearchMoves;
+    evolution.localSearch.maxMicros = params.localSearchMicros;
+    evolution.diversity.enabled = params.diversity;
+    evolution.diversity.restartAfter = params.restartAfter;
+    
+    // Island model gọi onImprovement từ nhiều thread: chỉ chuyển tiếp bản tốt hơn mọi
+    // bản đã báo, tuần tự dưới một mutex
+    mutex improvementMutex;
+    double reportedCost = numeric_limits<double>::max();
+    SolveObserver observer;
+    observer.cancel = cancel;
+    if (onImprovement) {
+        observer.onImprovement = [&](const FeasibleSolution& solution) {
+            lock_guard<mutex> lock(improvementMutex);
+            if (solution.cost >= reportedCost) return;
+            reportedCost = solution.cost;
+            onImprovement(solution);
+        };
+    }
+    
+    if (params.islands > 1) {
+        IslandConfig islands;
+        islands.islands = params.islands;
+        return runIslandGA(islands, params.maxGenerations, instance.vehicles, instance.n, instance.capacity,
+                           instance.depot, instance.coords, instance.demand, dist, params.populationSize,
+                           instance.maxDistance, instance.serviceTime, 1, params.numThreads, params.seed,
+                           nullptr, &stopping, &observer, &warm, &evolution);
+    }
+    return runGA(params.maxGenerations, instance.vehicles, instance.n, instance.capacity, instance.depot,
+                 instance.coords, instance.demand, dist, params.populationSize, instance.maxDistance,
+                 instance.serviceTime, 1, params.numThreads, params.seed, nullptr, 0, nullptr, &stopping,
+                 &observer, &warm, &evolution);
+}
+
+struct AnytimeSolver::State {
+    CVRPInstance instance;
+    SolverParams params;
+    atomic<bool> cancel{false};
+    
+    mutable mutex mtx;
+    mutable condition_variable finishedCv;
+    FeasibleSolution best;
+    long long version = 0;
+    bool done = false;
+    GAResult result;
+    thread worker;
+};
+
+AnytimeSolver::AnytimeSolver(const CVRPInstance& instance, const SolverParams& params)
+    : state_(new State) {
+    state_->instance = instance;
+    state_->params = params;
+}
+
+AnytimeSolver::~AnytimeSolver() {
+    cancel();
+    if (state_->worker.joinable()) state_->worker.join();
+}
+
+void AnytimeSolver::start(ImprovementCallback onImprovement) {
+    if (state_->worker.joinable()) return;
+    State* state = state_.get();
+    state->worker = thread([state, onImprovement] {
+        GAResult result = solveCVRP(state->instance, state->params, [&](const FeasibleSolution& solution) {
+            {
+                lock_guard<mutex> lock(state->mtx);
+                state->best = solution;
+                state->version++;
+            }
+            if (onImprovement) onImprovement(solution);
+        }, &state->cancel);
+        lock_guard<mutex> lock(state->mtx);
+        state->result = move(result);
+        state->done = true;
+        state->finishedCv.notify_all();
+    });
+}
+
+void AnytimeSolver::cancel() { state_->cancel = true; }
+
+FeasibleSolution AnytimeSolver::best() const {
+    lock_guard<mutex> lock(state_->mtx);
+    return state_->best;
+}
+
+long long AnytimeSolver::improvements() const {
+    lock_guard<mutex> lock(state_->mtx);
+    return state_->version;
+}
+
+bool AnytimeSolver::poll(FeasibleSolution& solution, long long& seenVersion) const {
+    lock_guard<mutex> lock(state_->mtx);
+    if (state_->version <= seenVersion) return false;
+    solution = state_->best;
+    seenVersion = state_->version;
+    return true;
+}
+
+bool AnytimeSolver::waitFor(double timeoutSeconds) const {
+    unique_lock<mutex> lock(state_->mtx);
+    return state_->finishedCv.wait_for(lock, chrono::duration<double>(max(0.0, timeoutSeconds)),
+                                       [this] { return state_->done; });
+}
+
+void AnytimeSolver::wait() const {
+    unique_lock<mutex> lock(state_->mtx);
+    state_->finishedCv.wait(lock, [this] { return state_->done; });
+}
+
+bool AnytimeSolver::finished() const {
+    lock_guard<mutex> lock(state_->mtx);
+    return state_->done;
+}
+
+const GAResult& AnytimeSolver::result() const { return state_->result; }
 
 // ======= MAIN FUNCTION =======
 
+#ifndef CVRP_NO_MAIN
 int main(int argc, char* argv[]) {
+    // stdout đi qua bộ đệm bất đồng bộ: log trong generation loop không chờ I/O
+    asyncStdout().install(cout);
+    
     cout << "🚛 CVRP SOLVER with GENETIC ALGORITHM" << endl;
     cout << "====================================" << endl;
     
@@ -2354,27 +5940,203 @@ int main(int argc, char* argv[]) {
     int populationSize = 800;
     int numRuns = 10;  // Number of times to run each instance
     
-    // Parse command line arguments
-    if (argc >= 2) {
-        filename = argv[1];
+    int numThreads = 1;   // Reproduction threads (0 = all hardware threads)
+    long long seed = -1;  // Base seed (-1 = random_device)
+    int parallelRuns = 1; // Independent runs executed concurrently (0 = all hardware threads)
+    IslandConfig islands; // Island model (--islands K > 1)
+    int neighborK = DEFAULT_NEIGHBOR_K; // Granular local search (0 = full scan)
+    string tracePath;     // Per-generation trace (CSV, hoặc JSONL nếu đuôi .jsonl)
+    double targetGap = 1.0; // Time-to-target: within X% of optimal
+    StoppingCriteria stopping; // Dừng sớm: --time-limit, --max-stagnation, --target-gap, --max-evaluations
+    WarmStartOptions warmStart; // --checkpoint, --resume, --warm-start
+    EvolutionOptions evolution; // --replacement, --tournament, --decoder
+    vector<string> warmStartFiles;
+    string solutionPath;  // --save-solution: ghi best solution dạng "Route #k:"
+    int simdRequested = -1;  // --simd, -1 = auto
+    string instanceCacheDir; // --instance-cache: instance + dist nhị phân, mmap khi chạy lại
+    size_t denseLimit = DEFAULT_DENSE_LIMIT; // --dense-limit: số node tối đa của ma trận dense
+    string batchPath;     // --batch: file job, chạy nhiều instance trong một process
+    BatchOptions batch;   // --batch-output, --batch-jsonl
+    
+    // Parse command line options (--name value), the rest are positional
+    vector<string> args;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            numThreads = max(0, atoi(argv[++i]));
+        } else if (arg == "--parallel-runs" && i + 1 < argc) {
+            parallelRuns = max(0, atoi(argv[++i]));
+            batch.workers = resolveThreadCount(parallelRuns);
+        } else if (arg == "--islands" && i + 1 < argc) {
+            islands.islands = max(1, atoi(argv[++i]));
+        } else if (arg == "--migration-interval" && i + 1 < argc) {
+            islands.interval = max(1, atoi(argv[++i]));
+        } else if (arg == "--migrants" && i + 1 < argc) {
+            islands.migrants = max(0, atoi(argv[++i]));
+        } else if (arg == "--topology" && i + 1 < argc) {
+            string topology = argv[++i];
+            islands.topology = (topology == "full") ? MigrationTopology::FullyConnected : MigrationTopology::Ring;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = max(0LL, atoll(argv[++i]));
+        } else if (arg == "--neighbors" && i + 1 < argc) {
+            neighborK = max(0, atoi(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--time-to-target" && i + 1 < argc) {
+            targetGap = max(0.0, atof(argv[++i]));
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            stopping.timeLimitSeconds = max(0.0, atof(argv[++i]));
+        } else if (arg == "--max-stagnation" && i + 1 < argc) {
+            stopping.maxStagnation = max(0, atoi(argv[++i]));
+        } else if (arg == "--target-gap" && i + 1 < argc) {
+            stopping.targetGap = max(0.0, atof(argv[++i]));
+        } else if (arg == "--max-evaluations" && i + 1 < argc) {
+            stopping.maxEvaluations = max(0LL, atoll(argv[++i]));
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            warmStart.checkpointPath = argv[++i];
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            warmStart.checkpointInterval = max(1, atoi(argv[++i]));
+        } else if (arg == "--resume" && i + 1 < argc) {
+            warmStart.resumePath = argv[++i];
+        } else if (arg == "--lazy-init" && i + 1 < argc) {
+            warmStart.lazyInitBatch = max(0, atoi(argv[++i]));
+        } else if (arg == "--replacement" && i + 1 < argc) {
+            string mode = argv[++i];
+            if (mode == "worst") {
+                evolution.replacement = Replacement::Worst;
+            } else if (mode == "tournament") {
+                evolution.replacement = Replacement::TournamentLoser;
+            } else if (mode == "generational") {
+                evolution.replacement = Replacement::Generational;
+            } else {
+                cerr << "Unknown replacement: " << mode << " (generational|worst|tournament)" << endl;
+                return 1;
+            }
+        } else if (arg == "--tournament" && i + 1 < argc) {
+            evolution.tournamentSize = max(1, atoi(argv[++i]));
+        } else if (arg == "--decoder" && i + 1 < argc) {
+            string decoder = argv[++i];
+            if (decoder == "split") {
+                evolution.decoder = Decoder::Split;
+            } else if (decoder == "separators") {
+                evolution.decoder = Decoder::Separators;
+            } else {
+                cerr << "Unknown decoder: " << decoder << " (separators|split)" << endl;
+                return 1;
+            }
+        } else if (arg == "--adaptive-operators") {
+            evolution.adaptiveOperators = true;
+        } else if (arg == "--local-search" && i + 1 < argc) {
+            evolution.localSearch.rate = min(1.0, max(0.0, atof(argv[++i])));
+        } else if (arg == "--ls-moves" && i + 1 < argc) {
+            evolution.localSearch.maxMoves = max(1, atoi(argv[++i]));
+        } else if (arg == "--ls-time-us" && i + 1 < argc) {
+            evolution.localSearch.maxMicros = max(0.0, atof(argv[++i]));
+        } else if (arg == "--diversity") {
+            evolution.diversity.enabled = true;
+        } else if (arg == "--diversity-closest" && i + 1 < argc) {
+            evolution.diversity.closest = max(1, atoi(argv[++i]));
+        } else if (arg == "--restart-after" && i + 1 < argc) {
+            evolution.diversity.restartAfter = max(0, atoi(argv[++i]));
+        } else if (arg == "--simd" && i + 1 < argc) {
+            string simd = argv[++i];
+            if (simd == "auto") {
+                simdRequested = -1;
+            } else if (simd == "scalar") {
+                simdRequested = (int)SimdLevel::Scalar;
+            } else if (simd == "avx2") {
+                simdRequested = (int)SimdLevel::AVX2;
+            } else if (simd == "avx512") {
+                simdRequested = (int)SimdLevel::AVX512;
+            } else {
+                cerr << "Unknown SIMD level: " << simd << " (auto|scalar|avx2|avx512)" << endl;
+                return 1;
+            }
+        } else if (arg == "--warm-start" && i + 1 < argc) {
+            warmStartFiles.push_back(argv[++i]);
+        } else if (arg == "--save-solution" && i + 1 < argc) {
+            solutionPath = argv[++i];
+        } else if (arg == "--instance-cache" && i + 1 < argc) {
+            instanceCacheDir = argv[++i];
+        } else if (arg == "--dense-limit" && i + 1 < argc) {
+            denseLimit = max(0LL, atoll(argv[++i]));
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchPath = argv[++i];
+        } else if (arg == "--batch-output" && i + 1 < argc) {
+            batch.csvPath = argv[++i];
+        } else if (arg == "--batch-jsonl" && i + 1 < argc) {
+            batch.jsonlPath = argv[++i];
+        } else if (arg == "--quiet") {
+            logLevel = LOG_WARN;
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            int level = parseLogLevel(argv[++i]);
+            if (level < 0) {
+                cerr << "Unknown log level: " << argv[i] << " (error|warn|info|debug)" << endl;
+                return 1;
+            }
+            if (level > LOG_COMPILED_LEVEL) {
+                cerr << "Warning: debug logging is compiled out, build with make debug" << endl;
+            }
+            logLevel = level;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    // Batch: positional là [GENERATIONS] [POPULATION_SIZE] [NUM_RUNS] mặc định cho file job
+    if (!batchPath.empty()) {
+        if (args.size() >= 1) batch.generations = max(1, atoi(args[0].c_str()));
+        if (args.size() >= 2) batch.population = max(2, atoi(args[1].c_str()));
+        if (args.size() >= 3) batch.runs = max(1, atoi(args[2].c_str()));
+        if (!tracePath.empty() || !warmStart.checkpointPath.empty() || !warmStart.resumePath.empty()
+            || !warmStartFiles.empty() || !solutionPath.empty()) {
+            GA_LOG(LOG_WARN) << "Warning: --trace, --checkpoint, --resume, --warm-start and --save-solution"
+                             << " are ignored with --batch" << endl;
+        }
+        if (simdRequested >= 0) setFitnessSimd((SimdLevel)simdRequested);
+        batch.seed = seed;
+        batch.numThreads = numThreads;
+        batch.neighborK = neighborK;
+        batch.denseLimit = denseLimit;
+        batch.cacheDir = instanceCacheDir;
+        batch.targetGap = targetGap;
+        batch.islands = islands;
+        batch.stopping = stopping;
+        batch.evolution = evolution;
+        return runBatch(batchPath, batch);
+    }
+    
+    // Parse positional arguments
+    if (args.size() >= 1) {
+        filename = args[0];
         cout << "📂 Input file: " << filename << endl;
     } else {
-        cout << "Usage: " << argv[0] << " <VRP_FILE> [GENERATIONS] [POPULATION_SIZE] [NUM_RUNS]" << endl;
+        cout << "Usage: " << argv[0] << " <VRP_FILE> [GENERATIONS] [POPULATION_SIZE] [NUM_RUNS]"
+             << " [--threads N] [--parallel-runs K] [--seed S]"
+             << " [--islands K] [--migration-interval M] [--migrants R] [--topology ring|full]"
+             << " [--neighbors K] [--trace FILE.csv|FILE.jsonl] [--time-to-target X]"
+             << " [--time-limit SEC] [--max-stagnation G] [--target-gap X] [--max-evaluations E]"
+             << " [--checkpoint FILE] [--checkpoint-every G] [--resume FILE] [--warm-start FILE]"
+             << " [--save-solution FILE] [--lazy-init B] [--instance-cache DIR] [--dense-limit N]"
+             << " [--batch JOBS_FILE] [--batch-output FILE.csv] [--batch-jsonl FILE.jsonl]"
+             << " [--replacement generational|worst|tournament] [--tournament K] [--decoder separators|split]"
+             << " [--adaptive-operators] [--local-search RATE] [--ls-moves M] [--ls-time-us T]"
+             << " [--diversity] [--diversity-closest K] [--restart-after G] [--simd auto|scalar|avx2|avx512] [--quiet] [--log-level error|warn|info|debug]" << endl;
         cout << "Using default parameters..." << endl;
     }
     
-    if (argc >= 3) {
-        maxGenerations = atoi(argv[2]);
+    if (args.size() >= 2) {
+        maxGenerations = atoi(args[1].c_str());
         if (maxGenerations <= 0) maxGenerations = 1000;
     }
     
-    if (argc >= 4) {
-        populationSize = atoi(argv[3]);
+    if (args.size() >= 3) {
+        populationSize = atoi(args[2].c_str());
         if (populationSize <= 0) populationSize = 800;
     }
     
-    if (argc >= 5) {
-        numRuns = atoi(argv[4]);
+    if (args.size() >= 4) {
+        numRuns = atoi(args[3].c_str());
         if (numRuns <= 0) numRuns = 1;
     }
     
@@ -2384,43 +6146,109 @@ int main(int argc, char* argv[]) {
     vector<pair<double,double>> coords;
     vector<int> demand;
     
-    cout << "📂 Reading problem file: " << filename << endl;
-    readCVRP(filename, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime);
+    GA_LOG(LOG_INFO) << "📂 Reading problem file: " << filename << endl;
+    DistMatrix dist;      // instance và dist đọc một lần, dùng chung cho mọi run
+    if (!loadCVRPWithDist(filename, instanceCacheDir, neighborK, denseLimit, n, capacity, coords, demand, depot,
+                          vehicles, maxDistance, serviceTime, dist)) {
+        return 1;
+    }
     
     // Extract optimal cost from file
     double optimalCost = extractOptimalCost(filename);
     
-    cout << "\nProblem Configuration:" << endl;
-    cout << "   Customers: " << n-1 << endl;
-    cout << "   Capacity: " << capacity << endl;
-    cout << "   Depot: " << depot << endl;
-    cout << "   Vehicles: " << vehicles << endl;
-    cout << "   Optimal cost: " << (optimalCost > 0 ? to_string(optimalCost) : "Unknown") << endl;
+    GA_LOG(LOG_INFO) << "\nProblem Configuration:" << endl;
+    GA_LOG(LOG_INFO) << "   Customers: " << n-1 << endl;
+    GA_LOG(LOG_INFO) << "   Capacity: " << capacity << endl;
+    GA_LOG(LOG_INFO) << "   Depot: " << depot << endl;
+    GA_LOG(LOG_INFO) << "   Vehicles: " << vehicles << endl;
+    GA_LOG(LOG_INFO) << "   Optimal cost: " << (optimalCost > 0 ? to_string(optimalCost) : "Unknown") << endl;
     
     // Calculate total demand
     int totalDemand = 0;
     for (int i = 2; i <= n; i++) {
         totalDemand += demand[i];
     }
-    cout << "   Total demand: " << totalDemand << endl;
-    cout << "   Min vehicles needed: " << ceil(totalDemand / (double)capacity) << endl;
-    
-    cout << "\nAlgorithm Parameters:" << endl;
-    cout << "   Generations: " << maxGenerations << endl;
-    cout << "   Population size: " << populationSize << endl;
-    cout << "   Number of runs: " << numRuns << endl;
+    GA_LOG(LOG_INFO) << "   Total demand: " << totalDemand << endl;
+    GA_LOG(LOG_INFO) << "   Min vehicles needed: " << ceil(totalDemand / (double)capacity) << endl;
+    
+    GA_LOG(LOG_INFO) << "\nAlgorithm Parameters:" << endl;
+    GA_LOG(LOG_INFO) << "   Generations: " << maxGenerations << endl;
+    GA_LOG(LOG_INFO) << "   Population size: " << populationSize << endl;
+    GA_LOG(LOG_INFO) << "   Number of runs: " << numRuns << endl;
+    parallelRuns = resolveThreadCount(parallelRuns);
+    GA_LOG(LOG_INFO) << "   Threads: " << resolveThreadCount(numThreads) << endl;
+    GA_LOG(LOG_INFO) << "   Parallel runs: " << min(parallelRuns, numRuns) << endl;
+    if (simdRequested >= 0) {
+        SimdLevel level = setFitnessSimd((SimdLevel)simdRequested);
+        GA_LOG(LOG_INFO) << "   Fitness kernel: " << simdLevelName(level)
+                         << (level != (SimdLevel)simdRequested
+                             ? string(" (") + simdLevelName((SimdLevel)simdRequested) + " not supported by this CPU)" : "")
+                         << endl;
+    }
+    if (islands.islands > 1) {
+        GA_LOG(LOG_INFO) << "   Islands: " << islands.islands << " (" 
+             << (islands.topology == MigrationTopology::Ring ? "ring" : "full") << ", "
+             << islands.migrants << " migrants every " << islands.interval << " generations)" << endl;
+    }
+    if (seed >= 0) {
+        GA_LOG(LOG_INFO) << "   Seed: " << seed << endl;
+    }
+    GA_LOG(LOG_INFO) << "   Neighbor lists: " << (neighborK > 0 ? to_string(neighborK) : "off (full scan)") << endl;
+    GA_LOG(LOG_INFO) << "   Distances: " << (dist.onDemand() ? "on demand (more than " + to_string(denseLimit) + " nodes)"
+                                                             : string("dense matrix"))
+                     << ", " << (dist.memoryBytes() + 524288) / 1048576 << " MB" << endl;
+    if (evolution.steadyState()) {
+        GA_LOG(LOG_INFO) << "   Replacement: " << replacementName(evolution.replacement) << endl;
+    }
+    if (evolution.decoder == Decoder::Split) {
+        GA_LOG(LOG_INFO) << "   Decoder: split" << endl;
+    }
+    if (evolution.adaptiveOperators) {
+        GA_LOG(LOG_INFO) << "   Operator selection: adaptive" << endl;
+    }
     
-    // Extract instance name without extension and path
-    string instanceName = filename;
-    size_t lastSlash = instanceName.find_last_of("/\\");
-    if (lastSlash != string::npos) {
-        instanceName = instanceName.substr(lastSlash + 1);
+    TraceWriter traceWriter;
+    TraceOptions traceOptions;
+    traceOptions.optimalCost = optimalCost;
+    traceOptions.targetGap = targetGap;
+    stopping.optimalCost = optimalCost;
+    if (stopping.targetGap > 0 && optimalCost <= 0) {
+        GA_LOG(LOG_WARN) << "Warning: --target-gap ignored, optimal cost unknown" << endl;
     }
-    size_t dotPos = instanceName.find_last_of('.');
-    if (dotPos != string::npos) {
-        instanceName = instanceName.substr(0, dotPos);
+    for (const string& path : warmStartFiles) {
+        vector<int> seq = loadSolution(path, n, depot);
+        if (seq.empty()) {
+            GA_LOG(LOG_WARN) << "Warning: cannot read seed solution " << path << endl;
+            continue;
+        }
+        warmStart.seeds.push_back(seq);
+        GA_LOG(LOG_INFO) << "   Warm start: " << path << endl;
+    }
+    if (!warmStart.checkpointPath.empty()) {
+        GA_LOG(LOG_INFO) << "   Checkpoint: " << warmStart.checkpointPath << " every "
+                         << warmStart.checkpointInterval << " generations" << endl;
+    }
+    if (stopping.any() && logEnabled(LOG_INFO)) {
+        cout << "   Stop when:";
+        if (stopping.timeLimitSeconds > 0) cout << " " << stopping.timeLimitSeconds << "s elapsed;";
+        if (stopping.maxStagnation > 0) cout << " " << stopping.maxStagnation << " generations without improvement;";
+        if (stopping.hasTargetGap()) cout << " within " << stopping.targetGap << "% of optimal;";
+        if (stopping.maxEvaluations > 0) cout << " " << stopping.maxEvaluations << " evaluations;";
+        cout << endl;
+    }
+    if (!tracePath.empty()) {
+        if (traceWriter.open(tracePath, evolution.adaptiveOperators)) {
+            traceOptions.writer = &traceWriter;
+            phaseTimingEnabled = true;
+            GA_LOG(LOG_INFO) << "   Trace: " << tracePath << endl;
+        } else {
+            cerr << "Cannot open trace file " << tracePath << ", tracing disabled" << endl;
+        }
     }
     
+    // Extract instance name without extension and path
+    string instanceName = instanceNameOf(filename);
+    
     // Variables for statistics
     vector<double> allCosts;
     vector<int> allVehicles;
@@ -2432,25 +6260,12 @@ int main(int argc, char* argv[]) {
     cout << string(60, '=') << endl;
     
     // Run GA multiple times
-    for (int run = 1; run <= numRuns; ++run) {
-        cout << "\n📊 RUN " << run << "/" << numRuns;
-        if (numRuns > 1) {
-            cout << " (" << fixed << setprecision(1) << (100.0 * run / numRuns) << "% completed)";
-        }
-        cout << endl;
-        cout << string(40, '-') << endl;
-        
-        auto start = chrono::high_resolution_clock::now();
-        GAResult result = runGA(maxGenerations, vehicles, n, capacity, depot, coords, demand, populationSize, maxDistance, serviceTime, run);
-        auto end = chrono::high_resolution_clock::now();
-        
-        auto duration = chrono::duration_cast<chrono::seconds>(end - start);
-        
-        cout << "✅ Run " << run << " completed in " << duration.count() << "s" << endl;
-        cout << "   Cost: " << fixed << setprecision(2) << result.bestCost << endl;
-        cout << "   Vehicles: " << result.vehiclesUsed << endl;
-        cout << "   Status: " << (result.isFeasible ? "✅ FEASIBLE" : "❌ INFEASIBLE") << endl;
-        
+    vector<GAResult> results = runMultipleGA(numRuns, parallelRuns, maxGenerations, vehicles, n, capacity, depot,
+                                             coords, demand, dist, populationSize, maxDistance, serviceTime,
+                                             numThreads, seed, islands, &traceOptions, &stopping, &warmStart,
+                                             &evolution);
+    
+    for (const GAResult& result : results) {
         allCosts.push_back(result.bestCost);
         allVehicles.push_back(result.vehiclesUsed);
         allFeasible.push_back(result.isFeasible);
@@ -2508,6 +6323,37 @@ int main(int argc, char* argv[]) {
         cout << "   Mean vehicles:  " << fixed << setprecision(1) << meanVehicles << endl;
         cout << "   Max vehicles:   " << maxVehicles << endl;
         
+        if (optimalCost > 0) {
+            vector<double> targetTimes;
+            for (const GAResult& result : results) {
+                if (result.timeToTarget >= 0) targetTimes.push_back(result.timeToTarget);
+            }
+            cout << "\n⏱️ TIME TO TARGET (within " << fixed << setprecision(2) << targetGap << "% of optimal):" << endl;
+            cout << "   Reached in:   " << targetTimes.size() << "/" << numRuns << " runs" << endl;
+            if (!targetTimes.empty()) {
+                cout << "   Fastest:      " << *min_element(targetTimes.begin(), targetTimes.end()) << "s" << endl;
+                cout << "   Mean:         " << accumulate(targetTimes.begin(), targetTimes.end(), 0.0) / targetTimes.size() << "s" << endl;
+            }
+        }
+        
+        if (stopping.any()) {
+            map<string, int> reasons;
+            double totalGenerations = 0, totalEvaluations = 0, totalSeconds = 0;
+            for (const GAResult& result : results) {
+                reasons[stopReasonName(result.stopReason)]++;
+                totalGenerations += result.generations;
+                totalEvaluations += result.evaluations;
+                totalSeconds += result.elapsedSeconds;
+            }
+            cout << "\n🛑 STOPPING:" << endl;
+            for (const auto& reason : reasons) {
+                cout << "   " << left << setw(16) << reason.first << right << reason.second << "/" << numRuns << " runs" << endl;
+            }
+            cout << "   Mean generations:  " << fixed << setprecision(1) << totalGenerations / numRuns << endl;
+            cout << "   Mean evaluations:  " << fixed << setprecision(0) << totalEvaluations / numRuns << endl;
+            cout << "   Mean time:         " << fixed << setprecision(2) << totalSeconds / numRuns << "s" << endl;
+        }
+        
         // Export best result to CSV with GAP calculation
         exportToCSV(instanceName, minVehicles, populationSize, maxGenerations, minCost, optimalCost);
         
@@ -2517,6 +6363,14 @@ int main(int argc, char* argv[]) {
              << ", Vehicles = " << allVehicles[bestIndex] 
              << ", Status = " << (allFeasible[bestIndex] ? "FEASIBLE" : "INFEASIBLE") << endl;
         
+        if (!solutionPath.empty()) {
+            if (saveSolution(solutionPath, results[bestIndex].bestSequence, minCost, depot)) {
+                cout << "   Solution written to " << solutionPath << endl;
+            } else {
+                cerr << "Cannot write solution file " << solutionPath << endl;
+            }
+        }
+        
     } else {
         cout << "\n❌ ERROR: No valid results obtained!" << endl;
         return 1;
@@ -2525,3 +6379,4 @@ int main(int argc, char* argv[]) {
     cout << "\n✅ Execution completed successfully!" << endl;
     return 0;
 }
+#endif // CVRP_NO_MAIN
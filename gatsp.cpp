@@ -8,6 +8,11 @@
 #include <limits>
 #include <iomanip>
 #include <numeric>
+
+#include "cvrp_core.h"
+
+// Prototype GA: sinh quần thể dạng giant tour, sửa bằng repair operator và chọn cá thể tốt
+// nhất. Đọc instance, ma trận khoảng cách, decoder, đánh giá và repair dùng lõi cvrp_core.h.
 using namespace std;
 struct GaElement {
     int c1 , r1 ,c2 ,r2 ; 
@@ -16,97 +21,6 @@ struct solution {
     vector<vector<int>> routes;
     double totalCost;
 };
-double euclidDist(double x1, double y1, double x2, double y2) {
-    return round(sqrt((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2)) * 100.0) / 100.0;
-};
-// Đọc dữ liệu CVRP chuẩn TSPLIB
-void readCVRP(const string& filename, int& n, int& capacity, vector<pair<double,double>>& coords, vector<int>& demand, int& depot) {
-    ifstream file (filename);
-    if (!file.is_open()) {
-        cerr << "Khong the mo file " << filename << endl;
-        exit(1);
-    }
-    string line; 
-    n=0; capacity=0; depot=0;
-    while (getline(file, line)) {
-        if (line.find("DIMENSION") != string::npos) {
-            size_t pos = line.find(":");
-            n = stoi(line.substr(pos+1));
-        }
-        if (line.find("CAPACITY") != string::npos) {
-            size_t pos = line.find(":");
-            capacity = stoi(line.substr(pos+1));
-        }
-        if (line.find("NODE_COORD_SECTION") != string::npos) break;
-    }
-      for (int i = 1; i <= n; ++i) {
-        int idx;
-        double x, y;
-        file >> idx >> x >> y;
-        coords[idx] = {x, y};
-    }
-    while (getline(file, line)) {
-        if (line.find("DEMAND_SECTION") != string::npos) break;
-    }
-    demand.resize(n+1);
-    for (int i = 1; i <= n; ++i) {
-        int idx, d;
-        file >> idx >> d;
-        demand[idx] = d;
-    }
-    while (getline(file, line)) {
-        if (line.find("DEPOT_SECTION") != string::npos) break;
-    }
-    file >> depot;
-    // Bỏ qua -1 và EOF
-    if (file.eof()) {
-        cerr << "File ket thuc bat ngo!" << endl;
-        exit(1);
-    }
-}
-
-// Tạo ma trận khoảng cách
-vector<vector<double>> buildDist(const vector<pair<double,double>>& coords) {
-    int n = coords.size() - 1;
-    vector<vector<double>> dist(n+1, vector<double>(n+1, 0));
-    for (int i = 1; i <= n; ++i)
-        for (int j = 1; j <= n; ++j)
-            dist[i][j] = euclidDist(coords[i].first, coords[i].second, coords[j].first, coords[j].second);
-    return dist;
-}
-
-int routeDemand(const vector<int>& route, const vector<int>& demand) {
-    int sum = 0;
-    for (size_t i = 1; i < route.size() - 1; ++i)
-        sum += demand[route[i]];
-    return sum;
-}
-
-double routeCost(const vector<int>& route, const vector<vector<double>>& dist) {
-    double cost = 0;
-    for (size_t i = 0; i < route.size() - 1; ++i)
-        cost += dist[route[i]][route[i+1]];
-    return round(cost * 100.0) / 100.0;
-}
-
-double totalCost(const vector<vector<int>>& routes, const vector<vector<double>>& dist) {
-    double sum = 0;
-    for (const auto& r : routes) sum += routeCost(r, dist);
-    return round(sum * 100.0) / 100.0;
-}
-bool checkSolution(const vector<vector<int>>& routes, const vector<int>& demand, int capacity, int n) {
-    vector<bool> visited(n+1, false);
-    for (const auto& route : routes) {
-        if (routeDemand(route, demand) > capacity) return false;
-        for (size_t i = 1; i < route.size() - 1; ++i) {
-            if (visited[route[i]]) return false;
-            visited[route[i]] = true;
-        }
-    }
-    for (int i = 2; i <= n; ++i)
-        if (!visited[i]) return false;
-    return true;
-}
 vector<vector<int>> initsolution(int vehicle, int n, int capacity, const vector<int>& demand ){
     //1. Tạo danh sách các khách hàng và xáo trộn
     vector<vector<int>> daycacxe; 
@@ -194,59 +108,22 @@ vector<vector<int>> initPopulationSeq(int vehicle, int n, int capacity, const ve
     }
     return populationSeq;
 }
-void repairZero (vector<int>& seq , int vehicle){
-    int zeroCount = count(seq.begin(), seq.end(), 0);
-    int needZero = vehicle - 1 ; 
-    while (zeroCount > needZero) {
-        for (int i = 1; i < seq.size() - 1; i++) {
-            if (seq[i] == 0 && (i == 0 || i == seq.size() - 1 || (i + 1 < seq.size() && seq[i + 1] == 0))) {
-                seq.erase(seq.begin() + i);
-                zeroCount--;
-                if (zeroCount == needZero) break;
-            }
-            if (zeroCount > needZero) {
-                auto it = find(seq.begin(), seq.end(), 0);
-                if (it != seq.end()) {
-                    seq.erase(it);
-                    zeroCount--;
-                }
-                if (zeroCount == needZero) break;
-
-            }
-        }
-    }
-}
-void repairCustomer (vector<int>&seq, int n ){
-vector<int> count(n+1, 0);
-for (int v : seq) if (v != 0) count[v]++;   
-vector<int> missing;
-for (int i = 2; i <= n; ++i) {
-    if (count[i] == 0) missing.push_back(i);    
-    int idx = 0;
-    for (int& v : seq) {
-        if (v != 0 && count[v] > 1) {
-            v = missing[idx++];
-            
-            count[v]--;
-            if (idx >= missing.size()) break;
-        }
-    }
-} 
-}
 void generatePopulation(const string& filename, int vehicle) {
     // 1. Đọc dữ liệu
-    int n, capacity, depot;
-    vector<pair<double,double>> coords(1000); // Giả sử tối đa 1000 node
+    int n, capacity, depot, vehicles;
+    double maxDistance, serviceTime;
+    vector<pair<double,double>> coords;
     vector<int> demand;
-    readCVRP(filename, n, capacity, coords, demand, depot);
+    if (!readCVRP(filename, n, capacity, coords, demand, depot, vehicles, maxDistance, serviceTime)) return;
 
     // 2. Sinh quần thể dạng sequence
     vector<vector<int>> populationSeq = initPopulationSeq(vehicle, n, capacity, demand);
 
     // 3. Sửa từng cá thể nếu cần (đảm bảo hợp lệ)
+    mt19937 gen(random_device{}());
     for (auto& seq : populationSeq) {
-        repairZero(seq, vehicle);
-        repairCustomer(seq, n);
+        repairZero(seq, vehicle, gen);
+        repairCustomer(seq, n, gen);
     }
 
     // 4. In ra quần thể (tuỳ chọn)
@@ -256,34 +133,17 @@ void generatePopulation(const string& filename, int vehicle) {
         cout << endl;
     }
 }
-// Hàm giải mã dãy sequence thành các routemã dãy sequence thành các route
-vector<vector<int>> decodeSeq(const vector<int>& seq, int depot) {
-    vector<vector<int>> routes;
-    vector<int> currentRoute = {depot};
-    for (int v : seq) {
-        if (v == 0) {
-            currentRoute.push_back(depot);
-            routes.push_back(currentRoute);
-            currentRoute = {depot};
-        } else {
-            currentRoute.push_back(v);
-        }
-    }
-    if (currentRoute.size() > 1) {
-        currentRoute.push_back(depot);
-        routes.push_back(currentRoute);
-    }
-    return routes;
-}
 
-// Hàm tìm cá thể tốt nhất trong quần thể
-void findBestIndividual(const vector<vector<int>>& populationSeq, int depot, const vector<pair<double,double>>& coords) {
-    vector<vector<double>> dist = buildDist(coords);
+// Hàm tìm cá thể tốt nhất trong quần thể (tổng quãng đường các tuyến, kernel TSP của lõi)
+void findBestIndividual(const vector<vector<int>>& populationSeq, int depot, const DistMatrix& dist) {
+    RouteConstraints tour;
+    tour.depot = depot;
+    tour.variant = ProblemVariant::TSP;
     double bestCost = numeric_limits<double>::max();
     int bestIdx = -1;
     for (size_t i = 0; i < populationSeq.size(); ++i) {
-        vector<vector<int>> routes = decodeSeq(populationSeq[i], depot);
-        double cost = totalCost(routes, dist);
+        bool feasible;
+        double cost = evaluateGenes(populationSeq[i].data(), populationSeq[i].size(), tour, dist, feasible);
         cout << "Individual " << i+1 << " cost: " << cost << endl;
         if (cost < bestCost) {
             bestCost = cost;
@@ -292,23 +152,29 @@ void findBestIndividual(const vector<vector<int>>& populationSeq, int depot, con
     }
     cout << "Best individual is " << bestIdx+1 << " with cost = " << bestCost << endl;
 }
-void runCMT1() {
-    string filename = "CMT1.txt";
+bool runCMT1() {
+    string filename = "CMT1.vrp";
     int vehicle = 5; // Số xe, bạn có thể thay đổi nếu cần
 
-    // 1. Đọc dữ liệu
-    int n, capacity, depot;
-    vector<pair<double,double>> coords(1000);
+    // 1. Đọc dữ liệu và ma trận khoảng cách (không cần danh sách láng giềng)
+    int n, capacity, depot, vehicles;
+    double maxDistance, serviceTime;
+    vector<pair<double,double>> coords;
     vector<int> demand;
-    readCVRP(filename, n, capacity, coords, demand, depot);
+    DistMatrix dist;
+    if (!loadCVRPWithDist(filename, "", 0, DEFAULT_DENSE_LIMIT, n, capacity, coords, demand, depot, vehicles,
+                          maxDistance, serviceTime, dist)) {
+        return false;
+    }
 
     // 2. Sinh quần thể
     vector<vector<int>> populationSeq = initPopulationSeq(vehicle, n, capacity, demand);
 
     // 3. Sửa từng cá thể nếu cần
+    mt19937 gen(random_device{}());
     for (auto& seq : populationSeq) {
-        repairZero(seq, vehicle);
-        repairCustomer(seq, n);
+        repairZero(seq, vehicle, gen);
+        repairCustomer(seq, n, gen);
     }
 
     // 4. In ra quần thể
@@ -319,11 +185,10 @@ void runCMT1() {
     }
 
     // 5. Tìm cá thể tốt nhất
-    findBestIndividual(populationSeq, depot, coords);
+    findBestIndividual(populationSeq, depot, dist);
+    return true;
 }
 int main() {
-    runCMT1();
-    return 0;
+    return runCMT1() ? 0 : 1;
 }
 
-
@@ -6,7 +6,7 @@ echo "========================================"
 
 # Biên dịch chương trình
 echo "📦 Compiling ga8.cpp..."
-g++ -std=c++17 -O2 ga8.cpp -o ga8
+g++ -std=c++17 -O2 -pthread ga8.cpp -o ga8
 if [ $? -ne 0 ]; then
     echo "❌ Compilation failed!"
     exit 1
@@ -14,67 +14,29 @@ fi
 echo "✅ Compilation successful!"
 
 # Xóa file kết quả cũ nếu có
-rm -f ga_results.csv
+rm -f run_results.csv
 rm -f run_summary.txt
 
-# Tạo header cho file summary
-echo "Run,Best_Cost,Is_Feasible,Vehicles_Used,Execution_Time" > run_summary.txt
-
 echo ""
 echo "🔄 Starting 100 runs..."
 echo "======================="
 
-# Chạy 100 lần
-for i in {1..100}; do
-    echo -n "Run $i/100: "
-    
-    # Ghi thời gian bắt đầu
-    start_time=$(date +%s.%N)
-    
-    # Chạy GA và lưu output
-    ./ga8 > temp_output_$i.txt 2>&1
-    
-    # Ghi thời gian kết thúc
-    end_time=$(date +%s.%N)
-    execution_time=$(echo "$end_time - $start_time" | bc -l)
-    
-    # Trích xuất kết quả từ output
-    if [ -f "ga_results.csv" ]; then
-        # Lấy dòng cuối của CSV (kết quả mới nhất)
-        last_result=$(tail -n 1 ga_results.csv)
-        
-        # Parse kết quả
-        instance=$(echo $last_result | cut -d',' -f1)
-        vehicles=$(echo $last_result | cut -d',' -f2)
-        population=$(echo $last_result | cut -d',' -f3)
-        cost=$(echo $last_result | cut -d',' -f4)
-        
-        # Kiểm tra feasibility từ output
-        if grep -q "FEASIBLE" temp_output_$i.txt && ! grep -q "INFEASIBLE" temp_output_$i.txt; then
-            feasible="TRUE"
-        else
-            feasible="FALSE"
-        fi
-        
-        # Ghi vào summary
-        printf "%d,%.2f,%s,%s,%.3f\n" $i $cost $feasible $vehicles $execution_time >> run_summary.txt
-        
-        echo "Cost: $cost, Feasible: $feasible, Time: ${execution_time}s"
-    else
-        echo "❌ No results generated"
-        printf "%d,ERROR,FALSE,0,%.3f\n" $i $execution_time >> run_summary.txt
-    fi
-    
-    # Cleanup temp file
-    rm -f temp_output_$i.txt
-    
-    # Progress indicator every 10 runs
-    if [ $((i % 10)) -eq 0 ]; then
-        echo ""
-        echo "✓ Completed $i/100 runs..."
-        echo ""
-    fi
-done
+# Một process cho cả 100 run: CMT1.vrp đọc một lần, các run chia cho mọi core,
+# mỗi run một dòng trong run_results.csv
+echo "CMT1.vrp 100" > run_jobs.txt
+./ga8 --batch run_jobs.txt 100 500 --batch-output run_results.csv
+rm -f run_jobs.txt
+
+if [ ! -f run_results.csv ]; then
+    echo "❌ No results generated"
+    exit 1
+fi
+
+# Tạo file summary: Run, Best_Cost, Feasible, Total_Vehicles, Execution_Time_Seconds
+echo "Run,Best_Cost,Is_Feasible,Vehicles_Used,Execution_Time" > run_summary.txt
+tail -n +2 run_results.csv | sort -t',' -k2,2n | awk -F',' '{
+    printf "%d,%.2f,%s,%d,%.3f\n", $2, $8, ($11 == 1 ? "TRUE" : "FALSE"), $7, $14
+}' >> run_summary.txt
 
 echo ""
 echo "🎉 All 100 runs completed!"
@@ -177,7 +139,7 @@ EOF
 echo "✅ Results saved to:"
 echo "   - run_summary.txt (detailed results)"
 echo "   - final_summary.txt (statistical summary)"
-echo "   - ga_results.csv (latest GA output)"
+echo "   - run_results.csv (one row per run)"
 
 echo ""
 echo "📋 Quick Summary:"
@@ -117,16 +117,17 @@ echo ""
 
 # Create results directory
 mkdir -p "$RESULTS_DIR"
+RESULTS_DIR="$(cd "$RESULTS_DIR" && pwd)"  # absolute: the solver may run from gatest/
 echo -e "${GREEN}✅ Created results directory: $RESULTS_DIR${NC}"
 
 # Compile the solver
 echo -e "${YELLOW}🔨 Compiling CVRP Solver...${NC}"
 if [ -f "ga8.cpp" ]; then
-    g++ -std=c++17 -O3 -o ga8 ga8.cpp
+    g++ -std=c++17 -O3 -pthread -o ga8 ga8.cpp
 elif [ -f "gatest/ga8.cpp" ]; then
     echo "Working from parent directory..."
     cd gatest
-    g++ -std=c++17 -O3 -o ga8 ga8.cpp
+    g++ -std=c++17 -O3 -pthread -o ga8 ga8.cpp
 else
     echo -e "${RED}❌ Error: ga8.cpp not found${NC}"
     exit 1
@@ -139,186 +140,153 @@ fi
 echo -e "${GREEN}✅ Compilation successful!${NC}"
 echo ""
 
-# Initialize consolidated results file with Excel-friendly headers
-CONSOLIDATED_CSV="../$RESULTS_DIR/consolidated_results.csv"
-echo "Instance,Total_Vehicles,Population_Size,Max_Generations,Best_Cost,Optimal_Cost,GAP_Percent,Execution_Time_Seconds,Number_of_Runs" > "$CONSOLIDATED_CSV"
-
-# Function to run solver for a specific instance
-run_instance() {
-    local instance=$1
-    local gens=$2
-    local pop=$3
-    local runs=$4
-    
-    # Determine VRP file path
-    local vrp_file
-    if [ -f "../${instance}.vrp" ]; then
-        vrp_file="../${instance}.vrp"
-    elif [ -f "${instance}.vrp" ]; then
-        vrp_file="${instance}.vrp"
-    else
-        echo -e "${RED}  ❌ Error: ${instance}.vrp not found${NC}"
-        return 1
-    fi
-    
-    local instance_dir="../$RESULTS_DIR/${instance}"
-    
-    echo -e "${PURPLE}📊 Processing $instance ($runs runs)...${NC}"
-    
-    # Create instance-specific directory
-    mkdir -p "$instance_dir"
-    
-    echo "  📂 Running solver with parameters:"
-    echo "     - VRP file: $vrp_file"
-    echo "     - Generations: $gens"
-    echo "     - Population: $pop"
-    echo "     - Runs: $runs"
-    
-    start_time=$(date +%s)
-    
-    # Run with timeout and capture output
-    timeout 3600 ./ga8 "$vrp_file" "$gens" "$pop" "$runs" > "$instance_dir/output.log" 2>&1
-    exit_code=$?
-    
-    end_time=$(date +%s)
-    runtime=$((end_time - start_time))
-    
-    # Check results
-    if [ $exit_code -eq 0 ]; then
-        echo -e "${GREEN}  ✅ Completed successfully in ${runtime}s${NC}"
-        
-        if [ -f "ga_results.csv" ]; then
-            # Copy results to instance directory
-            cp ga_results.csv "$instance_dir/"
-            
-            # Parse the result and append to consolidated CSV
-            tail -n +2 ga_results.csv | while IFS=',' read -r inst vehicles pop_size max_gens cost optimal gap; do
-                echo "$inst,$vehicles,$pop_size,$max_gens,$cost,$optimal,$gap,$runtime,$runs" >> "$CONSOLIDATED_CSV"
-            done
-            
-            # Display key results
-            tail -n +2 ga_results.csv | while IFS=',' read -r inst vehicles pop_size max_gens cost optimal gap; do
-                echo -e "${GREEN}  📈 Results: Cost=$cost, Vehicles=$vehicles"
-                if [ "$gap" != "-1.00" ] && [ -n "$gap" ]; then
-                    echo -e "     GAP=${gap}%, Optimal=$optimal, Gens=$max_gens${NC}"
-                else
-                    echo -e "     GAP=N/A (optimal unknown), Gens=$max_gens${NC}"
-                fi
-            done
-            
-            # Generate Excel format if requested
-            if [ "$EXCEL_OUTPUT" = true ]; then
-                # Create tab-separated version for Excel
-                sed 's/,/\t/g' ga_results.csv > "$instance_dir/results_excel.tsv"
-                echo -e "${GREEN}  📊 Excel format created: ${instance}_results_excel.tsv${NC}"
-            fi
-            
-            # Clean up for next run
-            rm ga_results.csv
-        else
-            echo -e "${YELLOW}  ⚠️  Warning: ga_results.csv not found${NC}"
-        fi
-        
-        # Create detailed instance summary
-        create_instance_summary "$instance" "$instance_dir" "$runtime" "$runs"
-        
-    elif [ $exit_code -eq 124 ]; then
-        echo -e "${RED}  ❌ Timeout after 3600s (1 hour)${NC}"
-    else
-        echo -e "${RED}  ❌ Failed with exit code $exit_code${NC}"
-        echo -e "${YELLOW}  📄 Check detailed log: $instance_dir/output.log${NC}"
-    fi
-    
-    echo ""
-}
-
-# Function to create detailed instance summary
+# Function to create detailed instance summary from its rows of the batch results
 create_instance_summary() {
     local instance=$1
     local instance_dir=$2
-    local runtime=$3
-    local runs=$4
-    
-    if [ -f "$instance_dir/ga_results.csv" ]; then
-        cat > "$instance_dir/summary_report.md" << EOF
+
+    # consolidated row: Instance,Total_Vehicles,Population_Size,Max_Generations,Best_Cost,
+    # Optimal_Cost,GAP_Percent,Execution_Time_Seconds,Number_of_Runs
+    local row
+    row=$(grep "^${instance}," "$CONSOLIDATED_CSV")
+    [ -z "$row" ] && return 1
+    IFS=',' read -r inst vehicles pop gens cost optimal gap runtime runs <<< "$row"
+
+    cat > "$instance_dir/summary_report.md" << EOF
 # CVRP Solver Results - $instance
 
 ## Test Configuration
 - **Instance**: $instance
-- **Generations**: $GENERATIONS
-- **Population Size**: $POPULATION
+- **Generations**: $gens
+- **Population Size**: $pop
 - **Number of Runs**: $runs
-- **Execution Time**: ${runtime} seconds
+- **Execution Time**: ${runtime} seconds (sum over runs)
 - **Timestamp**: $(date)
 
 ## Results Summary
 \`\`\`
-$(cat "$instance_dir/ga_results.csv")
+$(cat "$instance_dir/runs.csv")
 \`\`\`
 
 ## Detailed Analysis
-$(tail -n +2 "$instance_dir/ga_results.csv" | while IFS=',' read -r inst vehicles pop cost optimal gap; do
-    echo "### Performance Metrics"
-    echo "- **Best Cost Found**: $cost"
-    echo "- **Optimal Cost (from file)**: $optimal"
-    if [ "$gap" != "-1.00" ] && [ -n "$gap" ]; then
-        echo "- **GAP from Optimal**: $gap%"
-        if (( $(echo "$gap < 5.0" | bc -l) )); then
-            echo "  - 🎯 **Excellent** performance (< 5% gap)"
-        elif (( $(echo "$gap < 10.0" | bc -l) )); then
-            echo "  - ✅ **Good** performance (< 10% gap)"
-        else
-            echo "  - ⚠️ **Needs improvement** (> 10% gap)"
-        fi
+### Performance Metrics
+- **Best Cost Found**: $cost
+- **Optimal Cost (from file)**: $optimal
+$(if [ "$gap" != "-1.00" ] && [ -n "$gap" ]; then
+    echo "- **GAP from Optimal**: $gap%"
+    if (( $(echo "$gap < 5.0" | bc -l) )); then
+        echo "  - 🎯 **Excellent** performance (< 5% gap)"
+    elif (( $(echo "$gap < 10.0" | bc -l) )); then
+        echo "  - ✅ **Good** performance (< 10% gap)"
     else
-        echo "- **GAP from Optimal**: Unknown (optimal cost not available)"
+        echo "  - ⚠️ **Needs improvement** (> 10% gap)"
     fi
-    echo "- **Vehicles Used**: $vehicles"
-    echo "- **Population Size**: $pop"
-    echo "- **Execution Time**: ${runtime}s"
-done)
-
-## Execution Log (Last 30 lines)
-\`\`\`
-$(tail -30 "$instance_dir/output.log" 2>/dev/null || echo "No detailed log available")
-\`\`\`
+else
+    echo "- **GAP from Optimal**: Unknown (optimal cost not available)"
+fi)
+- **Vehicles Used**: $vehicles
+- **Population Size**: $pop
+- **Execution Time**: ${runtime}s
 EOF
-        
-        # Create a simple CSV summary for this instance
-        cat > "$instance_dir/instance_summary.csv" << EOF
+
+    # Create a simple CSV summary for this instance
+    cat > "$instance_dir/instance_summary.csv" << EOF
 Metric,Value
 Instance,$instance
-Best_Cost,$(tail -n +2 "$instance_dir/ga_results.csv" | cut -d',' -f4)
-Optimal_Cost,$(tail -n +2 "$instance_dir/ga_results.csv" | cut -d',' -f5)
-GAP_Percent,$(tail -n +2 "$instance_dir/ga_results.csv" | cut -d',' -f6)
-Vehicles_Used,$(tail -n +2 "$instance_dir/ga_results.csv" | cut -d',' -f2)
-Population_Size,$POPULATION
-Generations,$GENERATIONS
+Best_Cost,$cost
+Optimal_Cost,$optimal
+GAP_Percent,$gap
+Vehicles_Used,$vehicles
+Population_Size,$pop
+Generations,$gens
 Runs,$runs
 Execution_Time_Seconds,$runtime
 EOF
-    fi
 }
 
 # Main execution starts here
 echo -e "${BLUE}🏃 Starting advanced batch execution...${NC}"
 echo "========================================"
 
+# One job line per instance ("FILE RUNS"); ga8 --batch loads every instance once
+# and runs all (instance, run) jobs on a worker pool, longest job first
+JOBS_FILE="$RESULTS_DIR/jobs.txt"
+: > "$JOBS_FILE"
 total_instances=${#INSTANCES[@]}
-current=0
-successful_runs=0
-
 for instance in "${INSTANCES[@]}"; do
-    current=$((current + 1))
-    echo -e "${BLUE}[$current/$total_instances] Processing $instance${NC}"
-    
-    if run_instance "$instance" "$GENERATIONS" "$POPULATION" "$NUM_RUNS"; then
-        successful_runs=$((successful_runs + 1))
+    if [ -f "../${instance}.vrp" ]; then
+        echo "../${instance}.vrp $NUM_RUNS" >> "$JOBS_FILE"
+    elif [ -f "${instance}.vrp" ]; then
+        echo "${instance}.vrp $NUM_RUNS" >> "$JOBS_FILE"
+    else
+        echo -e "${RED}  ❌ Error: ${instance}.vrp not found${NC}"
     fi
 done
 
+ALL_RUNS_CSV="$RESULTS_DIR/all_runs.csv"
+echo -e "${PURPLE}📊 Running $(wc -l < "$JOBS_FILE") instances × $NUM_RUNS runs (generations=$GENERATIONS, population=$POPULATION)...${NC}"
+start_time=$(date +%s)
+timeout 3600 ./ga8 --batch "$JOBS_FILE" "$GENERATIONS" "$POPULATION" \
+    --batch-output "$ALL_RUNS_CSV" --batch-jsonl "$RESULTS_DIR/all_runs.jsonl" > "$RESULTS_DIR/batch_output.log" 2>&1
+exit_code=$?
+end_time=$(date +%s)
+runtime=$((end_time - start_time))
+
+if [ $exit_code -eq 0 ]; then
+    echo -e "${GREEN}  ✅ Completed successfully in ${runtime}s${NC}"
+elif [ $exit_code -eq 124 ]; then
+    echo -e "${RED}  ❌ Timeout after 3600s (1 hour)${NC}"
+else
+    echo -e "${RED}  ❌ Failed with exit code $exit_code${NC}"
+    echo -e "${YELLOW}  📄 Check detailed log: $RESULTS_DIR/batch_output.log${NC}"
+fi
+echo ""
+
+# Consolidated results: best run per instance with Excel-friendly headers. all_runs.csv
+# columns: 1 Instance, 5 Population_Size, 6 Max_Generations, 7 Total_Vehicles,
+# 8 Best_Cost, 9 Optimal_Cost, 10 GAP_Percent, 14 Execution_Time_Seconds
+CONSOLIDATED_CSV="$RESULTS_DIR/consolidated_results.csv"
+echo "Instance,Total_Vehicles,Population_Size,Max_Generations,Best_Cost,Optimal_Cost,GAP_Percent,Execution_Time_Seconds,Number_of_Runs" > "$CONSOLIDATED_CSV"
+successful_runs=0
+if [ -f "$ALL_RUNS_CSV" ]; then
+    tail -n +2 "$ALL_RUNS_CSV" | awk -F',' '
+    {
+        if (!($1 in best) || $8 < best[$1]) { best[$1] = $8; row[$1] = $7 "," $5 "," $6 "," $8 "," $9 "," $10 }
+        seconds[$1] += $14; runs[$1]++
+        if (!($1 in order)) { order[$1] = ++count; names[count] = $1 }
+    }
+    END {
+        for (i = 1; i <= count; i++) {
+            name = names[i]
+            printf "%s,%s,%.3f,%d\n", name, row[name], seconds[name], runs[name]
+        }
+    }' >> "$CONSOLIDATED_CSV"
+
+    for instance in "${INSTANCES[@]}"; do
+        grep -q "^${instance}," "$ALL_RUNS_CSV" || continue
+        successful_runs=$((successful_runs + 1))
+        instance_dir="$RESULTS_DIR/${instance}"
+        mkdir -p "$instance_dir"
+        { head -1 "$ALL_RUNS_CSV"; grep "^${instance}," "$ALL_RUNS_CSV"; } > "$instance_dir/runs.csv"
+        create_instance_summary "$instance" "$instance_dir"
+
+        IFS=',' read -r inst vehicles pop gens cost optimal gap inst_time runs <<< "$(grep "^${instance}," "$CONSOLIDATED_CSV")"
+        echo -e "${GREEN}  📈 $instance: Cost=$cost, Vehicles=$vehicles"
+        if [ "$gap" != "-1.00" ] && [ -n "$gap" ]; then
+            echo -e "     GAP=${gap}%, Optimal=$optimal, Gens=$gens${NC}"
+        else
+            echo -e "     GAP=N/A (optimal unknown), Gens=$gens${NC}"
+        fi
+
+        # Generate Excel format if requested
+        if [ "$EXCEL_OUTPUT" = true ]; then
+            sed 's/,/\t/g' "$instance_dir/runs.csv" > "$instance_dir/results_excel.tsv"
+        fi
+    done
+fi
+echo ""
+
 # Generate comprehensive final report
-cd ..
 echo -e "${YELLOW}📈 Generating comprehensive consolidated report...${NC}"
 
 # Create main batch summary
@@ -359,23 +327,23 @@ if [ -f "$RESULTS_DIR/consolidated_results.csv" ] && [ $(wc -l < "$RESULTS_DIR/c
     echo "### Performance Statistics" >> "$RESULTS_DIR/batch_summary.md"
     
     # Count successful runs
-    actual_runs=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | wc -l)
+    actual_runs=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$9} END {print sum+0}')
     echo "- **Actual Completed Runs**: $actual_runs" >> "$RESULTS_DIR/batch_summary.md"
     
     # Average GAP (excluding -1.00 values)
     avg_gap=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '
-        $6 != "-1.00" && $6 != "" && $6 > -999 {sum+=$6; count++} 
+        $7 != "-1.00" && $7 != "" && $7 > -999 {sum+=$7; count++} 
         END {if(count>0) printf "%.2f", sum/count; else print "N/A"}')
     echo "- **Average GAP from Optimal**: ${avg_gap}%" >> "$RESULTS_DIR/batch_summary.md"
     
     # Best GAP achieved
     best_gap=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '
-        $6 != "-1.00" && $6 != "" && $6 > -999 {if(min=="" || $6<min) min=$6} 
+        $7 != "-1.00" && $7 != "" && $7 > -999 {if(min=="" || $7<min) min=$7} 
         END {if(min!="") printf "%.2f", min; else print "N/A"}')
     echo "- **Best GAP Achieved**: ${best_gap}%" >> "$RESULTS_DIR/batch_summary.md"
     
     # Total execution time
-    total_time=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$7} END {print sum}')
+    total_time=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$8} END {print sum}')
     total_minutes=$(echo "scale=1; $total_time / 60" | bc)
     echo "- **Total Execution Time**: ${total_time}s (${total_minutes} minutes)" >> "$RESULTS_DIR/batch_summary.md"
     
@@ -388,9 +356,9 @@ if [ -f "$RESULTS_DIR/consolidated_results.csv" ] && [ $(wc -l < "$RESULTS_DIR/c
     # Performance ranking
     echo "" >> "$RESULTS_DIR/batch_summary.md"
     echo "### Instance Performance Ranking (by GAP)" >> "$RESULTS_DIR/batch_summary.md"
-    tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | sort -t',' -k6,6n | awk -F',' '
-        $6 != "-1.00" && $6 != "" && $6 > -999 {
-            printf "1. **%s**: %.2f%% GAP (Cost: %.2f)\n", $1, $6, $4
+    tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | sort -t',' -k7,7n | awk -F',' '
+        $7 != "-1.00" && $7 != "" && $7 > -999 {
+            printf "1. **%s**: %.2f%% GAP (Cost: %.2f)\n", $1, $7, $5
         }' >> "$RESULTS_DIR/batch_summary.md"
     
 else
@@ -416,15 +384,15 @@ if [ -f "$RESULTS_DIR/consolidated_results.csv" ] && [ $(wc -l < "$RESULTS_DIR/c
     echo ""
     echo -e "${BLUE}📈 Final Statistics:${NC}"
     echo "=================================="
-    actual_runs=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | wc -l)
-    total_time=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$7} END {print sum}')
+    actual_runs=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$9} END {print sum+0}')
+    total_time=$(tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | awk -F',' '{sum+=$8} END {print sum}')
     echo "✅ Completed runs: $actual_runs"
     echo "⏱️  Total execution time: ${total_time}s ($(echo "scale=1; $total_time / 60" | bc) minutes)"
     
     # Show best results summary
     echo ""
     echo -e "${PURPLE}🏆 Best Results per Instance:${NC}"
-    tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | sort -t',' -k1,1 -k4,4n | awk -F',' '
+    tail -n +2 "$RESULTS_DIR/consolidated_results.csv" | sort -t',' -k1,1 -k5,5n | awk -F',' '
     {
         if ($1 != last_instance) {
             if (last_instance != "") {
@@ -433,8 +401,8 @@ if [ -f "$RESULTS_DIR/consolidated_results.csv" ] && [ $(wc -l < "$RESULTS_DIR/c
                 printf ", Vehicles = %d\n", best_vehicles;
             }
             last_instance = $1;
-            best_cost = $4;
-            best_gap = $6;
+            best_cost = $5;
+            best_gap = $7;
             best_vehicles = $2;
         }
     }
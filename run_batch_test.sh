@@ -67,7 +67,7 @@ mkdir -p "$RESULTS_DIR"
 
 # Compile the solver
 echo "Compiling CVRP Solver..."
-g++ -std=c++17 -O3 -o cvrp_solver ga8.cpp
+g++ -std=c++17 -O3 -pthread -o cvrp_solver ga8.cpp
 if [ $? -ne 0 ]; then
     echo "Compilation failed!"
     exit 1
@@ -75,60 +75,18 @@ fi
 echo "Compilation successful!"
 echo ""
 
-# Function to run solver for a specific instance
-run_instance() {
-    local instance=$1
-    local gens=$2
-    local pop=$3
-    local runs=$4
-    local output_file="$RESULTS_DIR/${instance}_output.log"
-    
-    echo "Processing $instance.vrp ($runs runs)..."
-    
+# Build the job file: one line "FILE RUNS SEED GENERATIONS POPULATION" per instance
+# ("-" = random seed). cvrp_solver --batch loads each instance once and schedules
+# every (instance, run) job on a worker pool, longest job first.
+JOBS_FILE="$RESULTS_DIR/jobs.txt"
+: > "$JOBS_FILE"
+for instance in "${INSTANCES[@]}"; do
     # Check if VRP file exists
     if [ ! -f "${instance}.vrp" ]; then
         echo "  Warning: ${instance}.vrp not found, skipping..."
-        return 1
-    fi
-    
-    echo "  Running solver with parameters: generations=$gens, population=$pop, runs=$runs"
-    start_time=$(date +%s)
-    
-    # Run with timeout and capture output - using command line arguments
-    timeout 600 ./cvrp_solver "${instance}.vrp" "$gens" "$pop" "$runs" > "$output_file" 2>&1
-    exit_code=$?
-    
-    end_time=$(date +%s)
-    runtime=$((end_time - start_time))
-    
-    # Check results
-    if [ $exit_code -eq 0 ]; then
-        echo "  ✓ Completed successfully in ${runtime}s"
-        if [ -f ga_results.csv ]; then
-            # Get the last result from CSV and add instance info
-            tail -n 1 ga_results.csv >> "$RESULTS_DIR/all_results.csv"
-        fi
-    elif [ $exit_code -eq 124 ]; then
-        echo "  ✗ Timeout after 600s"
-    else
-        echo "  ✗ Failed with exit code $exit_code"
-        echo "  Check log: $output_file"
-    fi
-    
-    # Move results
-    if [ -f ga_results.csv ]; then
-        cp ga_results.csv "$RESULTS_DIR/${instance}_results.csv"
-        rm ga_results.csv  # Clean up for next run
+        continue
     fi
     
-    echo ""
-}
-
-# Initialize results CSV with header
-echo "Instance,Total Vehicles,Population Size,Best Cost,Generations,Runtime" > "$RESULTS_DIR/all_results.csv"
-
-# Run for each instance with potentially different parameters
-for instance in "${INSTANCES[@]}"; do
     # You can customize generations and population per instance here
     case $instance in
         "CMT1")
@@ -145,9 +103,24 @@ for instance in "${INSTANCES[@]}"; do
             ;;
     esac
     
-    run_instance "$instance" "$inst_gens" "$inst_pop" "$NUM_RUNS"
+    echo "${instance}.vrp $NUM_RUNS - $inst_gens $inst_pop" >> "$JOBS_FILE"
 done
 
+echo "Running batch ($(wc -l < "$JOBS_FILE") instances, $NUM_RUNS runs each)..."
+start_time=$(date +%s)
+./cvrp_solver --batch "$JOBS_FILE" --batch-output "$RESULTS_DIR/all_results.csv" > "$RESULTS_DIR/batch_output.log" 2>&1
+exit_code=$?
+end_time=$(date +%s)
+runtime=$((end_time - start_time))
+
+if [ $exit_code -eq 0 ]; then
+    echo "  ✓ Completed successfully in ${runtime}s"
+else
+    echo "  ✗ Failed with exit code $exit_code"
+    echo "  Check log: $RESULTS_DIR/batch_output.log"
+fi
+echo ""
+
 # Generate summary report
 echo "=== SUMMARY REPORT ===" | tee "$RESULTS_DIR/summary.txt"
 echo "Total instances tested: ${#INSTANCES[@]}" | tee -a "$RESULTS_DIR/summary.txt"
@@ -162,7 +135,7 @@ if [ -f "$RESULTS_DIR/all_results.csv" ] && [ $(wc -l < "$RESULTS_DIR/all_result
     
     # Calculate average cost (excluding header)
     if command -v awk >/dev/null 2>&1; then
-        avg_cost=$(tail -n +2 "$RESULTS_DIR/all_results.csv" | awk -F',' '{sum+=$4; count++} END {printf "%.2f", sum/count}')
+        avg_cost=$(tail -n +2 "$RESULTS_DIR/all_results.csv" | awk -F',' '{sum+=$8; count++} END {printf "%.2f", sum/count}')
         echo "Average cost: $avg_cost" | tee -a "$RESULTS_DIR/summary.txt"
     fi
 else